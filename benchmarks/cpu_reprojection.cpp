@@ -0,0 +1,241 @@
+/**
+ * Per-frame cost of the CPU timewarp and openwarp of the timewarp_cpu plugin.
+ *
+ * Times both eyes of a frame, rendered and displayed at several per-eye resolutions, on one thread and on every core,
+ * for a small head rotation (timewarp) and a small rotation and translation (openwarp). Before timing, checks that the
+ * vectorized bilinear fetch is within 1 of the scalar one, also for coordinates outside the image and NaN, that both
+ * warps give the same bytes on 1 and 5 threads, and that openwarp without head motion is within 2 per channel of
+ * timewarp without head motion (both are then just the distortion correction).
+ *
+ * Usage: cpu_reprojection_benchmark [repetitions]
+ */
+#include "cpu_reprojection.hpp"
+#include "illixr/global_module_defs.hpp"
+#include "illixr/math_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+using namespace ILLIXR;
+using namespace ILLIXR::data_format;
+
+namespace {
+
+struct scene {
+    HMD::hmd_info_t                hmd_info{};
+    distortion_mesh                mesh;
+    std::array<Eigen::Matrix4f, 2> projection;
+    std::array<cpu_eye_image, 2>   eyes;
+};
+
+scene make_scene(int eye_width, int eye_height) {
+    scene result;
+    HMD::get_default_hmd_info(eye_width * 2, eye_height, display_params::width_meters, display_params::height_meters,
+                              display_params::lens_separation, display_params::meters_per_tan_angle,
+                              display_params::aberration, result.hmd_info);
+    result.mesh = distortion_mesh::build(result.hmd_info, false);
+
+    // Random colours in 16 px blocks, so bilinear filtering has edges to work on, and a few depth layers
+    std::mt19937                       random{1234};
+    std::uniform_int_distribution<int> byte{0, 255};
+    for (int eye = 0; eye < 2; ++eye) {
+        math_util::unreal_projection(&result.projection[eye], index_params::fov_left[eye], index_params::fov_right[eye],
+                                     index_params::fov_up[eye], index_params::fov_down[eye]);
+        cpu_eye_image& image = result.eyes[eye];
+        image                = cpu_eye_image{eye_width, eye_height, true};
+        std::vector<std::uint8_t> blocks(static_cast<std::size_t>(eye_width / 16 + 1) * (eye_height / 16 + 1) * 3);
+        for (auto& value : blocks) {
+            value = static_cast<std::uint8_t>(byte(random));
+        }
+        for (int y = 0; y < eye_height; ++y) {
+            for (int x = 0; x < eye_width; ++x) {
+                const std::size_t block = (static_cast<std::size_t>(y / 16) * (eye_width / 16 + 1) + x / 16) * 3;
+                const std::size_t pixel = static_cast<std::size_t>(y) * eye_width + x;
+                std::copy_n(&blocks[block], 3, &image.rgba[pixel * 4]);
+                image.rgba[pixel * 4 + 3] = 255;
+                // 1 m, 2 m, or 4 m away (reverse z with the near plane at 0.1 m)
+                image.depth[pixel] = 0.1f / static_cast<float>(1 << ((x / 200 + y / 200) % 3));
+            }
+        }
+    }
+    return result;
+}
+
+Eigen::Matrix4f rotation_view(float yaw) {
+    Eigen::Matrix4f view   = Eigen::Matrix4f::Identity();
+    view.block(0, 0, 3, 3) = Eigen::AngleAxisf(yaw, Eigen::Vector3f::UnitY()).toRotationMatrix();
+    return view;
+}
+
+Eigen::Matrix4f camera(float yaw, float x, int eye) {
+    Eigen::Matrix4f camera_matrix   = rotation_view(yaw);
+    camera_matrix.block<3, 1>(0, 3) = Eigen::Vector3f{x + (eye == 0 ? -1.0f : 1.0f) * display_params::ipd / 2.0f, 0, 0};
+    return camera_matrix;
+}
+
+void run_timewarp(cpu_reprojection& reprojection, const scene& frame, float yaw, std::array<cpu_eye_image, 2>& out) {
+    for (int eye = 0; eye < 2; ++eye) {
+        const Eigen::Matrix4f transform =
+            cpu_reprojection::timewarp_transform(frame.projection[eye], rotation_view(0.0f), rotation_view(yaw));
+        reprojection.timewarp(eye, frame.eyes[eye], transform, transform, out[eye]);
+    }
+}
+
+void run_openwarp(cpu_reprojection& reprojection, const scene& frame, float yaw, float x, std::array<cpu_eye_image, 2>& out) {
+    for (int eye = 0; eye < 2; ++eye) {
+        const cpu_reprojection::openwarp_matrices matrices{frame.projection[eye].inverse(), camera(0.0f, 0.0f, eye),
+                                                           frame.projection[eye] * camera(yaw, x, eye).inverse()};
+        reprojection.openwarp(eye, frame.eyes[eye], matrices, cpu_reprojection::distortion_transform(frame.projection[eye]),
+                              true, out[eye]);
+    }
+}
+
+std::array<cpu_eye_image, 2> output_for(const scene& frame) {
+    return {cpu_eye_image{frame.eyes[0].width, frame.eyes[0].height}, cpu_eye_image{frame.eyes[1].width, frame.eyes[1].height}};
+}
+
+double mean_difference(const std::array<cpu_eye_image, 2>& a, const std::array<cpu_eye_image, 2>& b) {
+    double sum   = 0.0;
+    double count = 0.0;
+    for (int eye = 0; eye < 2; ++eye) {
+        for (std::size_t i = 0; i < a[eye].rgba.size(); ++i) {
+            sum += std::abs(static_cast<int>(a[eye].rgba[i]) - static_cast<int>(b[eye].rgba[i]));
+        }
+        count += static_cast<double>(a[eye].rgba.size());
+    }
+    return sum / count;
+}
+
+bool fetch_matches_scalar() {
+    bool ok = true;
+
+    // Coordinates inside, on, and well outside the image, and NaN
+    const scene                           frame = make_scene(333, 257);
+    std::mt19937                          random{42};
+    std::uniform_real_distribution<float> coordinate{-0.1f, 1.1f};
+    std::vector<float>                    u(10007);
+    std::vector<float>                    v(u.size());
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        u[i] = coordinate(random);
+        v[i] = coordinate(random);
+    }
+    u[0] = NAN;
+    v[1] = 1e9f;
+    u[2] = -1e9f;
+    for (int channel = 0; channel < 4; ++channel) {
+        std::vector<std::uint8_t> fast(u.size() * 4);
+        std::vector<std::uint8_t> scalar(u.size() * 4);
+        cpu_reprojection_detail::sample_channel(frame.eyes[0], u.data(), v.data(), channel, fast.data(),
+                                                static_cast<int>(u.size()));
+        cpu_reprojection_detail::sample_channel_scalar(frame.eyes[0], u.data(), v.data(), channel, scalar.data(),
+                                                       static_cast<int>(u.size()));
+        for (std::size_t i = 0; i < fast.size(); i += 4) {
+            if (std::abs(fast[i] - scalar[i]) > 1) {
+                std::printf("sample_channel differs from the scalar fetch at %zu, channel %d\n", i / 4, channel);
+                ok = false;
+                break;
+            }
+        }
+    }
+    return ok;
+}
+
+bool independent_of_thread_count(const scene& large) {
+    bool             ok = true;
+    cpu_reprojection single{large.hmd_info, large.mesh, 1};
+    cpu_reprojection threaded{large.hmd_info, large.mesh, 5};
+    auto             single_out   = output_for(large);
+    auto             threaded_out = output_for(large);
+    run_timewarp(single, large, 0.05f, single_out);
+    run_timewarp(threaded, large, 0.05f, threaded_out);
+    if (single_out[0].rgba != threaded_out[0].rgba || single_out[1].rgba != threaded_out[1].rgba) {
+        std::printf("timewarp depends on the thread count\n");
+        ok = false;
+    }
+    run_openwarp(single, large, 0.05f, 0.02f, single_out);
+    run_openwarp(threaded, large, 0.05f, 0.02f, threaded_out);
+    if (single_out[0].rgba != threaded_out[0].rgba || single_out[1].rgba != threaded_out[1].rgba) {
+        std::printf("openwarp depends on the thread count\n");
+        ok = false;
+    }
+    return ok;
+}
+
+// Without motion both reduce to the distortion correction; openwarp resamples twice, so allow a little blur
+bool openwarp_without_motion_matches_timewarp(const scene& large) {
+    cpu_reprojection reprojection{large.hmd_info, large.mesh, 1};
+    auto             timewarp_out = output_for(large);
+    auto             openwarp_out = output_for(large);
+    run_timewarp(reprojection, large, 0.0f, timewarp_out);
+    run_openwarp(reprojection, large, 0.0f, 0.0f, openwarp_out);
+    const double difference = mean_difference(timewarp_out, openwarp_out);
+    if (difference > 2.0) {
+        std::printf("openwarp without motion differs from timewarp without motion by %.2f per channel\n", difference);
+        return false;
+    }
+    return true;
+}
+
+template<typename Function>
+double time_ms(int repetitions, Function&& function) {
+    function(); // the first run allocates the scratch buffers
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        function();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+void benchmark(int eye_width, int eye_height, int repetitions) {
+    const scene      frame = make_scene(eye_width, eye_height);
+    const unsigned   cores = std::max(std::thread::hardware_concurrency(), 1u);
+    cpu_reprojection single{frame.hmd_info, frame.mesh, 1};
+    cpu_reprojection threaded{frame.hmd_info, frame.mesh, cores};
+    auto             out = output_for(frame);
+
+    const double timewarp_single   = time_ms(repetitions, [&] {
+        run_timewarp(single, frame, 0.02f, out);
+    });
+    const double timewarp_threaded = time_ms(repetitions, [&] {
+        run_timewarp(threaded, frame, 0.02f, out);
+    });
+    const double openwarp_single   = time_ms(repetitions, [&] {
+        run_openwarp(single, frame, 0.02f, 0.01f, out);
+    });
+    const double openwarp_threaded = time_ms(repetitions, [&] {
+        run_openwarp(threaded, frame, 0.02f, 0.01f, out);
+    });
+
+    std::printf("%4dx%-4d  %10.2f %10.2f  %10.2f %10.2f\n", eye_width, eye_height, timewarp_single, timewarp_threaded,
+                openwarp_single, openwarp_threaded);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 10;
+
+    const scene large = make_scene(640, 720);
+    if (!fetch_matches_scalar() || !independent_of_thread_count(large) || !openwarp_without_motion_matches_timewarp(large)) {
+        return 1;
+    }
+#if defined(__AVX2__)
+    std::printf("AVX2 fetch matches the scalar fetch; results do not depend on the thread count\n\n");
+#else
+    std::printf("scalar fetch (build with AVX2 for the vectorized one); results do not depend on the thread count\n\n");
+#endif
+
+    const std::string threads = std::to_string(std::max(std::thread::hardware_concurrency(), 1u)) + " threads";
+    std::printf("per eye    %10s %10s  %10s %10s   (ms per stereo frame)\n", "timewarp", "", "openwarp", "");
+    std::printf("           %10s %10s  %10s %10s\n", "1 thread", threads.c_str(), "1 thread", threads.c_str());
+    benchmark(1440, 1600, repetitions); // the default display
+    benchmark(1832, 1920, repetitions);
+    benchmark(2160, 2160, repetitions);
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * Startup cost of loading the offline datasets.
+ *
+ * Writes synthetic EuRoC-style CSV files (an IMU stream and ground truth poses, like offline_imu, ground_truth_slam, and
+ * pose_lookup read) to a temporary directory, then loads them one after another into maps, as the plugins used to in
+ * their constructors, and all at once through dataset_loader, and fails if the two load a different number of rows.
+ * Then loads the IMU files again under a budget of a tenth of their size, reading each stream in order on its own
+ * thread and releasing the rows behind it, and fails unless wait_ready() returns before the streams are complete, every
+ * row arrives once and in order, and the loader's peak stays within the budget plus one batch per stream.
+ *
+ * Usage: dataset_loader_benchmark [rows per file]
+ */
+#include "illixr/data_loading.hpp"
+#include "illixr/dataset_loader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+struct imu_row {
+    double values[6];
+};
+
+struct pose_row {
+    float values[7];
+};
+
+std::pair<ullong, imu_row> parse_imu(const data_row& row, const std::string&) {
+    imu_row result{};
+    for (int i = 0; i < 6; ++i) {
+        result.values[i] = std::stod(row[i + 1]);
+    }
+    return {std::stoull(row[0]), result};
+}
+
+std::pair<ullong, pose_row> parse_pose(const data_row& row, const std::string&) {
+    pose_row result{};
+    for (int i = 0; i < 7; ++i) {
+        result.values[i] = std::stof(row[i + 1]);
+    }
+    return {std::stoull(row[0]), result};
+}
+
+void write_csv(const std::filesystem::path& path, std::size_t rows, int columns, unsigned seed) {
+    std::mt19937                           random{seed};
+    std::uniform_real_distribution<double> value{-10.0, 10.0};
+    std::ofstream                          file{path};
+    file << "#timestamp";
+    for (int c = 0; c < columns; ++c) {
+        file << ",v" << c;
+    }
+    file << '\n';
+    for (std::size_t r = 0; r < rows; ++r) {
+        file << 1403715273262142976ULL + r * 5000000ULL;
+        for (int c = 0; c < columns; ++c) {
+            file << ',' << value(random);
+        }
+        file << '\n';
+    }
+}
+
+/// As load_data() with the plugins' read_data()
+template<typename T>
+std::map<ullong, T> load_serially(const std::string& path, std::pair<ullong, T> (*parse)(const data_row&, const std::string&)) {
+    std::map<ullong, T> data;
+    std::ifstream       file{path};
+    for (csv_iterator row{file, 1}; row != csv_iterator{}; ++row) {
+        data.insert(parse(*row, path));
+    }
+    return data;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count();
+}
+
+struct files {
+    std::vector<std::string> imu;
+    std::vector<std::string> poses;
+};
+
+/// Reads @p stream in order, releasing each row once read; returns whether the timestamps strictly increase
+template<typename T>
+bool consume(dataset_stream<T>& stream, std::size_t expected_rows) {
+    ullong      last = 0;
+    std::size_t i    = 0;
+    for (const auto* row = stream.at(0); row != nullptr; row = stream.at(i)) {
+        if (row->first <= last) {
+            return false;
+        }
+        last = row->first;
+        stream.release_before(++i);
+    }
+    return i == expected_rows;
+}
+
+bool streams_within_budget(const files& paths, std::size_t rows) {
+    // A tenth of what the IMU streams take up when fully loaded
+    const std::size_t budget = paths.imu.size() * rows * sizeof(dataset_stream<imu_row>::row) / 10;
+    const std::size_t slack  = paths.imu.size() * dataset_stream<imu_row>::batch_rows * sizeof(dataset_stream<imu_row>::row);
+    auto              loader = std::make_shared<dataset_loader>(budget);
+
+    std::vector<std::shared_ptr<dataset_stream<imu_row>>> streams;
+    for (std::size_t i = 0; i < paths.imu.size(); ++i) {
+        streams.push_back(loader->open<imu_row>("imu" + std::to_string(i),
+                                                csv_dataset_source<imu_row>(paths.imu[i], 1, &parse_imu)));
+    }
+    loader->wait_ready();
+    bool ok = true;
+    if (std::all_of(streams.cbegin(), streams.cend(), [](const auto& stream) {
+            return stream->complete();
+        })) {
+        std::printf("every stream loaded completely despite the memory budget\n");
+        ok = false;
+    }
+
+    std::atomic<bool>   done{false};
+    std::atomic<size_t> peak{0};
+    std::thread         monitor{[&] {
+        while (!done) {
+            peak = std::max(peak.load(), loader->bytes_held());
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+        }
+    }};
+    std::vector<std::thread> readers;
+    std::atomic<bool>        in_order{true};
+    for (const auto& stream : streams) {
+        readers.emplace_back([&, stream] {
+            if (!consume(*stream, rows)) {
+                in_order = false;
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    done = true;
+    monitor.join();
+
+    if (!in_order) {
+        std::printf("streamed rows missing or out of order\n");
+        ok = false;
+    }
+    if (peak > budget + slack) {
+        std::printf("held %zu bytes, over the budget of %zu plus %zu\n", peak.load(), budget, slack);
+        ok = false;
+    }
+    std::printf("budget %.1f MiB: ready before complete, peak %.1f MiB, %zu rows per stream in order\n",
+                static_cast<double>(budget) / (1 << 20), static_cast<double>(peak) / (1 << 20), rows);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 400000;
+    spdlog::stdout_color_mt("illixr")->set_level(spdlog::level::warn);
+
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("illixr_dataset_loader_" + std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(directory);
+    files paths;
+    for (unsigned i = 0; i < 2; ++i) {
+        paths.imu.push_back((directory / ("imu" + std::to_string(i) + ".csv")).string());
+        write_csv(paths.imu.back(), rows, 6, i);
+        paths.poses.push_back((directory / ("pose" + std::to_string(i) + ".csv")).string());
+        write_csv(paths.poses.back(), rows, 7, 10 + i);
+    }
+    std::printf("%zu files of %zu rows\n", paths.imu.size() + paths.poses.size(), rows);
+
+    auto        start = std::chrono::steady_clock::now();
+    std::size_t total = 0;
+    for (const auto& path : paths.imu) {
+        total += load_serially<imu_row>(path, &parse_imu).size();
+    }
+    for (const auto& path : paths.poses) {
+        total += load_serially<pose_row>(path, &parse_pose).size();
+    }
+    const double serial = seconds_since(start);
+
+    start       = std::chrono::steady_clock::now();
+    auto loader = std::make_shared<dataset_loader>();
+
+    std::vector<std::shared_ptr<dataset_stream<imu_row>>>  imu;
+    std::vector<std::shared_ptr<dataset_stream<pose_row>>> poses;
+    for (std::size_t i = 0; i < paths.imu.size(); ++i) {
+        imu.push_back(
+            loader->open<imu_row>("imu" + std::to_string(i), csv_dataset_source<imu_row>(paths.imu[i], 1, &parse_imu)));
+        poses.push_back(loader->open<pose_row>("pose" + std::to_string(i),
+                                               csv_dataset_source<pose_row>(paths.poses[i], 1, &parse_pose), nullptr, true));
+    }
+    loader->wait_ready();
+    const double concurrent = seconds_since(start);
+
+    bool        ok     = true;
+    std::size_t loaded = 0;
+    for (std::size_t i = 0; i < imu.size(); ++i) {
+        loaded += imu[i]->rows_loaded() + poses[i]->all().size();
+    }
+    if (loaded != total) {
+        std::printf("dataset_loader loaded %zu rows, the serial load %zu\n", loaded, total);
+        ok = false;
+    }
+    std::printf("serial load into maps   %8.3f s\n", serial);
+    std::printf("dataset_loader          %8.3f s (%.1fx)\n", concurrent, serial / concurrent);
+    imu.clear();
+    poses.clear();
+
+    ok = streams_within_budget(paths, rows) && ok;
+    std::filesystem::remove_all(directory);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/**
+ * Split/merge of 16-bit depth into the two 8-bit planes ADA sends through the video encoder.
+ *
+ * Times split and merge at 640x480 and 1280x720 for the scalar loop, the vectorized kernels in depth_planes.hpp, and
+ * the OpenCV operations server_rx used before (convertTo, convertTo, bitwise_or). The kernels must first be bit-exact
+ * against the scalar loop for every 16-bit value, for lengths around the vector width, and for images whose rows are
+ * not contiguous.
+ *
+ * Usage: depth_planes_benchmark [repetitions]
+ */
+#include "depth_planes.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core.hpp>
+#include <random>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+bool check_pointer_kernels(const std::vector<std::uint16_t>& src) {
+    const std::size_t          n = src.size();
+    std::vector<std::uint8_t>  msb(n), lsb(n), msb_ref(n), lsb_ref(n);
+    std::vector<std::uint16_t> merged(n), merged_ref(n);
+
+    split_depth16(src.data(), msb.data(), lsb.data(), n);
+    depth_planes_detail::split_scalar(src.data(), msb_ref.data(), lsb_ref.data(), n);
+    merge_depth16(msb.data(), lsb.data(), merged.data(), n);
+    depth_planes_detail::merge_scalar(msb_ref.data(), lsb_ref.data(), merged_ref.data(), n);
+    return msb == msb_ref && lsb == lsb_ref && merged == merged_ref && merged == src;
+}
+
+bool check_mat_kernels(const cv::Mat& depth16) {
+    cv::Mat msb, lsb, merged;
+    split_depth16(depth16, msb, lsb);
+    merge_depth16(msb, lsb, merged);
+    for (int y = 0; y < depth16.rows; ++y) {
+        for (int x = 0; x < depth16.cols; ++x) {
+            const std::uint16_t v = depth16.at<std::uint16_t>(y, x);
+            if (msb.at<std::uint8_t>(y, x) != (v >> 8) || lsb.at<std::uint8_t>(y, x) != (v & 0xFF) ||
+                merged.at<std::uint16_t>(y, x) != v) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool bit_exact_against_scalar() {
+    std::mt19937                                 rng{7};
+    std::uniform_int_distribution<std::uint16_t> value;
+
+    // every value, at an offset so the vector loop and the scalar tail both see them
+    std::vector<std::uint16_t> all(65536 + 13);
+    for (std::size_t i = 0; i < all.size(); ++i) {
+        all[i] = static_cast<std::uint16_t>(i);
+    }
+    bool ok = check_pointer_kernels(all);
+
+    for (std::size_t n : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 641, 1279}) {
+        std::vector<std::uint16_t> src(n);
+        for (auto& v : src) {
+            v = value(rng);
+        }
+        ok = ok && check_pointer_kernels(src);
+    }
+
+    for (const cv::Size size : {cv::Size{640, 480}, cv::Size{1280, 720}, cv::Size{37, 5}}) {
+        cv::Mat depth16(size, CV_16U);
+        cv::randu(depth16, 0, 65536);
+        ok = ok && check_mat_kernels(depth16);
+        // a region of interest: rows are not contiguous
+        ok = ok && check_mat_kernels(depth16(cv::Rect{3, 1, size.width - 5, size.height - 2}));
+    }
+    return ok;
+}
+
+template<typename Function>
+double time_us(int repetitions, Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        function();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+void benchmark(cv::Size size, int repetitions) {
+    cv::Mat depth16(size, CV_16U);
+    cv::randu(depth16, 0, 65536);
+    const std::size_t n = depth16.total();
+
+    cv::Mat msb(size, CV_8UC1), lsb(size, CV_8UC1), merged(size, CV_16U), hi16, lo16;
+    auto*   src = depth16.ptr<std::uint16_t>();
+    auto*   hi  = msb.ptr<std::uint8_t>();
+    auto*   lo  = lsb.ptr<std::uint8_t>();
+    auto*   dst = merged.ptr<std::uint16_t>();
+
+    const double split_scalar = time_us(repetitions, [&] {
+        depth_planes_detail::split_scalar(src, hi, lo, n);
+    });
+    const double split_simd   = time_us(repetitions, [&] {
+        split_depth16(src, hi, lo, n);
+    });
+    const double merge_scalar = time_us(repetitions, [&] {
+        depth_planes_detail::merge_scalar(hi, lo, dst, n);
+    });
+    const double merge_simd   = time_us(repetitions, [&] {
+        merge_depth16(hi, lo, dst, n);
+    });
+    const double merge_opencv = time_us(repetitions, [&] {
+        msb.convertTo(hi16, CV_16U, 256.0);
+        lsb.convertTo(lo16, CV_16U);
+        cv::bitwise_or(hi16, lo16, merged);
+    });
+
+    std::printf("%4dx%-4d  split %8.1f %8.1f   merge %8.1f %8.1f %8.1f\n", size.width, size.height, split_scalar,
+                split_simd, merge_scalar, merge_simd, merge_opencv);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    if (!bit_exact_against_scalar()) {
+        std::printf("the vectorized kernels differ from the scalar reference\n");
+        return 1;
+    }
+    std::printf("bit-exact against the scalar reference\n\n");
+
+    std::printf("mean us per frame   %8s %8s         %8s %8s %8s\n", "scalar", "simd", "scalar", "simd", "opencv");
+    benchmark({640, 480}, repetitions);
+    benchmark({1280, 720}, repetitions);
+    return 0;
+}
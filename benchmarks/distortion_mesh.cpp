@@ -0,0 +1,231 @@
+/**
+ * Lens distortion mesh generation, as done by timewarp_gl, timewarp_vk, and openwarp_vk at startup.
+ *
+ * Times the scalar path the plugins used to take (index grid, HMD::build_distortion_meshes, position and UV copy), the
+ * row-vectorized build on one thread and on every core, and a load from a warm cache. The timings are only printed once
+ * distortion_mesh::build matches HMD::build_distortion_meshes to 1e-6 for several display sizes, with and without
+ * ILLIXR_COMPARE_IMAGES, gives the same bytes on one and on seven threads, and once the on-disk cache returns the mesh
+ * it stored and rejects a file written for a different display or mode.
+ *
+ * Usage: distortion_mesh_benchmark [repetitions]
+ */
+#include "illixr/distortion_mesh.hpp"
+#include "illixr/global_module_defs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+using namespace ILLIXR;
+
+namespace {
+
+using distort_coords_t = std::array<std::array<std::vector<HMD::mesh_coord2d_t>, HMD::NUM_COLOR_CHANNELS>, HMD::NUM_EYES>;
+
+HMD::hmd_info_t hmd_info_for(int width, int height, int tile_pixels = 32) {
+    HMD::hmd_info_t hmd_info{};
+    HMD::get_default_hmd_info(width, height, display_params::width_meters, display_params::height_meters,
+                              display_params::lens_separation, display_params::meters_per_tan_angle,
+                              display_params::aberration, hmd_info);
+    // get_default_hmd_info always uses 32 px tiles; smaller tiles give a denser mesh over the same display
+    hmd_info.tile_pixels_wide = tile_pixels;
+    hmd_info.tile_pixels_high = tile_pixels;
+    hmd_info.eye_tiles_wide   = width / tile_pixels / HMD::NUM_EYES;
+    hmd_info.eye_tiles_high   = height / tile_pixels;
+    return hmd_info;
+}
+
+distort_coords_t reference(HMD::hmd_info_t hmd_info) {
+    distort_coords_t coords;
+    for (auto& eye_coords : coords) {
+        for (auto& channel_coords : eye_coords) {
+            channel_coords.resize((hmd_info.eye_tiles_high + 1) * (hmd_info.eye_tiles_wide + 1));
+        }
+    }
+    HMD::build_distortion_meshes(coords, hmd_info);
+    return coords;
+}
+
+// What each warp plugin did before distortion_mesh: the index grid, the scalar coefficients, then positions and UVs
+void reference_build(const HMD::hmd_info_t& hmd_info, distortion_mesh& mesh) {
+    const int width       = hmd_info.eye_tiles_wide + 1;
+    mesh.vertices_per_eye = width * (hmd_info.eye_tiles_high + 1);
+    mesh.indices.resize(static_cast<std::size_t>(hmd_info.eye_tiles_high) * hmd_info.eye_tiles_wide * 6);
+    for (int y = 0; y < hmd_info.eye_tiles_high; y++) {
+        for (int x = 0; x < hmd_info.eye_tiles_wide; x++) {
+            const std::size_t offset = (static_cast<std::size_t>(y) * hmd_info.eye_tiles_wide + x) * 6;
+
+            mesh.indices[offset + 0] = (y + 0) * width + (x + 0);
+            mesh.indices[offset + 1] = (y + 1) * width + (x + 0);
+            mesh.indices[offset + 2] = (y + 0) * width + (x + 1);
+            mesh.indices[offset + 3] = (y + 0) * width + (x + 1);
+            mesh.indices[offset + 4] = (y + 1) * width + (x + 0);
+            mesh.indices[offset + 5] = (y + 1) * width + (x + 1);
+        }
+    }
+
+    const distort_coords_t coords = reference(hmd_info);
+    mesh.positions.resize(static_cast<std::size_t>(HMD::NUM_EYES) * mesh.vertices_per_eye);
+    for (auto& channel : mesh.uv) {
+        channel.resize(mesh.positions.size());
+    }
+    for (int eye = 0; eye < HMD::NUM_EYES; eye++) {
+        for (int y = 0; y <= hmd_info.eye_tiles_high; y++) {
+            for (int x = 0; x < width; x++) {
+                const int index  = y * width + x;
+                const int vertex = eye * mesh.vertices_per_eye + index;
+
+                mesh.positions[vertex].x = -1.0f + 2 * (static_cast<float>(x) / static_cast<float>(hmd_info.eye_tiles_wide));
+                mesh.positions[vertex].y = -1.0f +
+                    2.0f * (static_cast<float>(hmd_info.eye_tiles_high - y) / static_cast<float>(hmd_info.eye_tiles_high)) *
+                        (static_cast<float>(hmd_info.eye_tiles_high * hmd_info.tile_pixels_high) /
+                         static_cast<float>(hmd_info.display_pixels_high));
+                mesh.positions[vertex].z = 0.0f;
+                for (int channel = 0; channel < HMD::NUM_COLOR_CHANNELS; channel++) {
+                    mesh.uv[channel][vertex].u = coords[eye][channel][index].x;
+                    mesh.uv[channel][vertex].v = coords[eye][channel][index].y;
+                }
+            }
+        }
+    }
+}
+
+// The largest difference from the scalar reference; 0 unless the compiler contracted some of the math into FMAs
+double max_difference(const distortion_mesh& mesh, const distort_coords_t& coords) {
+    double difference = 0.0;
+    for (int eye = 0; eye < HMD::NUM_EYES; ++eye) {
+        for (int channel = 0; channel < HMD::NUM_COLOR_CHANNELS; ++channel) {
+            for (int i = 0; i < mesh.vertices_per_eye; ++i) {
+                const HMD::uv_coord_t& uv = mesh.uv[channel][eye * mesh.vertices_per_eye + i];
+                difference = std::max({difference, std::fabs(static_cast<double>(uv.u) - coords[eye][channel][i].x),
+                                       std::fabs(static_cast<double>(uv.v) - coords[eye][channel][i].y)});
+            }
+        }
+    }
+    return difference;
+}
+
+double max_position_difference(const distortion_mesh& a, const distortion_mesh& b) {
+    double difference = 0.0;
+    for (std::size_t i = 0; i < a.positions.size(); ++i) {
+        difference = std::max({difference, std::fabs(static_cast<double>(a.positions[i].x) - b.positions[i].x),
+                               std::fabs(static_cast<double>(a.positions[i].y) - b.positions[i].y),
+                               std::fabs(static_cast<double>(a.positions[i].z) - b.positions[i].z)});
+    }
+    return a.positions.size() == b.positions.size() ? difference : HUGE_VAL;
+}
+
+bool same_mesh(const distortion_mesh& a, const distortion_mesh& b) {
+    auto same_bytes = [](const auto& x, const auto& y) {
+        return x.size() == y.size() && std::memcmp(x.data(), y.data(), x.size() * sizeof(x[0])) == 0;
+    };
+    return a.vertices_per_eye == b.vertices_per_eye && a.indices == b.indices && same_bytes(a.positions, b.positions) &&
+        same_bytes(a.uv[0], b.uv[0]) && same_bytes(a.uv[1], b.uv[1]) && same_bytes(a.uv[2], b.uv[2]);
+}
+
+bool matches_scalar_reference() {
+    bool ok = true;
+    for (const bool compare_images : {false, true}) {
+        setenv("ILLIXR_COMPARE_IMAGES", compare_images ? "1" : "0", 1);
+        for (const auto& [width, height] : {std::pair{2880, 1600}, std::pair{1920, 1080}, std::pair{4320, 2160},
+                                            std::pair{640, 480}, std::pair{200, 64}}) {
+            const HMD::hmd_info_t hmd_info   = hmd_info_for(width, height, width < 1000 ? 8 : 32);
+            const distortion_mesh single     = distortion_mesh::build(hmd_info, compare_images, 1);
+            const distortion_mesh threaded   = distortion_mesh::build(hmd_info, compare_images, 7);
+            const double          difference = max_difference(single, reference(hmd_info));
+            distortion_mesh       expected;
+            reference_build(hmd_info, expected);
+            if (difference > 1e-6 || !same_mesh(single, threaded) || expected.indices != single.indices ||
+                max_position_difference(expected, single) > 1e-6) {
+                std::printf("%dx%d compare_images=%d: differs from the reference by %g\n", width, height, compare_images,
+                            difference);
+                ok = false;
+            }
+        }
+    }
+    setenv("ILLIXR_COMPARE_IMAGES", "0", 1);
+    return ok;
+}
+
+// A cache miss writes the file, a hit returns the same mesh, and a different display or mode does not match it
+bool cache_round_trips(const std::filesystem::path& cache_dir) {
+    const HMD::hmd_info_t hmd_info = hmd_info_for(2880, 1600);
+    const distortion_mesh built    = distortion_mesh::load(hmd_info, cache_dir.string());
+    const distortion_mesh cached   = distortion_mesh::load(hmd_info, cache_dir.string());
+    HMD::hmd_info_t       other    = hmd_info;
+    other.K[3] += 0.001f;
+    distortion_mesh   unused;
+    const std::string path = (cache_dir / distortion_mesh::cache_file_name(hmd_info, false)).string();
+    if (!same_mesh(built, cached) || !std::filesystem::exists(path) || unused.read(path, other, false) ||
+        unused.read(path, hmd_info, true) ||
+        distortion_mesh::cache_file_name(hmd_info, false) == distortion_mesh::cache_file_name(other, false)) {
+        std::printf("the on-disk cache did not round-trip\n");
+        return false;
+    }
+    return true;
+}
+
+template<typename Function>
+double mean_us_per_build(int repetitions, Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        function();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+void benchmark(int width, int height, int tile_pixels, int repetitions, const std::filesystem::path& cache_dir) {
+    const HMD::hmd_info_t hmd_info = hmd_info_for(width, height, tile_pixels);
+    const unsigned        cores    = std::max(std::thread::hardware_concurrency(), 1u);
+    distortion_mesh::load(hmd_info, cache_dir.string()); // warm the cache
+
+    distortion_mesh mesh;
+    const double    scalar   = mean_us_per_build(repetitions, [&] {
+        reference_build(hmd_info, mesh);
+    });
+    const double    single   = mean_us_per_build(repetitions, [&] {
+        distortion_mesh::build(hmd_info, false, 1);
+    });
+    const double    threaded = mean_us_per_build(repetitions, [&] {
+        distortion_mesh::build(hmd_info, false, cores);
+    });
+    const double    cached   = mean_us_per_build(repetitions, [&] {
+        distortion_mesh::load(hmd_info, cache_dir.string());
+    });
+
+    std::printf("%4dx%-4d %4d %9d  %10.1f %10.1f %10.1f %10.1f\n", width, height, tile_pixels,
+                HMD::NUM_EYES * (hmd_info.eye_tiles_wide + 1) * (hmd_info.eye_tiles_high + 1), scalar, single, threaded,
+                cached);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 100;
+
+    const std::filesystem::path cache_dir =
+        std::filesystem::temp_directory_path() / ("illixr_distortion_mesh_benchmark_" + std::to_string(getpid()));
+    std::filesystem::remove_all(cache_dir);
+
+    const bool ok = matches_scalar_reference() && cache_round_trips(cache_dir);
+    if (ok) {
+        std::printf("matches the scalar reference; the cache round-trips\n\n");
+        std::printf("display   tile  vertices  %10s %10s %10s %10s   (mean us)\n", "scalar", "1 thread",
+                    (std::to_string(std::max(std::thread::hardware_concurrency(), 1u)) + " threads").c_str(), "cached");
+        benchmark(2880, 1600, 32, repetitions, cache_dir);
+        benchmark(4320, 2160, 32, repetitions, cache_dir);
+        // much denser meshes than the default, where the threads start to pay off
+        benchmark(2880, 1600, 4, repetitions, cache_dir);
+        benchmark(7680, 4320, 4, repetitions, cache_dir);
+    }
+
+    std::filesystem::remove_all(cache_dir);
+    return ok ? 0 : 1;
+}
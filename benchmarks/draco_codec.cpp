@@ -0,0 +1,166 @@
+/**
+ * Draco encode/decode throughput of the ADA mesh codec workers, at 1..N workers.
+ *
+ * Loads a recorded set of mesh chunks (the .ply files written by the ADA server, or any triangle meshes), then for each
+ * worker count pushes every chunk through a mesh_worker_pool the way mesh_compression and mesh_decompression_grey do:
+ * once with codec objects kept per worker, as the plugins now do, and once with fresh codec objects per chunk, as they
+ * did before. Each chunk is queued once per repetition, and is decoded from its encoding with mesh_compression's
+ * settings. Reports chunks per second for encoding and decoding.
+ *
+ * Usage: draco_codec_benchmark <directory of .ply chunks> [max workers] [repetitions]
+ */
+#include "mesh_worker_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <draco_illixr/compression/decode.h>
+#include <draco_illixr/compression/encode.h>
+#include <draco_illixr/io/mesh_io.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+// the settings mesh_compression uses
+void configure(draco_illixr::Encoder& encoder) {
+    const float origin[] = {0.0f, 0.0f, 0.0f};
+    encoder.SetAttributeExplicitQuantization(draco_illixr::GeometryAttribute::POSITION, 14, 3, origin, 2000.0f);
+    encoder.SetAttributeQuantization(draco_illixr::GeometryAttribute::TEX_COORD, 10);
+    encoder.SetAttributeQuantization(draco_illixr::GeometryAttribute::NORMAL, 8);
+    encoder.SetAttributeQuantization(draco_illixr::GeometryAttribute::GENERIC, 8);
+    encoder.SetSpeedOptions(3, 3);
+}
+
+struct encode_job {
+    const draco_illixr::Mesh* mesh;
+};
+
+struct decode_job {
+    const draco_illixr::EncoderBuffer* in;
+};
+
+struct codec_context {
+    draco_illixr::Encoder       encoder;
+    draco_illixr::Decoder       decoder;
+    draco_illixr::EncoderBuffer encoded;
+};
+
+std::vector<std::unique_ptr<draco_illixr::Mesh>> load_chunks(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".ply") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<std::unique_ptr<draco_illixr::Mesh>> chunks;
+    for (const auto& path : paths) {
+        auto mesh = draco_illixr::ReadMeshFromFile(path.string());
+        if (!mesh.ok()) {
+            std::fprintf(stderr, "skipping %s: %s\n", path.c_str(), mesh.status().error_msg());
+            continue;
+        }
+        chunks.push_back(std::move(mesh).value());
+    }
+    return chunks;
+}
+
+template<typename Job>
+double run(std::size_t workers, bool reuse, std::vector<Job>& jobs, int repetitions,
+           void (*process)(codec_context&, const Job&)) {
+    auto start = std::chrono::steady_clock::now();
+    {
+        mesh_worker_pool<Job*, codec_context> pool{
+            workers, 8,
+            [](unsigned) {
+                auto context = std::make_unique<codec_context>();
+                configure(context->encoder);
+                return context;
+            },
+            [reuse, process](codec_context& context, Job* const& job) {
+                if (reuse) {
+                    process(context, *job);
+                } else {
+                    codec_context fresh;
+                    configure(fresh.encoder);
+                    process(fresh, *job);
+                }
+            }};
+        for (int r = 0; r < repetitions; ++r) {
+            for (auto& job : jobs) {
+                pool.submit(&job);
+            }
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(jobs.size() * repetitions) / elapsed.count();
+}
+
+void encode(codec_context& context, const encode_job& job) {
+    draco_illixr::ExpertEncoder expert_encoder{*job.mesh};
+    expert_encoder.Reset(context.encoder.CreateExpertEncoderOptions(*job.mesh));
+    context.encoded.Clear();
+    expert_encoder.EncodeToBuffer(&context.encoded);
+}
+
+void decode(codec_context& context, const decode_job& job) {
+    draco_illixr::DecoderBuffer buffer;
+    buffer.Init(job.in->data(), job.in->size());
+    auto mesh = context.decoder.DecodeMeshFromBuffer(&buffer);
+    if (!mesh.ok()) {
+        std::fprintf(stderr, "decode failed: %s\n", mesh.status().error_msg());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <directory of .ply chunks> [max workers] [repetitions]\n", argv[0]);
+        return 1;
+    }
+    const auto chunks      = load_chunks(argv[1]);
+    const auto max_workers = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2]))
+                                      : static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+    const int  repetitions = argc > 3 ? std::atoi(argv[3]) : 5;
+    if (chunks.empty()) {
+        std::fprintf(stderr, "no chunks found in %s\n", argv[1]);
+        return 1;
+    }
+
+    // the decoders' input, encoded once up front
+    std::vector<draco_illixr::EncoderBuffer> encoded(chunks.size());
+    std::vector<encode_job>                  encode_jobs;
+    std::vector<decode_job>                  decode_jobs;
+    std::size_t                              faces = 0;
+    codec_context                            setup;
+    configure(setup.encoder);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        encode(setup, {chunks[i].get()});
+        encoded[i].Encode(setup.encoded.data(), setup.encoded.size());
+        encode_jobs.push_back({chunks[i].get()});
+        decode_jobs.push_back({&encoded[i]});
+        faces += chunks[i]->num_faces();
+    }
+    std::printf("%zu chunks, %zu faces, %d repetitions\n\n", chunks.size(), faces, repetitions);
+
+    std::printf("%-8s %16s %16s %16s %16s\n", "workers", "encode reused/s", "encode fresh/s", "decode reused/s",
+                "decode fresh/s");
+    for (std::size_t workers = 1; workers <= max_workers; ++workers) {
+        const double encode_reused = run<encode_job>(workers, true, encode_jobs, repetitions, encode);
+        const double encode_fresh  = run<encode_job>(workers, false, encode_jobs, repetitions, encode);
+        const double decode_reused = run<decode_job>(workers, true, decode_jobs, repetitions, decode);
+        const double decode_fresh  = run<decode_job>(workers, false, decode_jobs, repetitions, decode);
+        std::printf("%-8zu %16.1f %16.1f %16.1f %16.1f\n", workers, encode_reused, encode_fresh, decode_reused,
+                    decode_fresh);
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+/**
+ * Frame pacing of timewarp_gl, without a display.
+ *
+ * Without arguments, simulates a display whose period is slightly off the nominal one, with jittery swap completions,
+ * scheduler wakeup latency, and a warp whose cost has a long tail, and runs it closed-loop under the old policy and under
+ * frame_pacer. The old policy is timewarp_gl's before frame_pacer: right after the swap returns, sleep 90% of the time to
+ * that swap plus the nominal period, so the warp has what is left of the last 10%. The warp costs about 300 us, which
+ * fits in that budget most of the time, as it has to for the old policy to have worked at all. Reports the fraction of
+ * the refreshes in the run that showed no new frame, and how old the pose is when its frame reaches the display. Fails
+ * if frame_pacer drops more than twice its target miss rate, or predicts the next vsync worse than the old estimate.
+ *
+ * With a trace, replays recorded swap times (one per line, in nanoseconds, in the given comma-separated column; the
+ * "vsync" column of timewarp_gl's mtp_record is column 1) and reports how well each estimate predicts the next swap.
+ *
+ * Usage: frame_pacer_benchmark [trace [column]]
+ */
+#include "illixr/frame_pacer.hpp"
+#include "illixr/global_module_defs.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+constexpr double target_miss_rate = 0.01;
+
+struct simulation_result {
+    std::vector<time_point> swaps;
+    std::size_t             dropped   = 0;
+    std::size_t             refreshes = 0; //!< From the first vsync to the last one shown
+    std::vector<double>     pose_age_ms;
+};
+
+/// The display and the machine, both in nanoseconds
+class simulated_system {
+public:
+    explicit simulated_system(unsigned seed)
+        : random_{seed} { }
+
+    [[nodiscard]] time_point vsync_at_or_after(time_point time) const {
+        const double index = std::ceil(static_cast<double>((time - first_vsync_).count()) / true_period_ns_);
+        return first_vsync_ + duration{static_cast<duration::rep>(index * true_period_ns_)};
+    }
+
+    [[nodiscard]] long long vsync_index(time_point vsync) const {
+        return std::llround(static_cast<double>((vsync - first_vsync_).count()) / true_period_ns_);
+    }
+
+    /// The swap call returns a little after the vsync, and occasionally much later
+    duration swap_latency() {
+        return microseconds(80.0 + exponential(30.0) + (chance(0.02) ? uniform(500.0, 3000.0) : 0.0));
+    }
+
+    /// The sleep ends a little after the deadline, and occasionally much later
+    duration wakeup_lateness() {
+        return microseconds(50.0 + exponential(100.0) + (chance(0.01) ? uniform(1000.0, 2000.0) : 0.0));
+    }
+
+    /// CPU and GPU time of one warp, up to the swap
+    duration warp_cost() {
+        return microseconds(std::exp(std::normal_distribution<double>{std::log(300.0), 0.3}(random_)) +
+                            (chance(0.01) ? uniform(1000.0, 3000.0) : 0.0));
+    }
+
+    [[nodiscard]] time_point start() const {
+        return first_vsync_;
+    }
+
+private:
+    static duration microseconds(double value) {
+        return duration{static_cast<duration::rep>(value * 1000.0)};
+    }
+
+    double exponential(double mean) {
+        return std::exponential_distribution<double>{1.0 / mean}(random_);
+    }
+
+    double uniform(double low, double high) {
+        return std::uniform_real_distribution<double>{low, high}(random_);
+    }
+
+    bool chance(double probability) {
+        return std::bernoulli_distribution{probability}(random_);
+    }
+
+    std::mt19937     random_;
+    const double     true_period_ns_ = static_cast<double>(display_params::period.count()) * 1.002;
+    const time_point first_vsync_{std::chrono::seconds{10}};
+};
+
+/**
+ * Runs @p frames frames; @p plan gets the time the previous swap returned and gives the wakeup deadline, @p done gets
+ * the time the work finished, and @p swapped the time the swap returned.
+ */
+template<typename Plan, typename Done, typename Swapped>
+simulation_result simulate(simulated_system& system, int frames, Plan&& plan, Done&& done, Swapped&& swapped) {
+    simulation_result result;
+    time_point        now         = system.start();
+    const long long   first_shown = system.vsync_index(system.vsync_at_or_after(now));
+    long long         last_shown  = first_shown;
+    for (int frame = 0; frame < frames; ++frame) {
+        const time_point wake     = plan(now);
+        const time_point start    = std::max(wake, now) + system.wakeup_lateness();
+        const time_point finished = start + system.warp_cost();
+        done(finished);
+
+        // The swap waits for the first vsync after the frame is handed over
+        const time_point vsync = system.vsync_at_or_after(finished);
+        const long long  shown = system.vsync_index(vsync);
+        now                    = vsync + system.swap_latency();
+        swapped(now);
+
+        result.dropped += static_cast<std::size_t>(std::max(0LL, shown - last_shown - 1));
+        last_shown = shown;
+        result.swaps.push_back(now);
+        result.pose_age_ms.push_back(duration_to_double<std::milli>(vsync - start));
+    }
+    result.refreshes = static_cast<std::size_t>(last_shown - first_shown);
+    return result;
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    auto kth = values.begin() + static_cast<std::ptrdiff_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), kth, values.end());
+    return *kth;
+}
+
+double drop_rate(const simulation_result& result) {
+    return static_cast<double>(result.dropped) / static_cast<double>(result.refreshes);
+}
+
+void report(const char* policy, const simulation_result& result) {
+    std::printf("%-12s %8.2f%% %12.3f %12.3f\n", policy, 100.0 * drop_rate(result),
+                percentile(result.pose_age_ms, 0.5), percentile(result.pose_age_ms, 0.99));
+}
+
+struct prediction_error {
+    double old_median_us, old_p99_us, pacer_median_us, pacer_p99_us;
+};
+
+/// Replays @p swaps, predicting each swap from the ones before it; swaps after a dropped refresh are not scored
+prediction_error replay(const std::vector<time_point>& swaps, frame_pacer& pacer) {
+    std::vector<double> old_errors;
+    std::vector<double> pacer_errors;
+    for (std::size_t i = 0; i + 1 < swaps.size(); ++i) {
+        pacer.record_swap(swaps[i]);
+        if (i < frame_pacer::swap_history || swaps[i + 1] - swaps[i] > pacer.period() * 3 / 2) {
+            continue;
+        }
+        const time_point old_estimate   = swaps[i] + display_params::period;
+        const time_point pacer_estimate = pacer.next_vsync(swaps[i] + pacer.period() / 2);
+        old_errors.push_back(std::abs(duration_to_double<std::micro>(swaps[i + 1] - old_estimate)));
+        pacer_errors.push_back(std::abs(duration_to_double<std::micro>(swaps[i + 1] - pacer_estimate)));
+    }
+    return {percentile(old_errors, 0.5), percentile(old_errors, 0.99), percentile(pacer_errors, 0.5),
+            percentile(pacer_errors, 0.99)};
+}
+
+void print_prediction(const prediction_error& error, const frame_pacer& pacer) {
+    std::printf("next swap predicted by     median error  p99 error (us)\n");
+    std::printf("last swap + nominal period %12.1f %10.1f\n", error.old_median_us, error.old_p99_us);
+    std::printf("frame_pacer                %12.1f %10.1f\n", error.pacer_median_us, error.pacer_p99_us);
+    std::printf("fitted period %.4f ms (nominal %.4f ms), jitter %.1f us\n", duration_to_double<std::milli>(pacer.period()),
+                duration_to_double<std::milli>(display_params::period), duration_to_double<std::micro>(pacer.jitter()));
+}
+
+int replay_trace(const char* path, int column) {
+    std::ifstream file{path};
+    if (!file) {
+        std::printf("cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<time_point> swaps;
+    std::string             line;
+    while (std::getline(file, line)) {
+        std::stringstream fields{line};
+        std::string       field;
+        for (int i = 0; i <= column && std::getline(fields, field, ','); ++i) { }
+        char*           end   = nullptr;
+        const long long value = std::strtoll(field.c_str(), &end, 10);
+        if (end != field.c_str()) { // skips the header
+            swaps.emplace_back(duration{value});
+        }
+    }
+    if (swaps.size() <= frame_pacer::swap_history + 1) {
+        std::printf("%s has %zu swap times; need more than %zu\n", path, swaps.size(), frame_pacer::swap_history + 1);
+        return 1;
+    }
+    frame_pacer pacer{display_params::period, target_miss_rate};
+    std::printf("%zu swaps from %s\n", swaps.size(), path);
+    print_prediction(replay(swaps, pacer), pacer);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return replay_trace(argv[1], argc > 2 ? std::atoi(argv[2]) : 0);
+    }
+
+    constexpr int frames = 20000;
+
+    // The old policy: timewarp_gl slept for 90% of the time to the last swap plus the nominal period, starting when the
+    // swap returned
+    simulated_system        old_system{7};
+    time_point              last_swap = old_system.start();
+    const simulation_result old_policy = simulate(
+        old_system, frames,
+        [&](time_point now) {
+            const duration to_swap = last_swap + display_params::period - now;
+            return now + std::chrono::duration_cast<duration>(to_swap * 0.9);
+        },
+        [](time_point) { },
+        [&](time_point swap) {
+            last_swap = swap;
+        });
+
+    simulated_system        pacer_system{7};
+    frame_pacer             pacer{display_params::period, target_miss_rate};
+    const simulation_result paced = simulate(
+        pacer_system, frames,
+        [&](time_point now) {
+            return pacer.plan_wakeup(now);
+        },
+        [&](time_point done) {
+            pacer.record_work_done(done);
+        },
+        [&](time_point swap) {
+            pacer.record_swap(swap);
+        });
+
+    std::printf("%d frames, display period %.4f ms nominal, 0.2%% slower in fact; target miss rate %.1f%%\n\n", frames,
+                duration_to_double<std::milli>(display_params::period), 100.0 * target_miss_rate);
+    std::printf("policy        dropped  pose age p50  p99 (ms, start of warp to vsync)\n");
+    report("90% sleep", old_policy);
+    report("frame_pacer", paced);
+    std::printf("frame_pacer: lead %.3f ms, %zu of %zu planned frames late\n\n", duration_to_double<std::milli>(pacer.lead()),
+                pacer.missed_frames(), pacer.frames());
+
+    frame_pacer            replayed{display_params::period, target_miss_rate};
+    const prediction_error error = replay(paced.swaps, replayed);
+    print_prediction(error, replayed);
+
+    if (drop_rate(paced) > 2.0 * target_miss_rate) {
+        std::printf("frame_pacer dropped more than twice its target miss rate\n");
+        return 1;
+    }
+    if (error.pacer_median_us > error.old_median_us) {
+        std::printf("frame_pacer predicts the next swap worse than the last swap plus the nominal period\n");
+        return 1;
+    }
+    return 0;
+}
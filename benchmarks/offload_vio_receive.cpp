@@ -0,0 +1,163 @@
+/**
+ * Per-frame CPU time of offload_vio.server_rx's receive path, before and after messages were parsed in place.
+ *
+ * Builds IMUCamVec messages like offload_vio.device_tx sends (a stereo pair and the IMU samples since the last frame),
+ * then handles each one twice, on the same thread: once as server_rx used to (copy the event's string, find the "EEND!"
+ * delimiter, parse a substring into a fresh message, copy the IMU samples, the CamData, and the image strings, then
+ * clone the images), and once as it does now (parse the event into a reused message and copy each image once). Both
+ * are timed with the thread's CPU clock, for raw images and for encoded bitstreams, where the images come back from the
+ * decoder instead of the message.
+ *
+ * Usage: offload_vio_receive_benchmark [frames]
+ */
+#include "illixr/cpu_timer.hpp"
+#include "vio_input.pb.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core/mat.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+constexpr int         rows         = 480;
+constexpr int         cols         = 752;
+constexpr int         imu_samples  = 10; // 200 Hz IMU, 20 Hz camera
+const std::string     delimiter    = "EEND!";
+constexpr std::size_t encoded_size = 40000; // a typical H.264 frame of the EuRoC images
+
+std::string make_message(bool encoded, std::mt19937& random, cv::Mat& decoded) {
+    std::uniform_int_distribution<int> byte{0, 255};
+    vio_input_proto::IMUCamVec         message;
+    for (int i = 0; i < imu_samples; ++i) {
+        vio_input_proto::IMUData* imu = message.add_imu_data();
+        imu->set_timestamp(i);
+        imu->mutable_angular_vel()->set_x(0.1 * i);
+        imu->mutable_linear_accel()->set_z(9.81);
+    }
+    vio_input_proto::CamData* cam = message.mutable_cam_data();
+    cam->set_rows(rows);
+    cam->set_cols(cols);
+    std::string image(encoded ? encoded_size : static_cast<std::size_t>(rows * cols), '\0');
+    std::generate(image.begin(), image.end(), [&] {
+        return static_cast<char>(byte(random));
+    });
+    cam->set_img0_data(image);
+    cam->set_img1_data(image);
+
+    // Stands in for the decoder's output buffer
+    decoded = cv::Mat(rows, cols, CV_8UC1);
+    for (int y = 0; y < rows; ++y) {
+        std::generate(decoded.ptr<std::uint8_t>(y), decoded.ptr<std::uint8_t>(y) + cols, [&] {
+            return static_cast<std::uint8_t>(byte(random));
+        });
+    }
+    return message.SerializeAsString();
+}
+
+/// The receive path before in-place parsing; returns a byte of the published images, so the work is not optimized out
+int receive_before(const std::string& event, bool encoded, const cv::Mat& decoded) {
+    std::string                event_copy   = event + delimiter;
+    std::string::size_type     end_position = event_copy.find(delimiter);
+    vio_input_proto::IMUCamVec vio_input;
+    if (!vio_input.ParseFromString(event_copy.substr(0, end_position))) {
+        return -1;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < vio_input.imu_data_size(); ++i) {
+        vio_input_proto::IMUData imu = vio_input.imu_data(i);
+        sum += imu.angular_vel().x();
+    }
+    vio_input_proto::CamData cam_data  = vio_input.cam_data();
+    std::string              img0_copy = std::string(cam_data.img0_data());
+    std::string              img1_copy = std::string(cam_data.img1_data());
+
+    cv::Mat img0, img1;
+    if (encoded) {
+        // The decoder's images were cloned out under the lock, then again when published
+        img0 = decoded.clone().clone();
+        img1 = decoded.clone().clone();
+    } else {
+        img0 = cv::Mat(rows, cols, CV_8UC1, img0_copy.data()).clone();
+        img1 = cv::Mat(rows, cols, CV_8UC1, img1_copy.data()).clone();
+    }
+    return img0.ptr<std::uint8_t>(0)[0] + img1.ptr<std::uint8_t>(rows - 1)[cols - 1] + static_cast<int>(sum);
+}
+
+/// The receive path now
+int receive_after(const std::string& event, bool encoded, const cv::Mat& decoded, vio_input_proto::IMUCamVec& vio_input) {
+    if (!vio_input.ParseFromArray(event.data(), static_cast<int>(event.size()))) {
+        return -1;
+    }
+    double sum = 0.0;
+    for (const vio_input_proto::IMUData& imu : vio_input.imu_data()) {
+        sum += imu.angular_vel().x();
+    }
+    vio_input_proto::CamData& cam_data = *vio_input.mutable_cam_data();
+
+    cv::Mat img0, img1;
+    if (encoded) {
+        // Copied once out of the decoder's buffers, in the decoder callback
+        img0 = decoded.clone();
+        img1 = decoded.clone();
+    } else {
+        img0 = cv::Mat(rows, cols, CV_8UC1, cam_data.mutable_img0_data()->data()).clone();
+        img1 = cv::Mat(rows, cols, CV_8UC1, cam_data.mutable_img1_data()->data()).clone();
+    }
+    return img0.ptr<std::uint8_t>(0)[0] + img1.ptr<std::uint8_t>(rows - 1)[cols - 1] + static_cast<int>(sum);
+}
+
+/// Mean thread CPU time per frame, in microseconds
+template<typename Receive>
+double cpu_us_per_frame(const std::vector<std::string>& events, Receive&& receive, long& sink) {
+    const auto start = thread_cpu_time();
+    for (const std::string& event : events) {
+        sink += receive(event);
+    }
+    return static_cast<double>((thread_cpu_time() - start).count()) / 1e3 / static_cast<double>(events.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500;
+
+    long sink = 0;
+    std::printf("images   before (us/frame)   after (us/frame)\n");
+    for (const bool encoded : {false, true}) {
+        std::mt19937             random{1};
+        std::vector<std::string> events;
+        cv::Mat                  decoded;
+        for (std::size_t i = 0; i < std::min<std::size_t>(frames, 8); ++i) {
+            events.push_back(make_message(encoded, random, decoded));
+        }
+        while (events.size() < frames) {
+            events.push_back(events[events.size() % 8]);
+        }
+
+        vio_input_proto::IMUCamVec reused;
+        if (receive_before(events[0], encoded, decoded) != receive_after(events[0], encoded, decoded, reused)) {
+            std::printf("the two receive paths publish different images\n");
+            return 1;
+        }
+        const double before = cpu_us_per_frame(
+            events,
+            [&](const std::string& event) {
+                return receive_before(event, encoded, decoded);
+            },
+            sink);
+        const double after = cpu_us_per_frame(
+            events,
+            [&](const std::string& event) {
+                return receive_after(event, encoded, decoded, reused);
+            },
+            sink);
+        std::printf("%-7s  %18.1f  %17.1f\n", encoded ? "encoded" : "raw", before, after);
+    }
+    return sink == 0 ? 1 : 0;
+}
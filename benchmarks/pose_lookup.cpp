@@ -0,0 +1,208 @@
+/**
+ * Pose queries per second of pose_lookup, from several threads at once.
+ *
+ * Builds a synthetic 200 Hz ground-truth trajectory and queries it the way the renderers and the warp do: each thread
+ * asks for times that move forward by about a millisecond, from its own starting point. Compares the previous lookup
+ * (nearest sample through std::map::upper_bound, then the offset applied under a shared_mutex) with pose_track and
+ * quaternion_snapshot. The rates are only meaningful if pose_track answers like the binary search it replaces, so the
+ * benchmark first requires it to return the samples at their own times, to interpolate halfway between two samples, and
+ * to agree with a fresh binary search after 100000 forward steps and random jumps, whatever its cursor held.
+ *
+ * Usage: pose_lookup_benchmark [seconds per measurement]
+ */
+#include "pose_track.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+constexpr std::uint64_t sample_period_ns = 5000000; // 200 Hz
+constexpr std::size_t   samples          = 200 * 600;
+
+pose_sample trajectory(std::size_t i) {
+    const auto seconds = static_cast<float>(i) * 0.005f;
+    return {i * sample_period_ns,
+            Eigen::Vector3f{std::sin(seconds), 0.3f * std::cos(0.7f * seconds), 0.1f * seconds},
+            Eigen::Quaternionf{Eigen::AngleAxisf{std::sin(0.5f * seconds), Eigen::Vector3f::UnitY()} *
+                               Eigen::AngleAxisf{0.2f * std::cos(seconds), Eigen::Vector3f::UnitX()}}};
+}
+
+/// pose_lookup before pose_track: the nearest sample at or before the time, and a lock around the offset
+class map_lookup {
+public:
+    explicit map_lookup(const std::vector<pose_sample>& track) {
+        for (const auto& sample : track) {
+            samples_.emplace(sample.time, sample);
+        }
+    }
+
+    pose_sample at(std::uint64_t time) const {
+        auto nearest = samples_.upper_bound(time);
+        if (nearest != samples_.cbegin()) {
+            --nearest;
+        }
+        pose_sample      result = nearest->second;
+        std::shared_lock lock{offset_mutex_};
+        result.orientation = result.orientation * offset_;
+        return result;
+    }
+
+private:
+    std::map<std::uint64_t, pose_sample> samples_;
+    mutable std::shared_mutex            offset_mutex_;
+    Eigen::Quaternionf                   offset_{Eigen::Quaternionf::Identity()};
+};
+
+class track_lookup {
+public:
+    explicit track_lookup(const std::vector<pose_sample>& track)
+        : track_{track} { }
+
+    pose_sample at(std::uint64_t time) const {
+        pose_sample result = track_.at(time);
+        result.orientation = result.orientation * offset_.load();
+        return result;
+    }
+
+private:
+    pose_track          track_;
+    quaternion_snapshot offset_;
+};
+
+bool close(const pose_sample& a, const pose_sample& b) {
+    return a.time == b.time && (a.position - b.position).norm() < 1e-5f && a.orientation.angularDistance(b.orientation) < 1e-4f;
+}
+
+/// The interpolation of pose_track, around a binary search
+pose_sample reference_at(const std::vector<pose_sample>& track, std::uint64_t time) {
+    if (time <= track.front().time) {
+        return track.front();
+    }
+    if (time >= track.back().time) {
+        return track.back();
+    }
+    const auto after =
+        std::upper_bound(track.cbegin(), track.cend(), time, [](std::uint64_t lookup, const pose_sample& sample) {
+            return lookup < sample.time;
+        });
+    const pose_sample& before = *(after - 1);
+    const auto         t      = static_cast<float>(static_cast<double>(time - before.time) / sample_period_ns);
+    return {time, before.position + t * (after->position - before.position), before.orientation.slerp(t, after->orientation)};
+}
+
+bool returns_samples_and_midpoints(const std::vector<pose_sample>& track) {
+    const pose_track interpolated{track};
+    bool             ok = true;
+    for (std::size_t i = 0; i < track.size(); i += 97) {
+        if (!close(interpolated.at(track[i].time), track[i])) {
+            std::printf("pose_track does not return sample %zu at its own time\n", i);
+            ok = false;
+            break;
+        }
+    }
+
+    const pose_sample     middle            = interpolated.at(track[1000].time + sample_period_ns / 2);
+    const Eigen::Vector3f expected_position = (track[1000].position + track[1001].position) / 2.0f;
+    const float           half_angle        = track[1000].orientation.angularDistance(track[1001].orientation) / 2.0f;
+    if ((middle.position - expected_position).norm() > 1e-5f ||
+        std::abs(middle.orientation.angularDistance(track[1000].orientation) - half_angle) > 1e-4f) {
+        std::printf("pose_track does not interpolate halfway between two samples\n");
+        ok = false;
+    }
+    return ok;
+}
+
+bool independent_of_cursor(const std::vector<pose_sample>& track) {
+    const pose_track interpolated{track};
+
+    // Steps forward exercise the walk and jumps the binary search, which must find the samples a plain search finds
+    std::mt19937                                 random{3};
+    std::uniform_int_distribution<std::uint64_t> jump{0, track.back().time + sample_period_ns};
+    std::uniform_int_distribution<std::uint64_t> step{0, 3 * sample_period_ns};
+    std::uint64_t                                now = 0;
+    for (int i = 0; i < 100000; ++i) {
+        now = i % 10 == 0 ? jump(random) : now + step(random);
+        if (!close(interpolated.at(now), reference_at(track, now))) {
+            std::printf("pose_track depends on where the previous lookup ended, at %llu\n",
+                        static_cast<unsigned long long>(now));
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Queries per second from @p threads threads, each advancing by about 1 ms from its own starting time
+template<typename Lookup>
+double queries_per_second(const Lookup& lookup, unsigned threads, double seconds) {
+    std::vector<std::thread>        workers;
+    std::vector<unsigned long long> counts(threads * 16, 0); // spread out, against false sharing
+    std::vector<float>              sinks(threads * 16, 0.0f);
+    const auto                      end = std::chrono::steady_clock::now() + std::chrono::duration<double>{seconds};
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937                                 random{t};
+            std::uniform_int_distribution<std::uint64_t> step{900000, 1100000};
+            std::uint64_t                                now   = t * 7 * sample_period_ns;
+            unsigned long long                           count = 0;
+            float                                        sink  = 0.0f;
+            while (std::chrono::steady_clock::now() < end) {
+                for (int i = 0; i < 1000; ++i) {
+                    now += step(random);
+                    if (now > samples * sample_period_ns) {
+                        now = 0;
+                    }
+                    sink += lookup.at(now).position.x();
+                }
+                count += 1000;
+            }
+            counts[t * 16] = count;
+            sinks[t * 16]  = sink;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    unsigned long long total = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        total += counts[t * 16];
+    }
+    return static_cast<double>(total) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+
+    std::vector<pose_sample> track;
+    track.reserve(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        track.push_back(trajectory(i));
+    }
+    if (!returns_samples_and_midpoints(track) || !independent_of_cursor(track)) {
+        return 1;
+    }
+    std::printf("pose_track matches its samples, interpolates, and does not depend on the previous lookup\n\n");
+
+    const map_lookup   old_lookup{track};
+    const track_lookup new_lookup{track};
+    std::printf("threads  map + shared_mutex  pose_track + snapshot  (million queries per second)\n");
+    const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1; threads <= std::max(cores, 4u); threads *= 2) {
+        const double old_rate = queries_per_second(old_lookup, threads, seconds);
+        const double new_rate = queries_per_second(new_lookup, threads, seconds);
+        std::printf("%7u  %18.2f  %21.2f\n", threads, old_rate / 1e6, new_rate / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * Encode/decode cost of the switchboard's network serializations.
+ *
+ * For each networked event type, reports the mean time to serialize and deserialize one event, and the size on the
+ * wire, for the Boost binary archive (as used by network_writer for BOOST topics) and the compact codec (COMPACT
+ * topics).
+ *
+ * Usage: serialization_benchmark [iterations]
+ */
+#include "illixr/data_format/serialization/frame.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+struct result {
+    double      encode_ns;
+    double      decode_ns;
+    std::size_t bytes;
+};
+
+template<typename Function>
+double mean_ns(std::size_t iterations, Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+        static_cast<double>(iterations);
+}
+
+// Same archive setup as switchboard::network_writer / topic::deserialize_and_put
+template<typename Event>
+result run_boost(const std::shared_ptr<Event>& event, std::size_t iterations) {
+    const switchboard::ptr<switchboard::event> base_event = event;
+    std::vector<char>                          buffer;
+
+    const double encode_ns = mean_ns(iterations, [&] {
+        buffer.clear();
+        boost::iostreams::back_insert_device<std::vector<char>>                                  inserter{buffer};
+        boost::iostreams::stream_buffer<boost::iostreams::back_insert_device<std::vector<char>>> stream{inserter};
+        {
+            boost::archive::binary_oarchive oa{stream, boost::archive::no_header};
+            oa << base_event;
+        }
+        stream.pubsync();
+    });
+
+    const double decode_ns = mean_ns(iterations, [&] {
+        boost::iostreams::stream<boost::iostreams::array_source> stream{buffer.data(), buffer.size()};
+        boost::archive::binary_iarchive                          ia{stream, boost::archive::no_header};
+        switchboard::ptr<switchboard::event>                     decoded;
+        ia >> decoded;
+    });
+
+    return {encode_ns, decode_ns, buffer.size()};
+}
+
+template<typename Event>
+result run_compact(const std::shared_ptr<Event>& event, std::size_t iterations) {
+    std::vector<char> buffer;
+
+    const double encode_ns = mean_ns(iterations, [&] {
+        buffer.clear();
+        network::compact::encode(*event, buffer);
+    });
+
+    const double decode_ns = mean_ns(iterations, [&] {
+        auto decoded = std::make_shared<Event>();
+        network::compact::decode(buffer.data(), buffer.size(), *decoded);
+    });
+
+    return {encode_ns, decode_ns, buffer.size()};
+}
+
+void report(const char* type, const char* method, const result& r) {
+    std::printf("%-22s %-8s %12.1f %12.1f %10zu\n", type, method, r.encode_ns, r.decode_ns, r.bytes);
+}
+
+data_format::pose::head_pose_type make_head_pose() {
+    data_format::pose::head_pose_type pose{time_point{std::chrono::milliseconds{1234}},
+                                           Eigen::Vector3f{0.1f, 1.6f, -0.3f},
+                                           Eigen::Quaternionf{0.92f, 0.f, 0.38f, 0.f},
+                                           Eigen::Vector3f{0.01f, 0.f, 0.02f},
+                                           Eigen::Vector3f{0.f, 0.5f, 0.f},
+                                           true,
+                                           true,
+                                           true,
+                                           0.9f};
+    return pose;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+
+    auto head_pose      = std::make_shared<data_format::pose::head_pose_type>(make_head_pose());
+    auto fast_head_pose = std::make_shared<data_format::pose::fast_head_pose_type>(
+        make_head_pose(), time_point{std::chrono::milliseconds{1240}}, time_point{std::chrono::milliseconds{1256}});
+
+    auto rendered_frame = std::make_shared<data_format::rendered_frame>(
+        std::array<GLuint, 2>{1, 2}, std::array<GLuint, 2>{0, 1}, *fast_head_pose, time_point{std::chrono::milliseconds{1241}},
+        time_point{std::chrono::milliseconds{1250}});
+
+    // Two 64 KiB color packets, roughly one P-frame per eye at 2K
+    std::vector<uint8_t> left(64 * 1024, 0x5a);
+    std::vector<uint8_t> right(64 * 1024, 0xa5);
+    auto                 compressed_frame = std::make_shared<data_format::compressed_frame>(left, right, *fast_head_pose, 1, 1);
+
+    std::printf("%-22s %-8s %12s %12s %10s\n", "type", "method", "encode ns", "decode ns", "bytes");
+    report("head_pose_type", "boost", run_boost(head_pose, iterations));
+    report("head_pose_type", "compact", run_compact(head_pose, iterations));
+    report("fast_head_pose_type", "boost", run_boost(fast_head_pose, iterations));
+    report("fast_head_pose_type", "compact", run_compact(fast_head_pose, iterations));
+    // rendered_frame has no Boost serializer; it is never sent over the network with BOOST
+    report("rendered_frame", "compact", run_compact(rendered_frame, iterations));
+    report("compressed_frame", "boost", run_boost(compressed_frame, iterations / 100 + 1));
+    report("compressed_frame", "compact", run_compact(compressed_frame, iterations / 100 + 1));
+    return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * Consistency and generation throughput of the synthetic_sensors plugin.
+ *
+ * Times how many IMU samples, stereo pairs, and RGB-D frames one thread can generate per second, at several
+ * resolutions. The data is only useful if the streams agree with each other, so first: the same seed must give the same
+ * trajectory and another seed a different one; the analytic derivatives must match finite differences of the poses;
+ * dead reckoning from the noise-free IMU samples must stay within 5 cm (200 Hz) and 1 mm (2 kHz) of the poses after
+ * 10 s; and the right image must be the left one shifted by the disparity of the plane.
+ *
+ * Usage: synthetic_sensors_benchmark [seconds per measurement]
+ */
+#include "synthetic_camera.hpp"
+#include "trajectory.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+using namespace ILLIXR;
+
+namespace {
+
+bool seeded_deterministically() {
+    const synthetic_trajectory a{7}, b{7}, c{8};
+    for (double t = 0.0; t < 60.0; t += 0.37) {
+        if (a.at(t).position != b.at(t).position || a.at(t).orientation.coeffs() != b.at(t).orientation.coeffs()) {
+            std::printf("the same seed gives different trajectories at %.2f s\n", t);
+            return false;
+        }
+    }
+    if ((a.at(1.0).position - c.at(1.0).position).norm() < 1e-6) {
+        std::printf("different seeds give the same trajectory\n");
+        return false;
+    }
+    return true;
+}
+
+bool derivatives_match_poses(const synthetic_trajectory& trajectory) {
+    constexpr double h = 1e-5;
+    double           worst_velocity = 0.0, worst_acceleration = 0.0, worst_angular = 0.0;
+    for (double t = 0.1; t < 30.0; t += 0.173) {
+        const trajectory_state before = trajectory.at(t - h), now = trajectory.at(t), after = trajectory.at(t + h);
+        const Eigen::Vector3d  velocity     = (after.position - before.position) / (2 * h);
+        const Eigen::Vector3d  acceleration = (after.position - 2 * now.position + before.position) / (h * h);
+        // Body angular velocity from the rotation between the neighbouring orientations
+        const Eigen::AngleAxisd delta{before.orientation.conjugate() * after.orientation};
+        const Eigen::Vector3d   angular = delta.axis() * delta.angle() / (2 * h);
+
+        worst_velocity     = std::max(worst_velocity, (velocity - now.velocity).norm());
+        worst_acceleration = std::max(worst_acceleration, (acceleration - now.acceleration).norm());
+        worst_angular      = std::max(worst_angular, (angular - now.angular_velocity).norm());
+    }
+    std::printf("largest difference from finite differences: velocity %.1e m/s, acceleration %.1e m/s^2, angular velocity "
+                "%.1e rad/s\n",
+                worst_velocity, worst_acceleration, worst_angular);
+    // The second difference loses about half the digits
+    return worst_velocity < 1e-6 && worst_acceleration < 1e-2 && worst_angular < 1e-6;
+}
+
+/// Integrates the ideal IMU samples at @p rate for @p seconds; returns the position and orientation errors at the end
+std::pair<double, double> integrate(const synthetic_trajectory& trajectory, double rate, double seconds) {
+    const double           dt    = 1.0 / rate;
+    const long             steps = std::lround(seconds * rate);
+    const Eigen::Vector3d  gravity{0.0, 0.0, -synthetic_trajectory::gravity};
+    const trajectory_state start = trajectory.at(0.0);
+
+    Eigen::Vector3d    position    = start.position;
+    Eigen::Vector3d    velocity    = start.velocity;
+    Eigen::Quaterniond orientation = start.orientation;
+    auto               previous    = synthetic_trajectory::imu(start);
+    for (long i = 1; i <= steps; ++i) {
+        const auto current = synthetic_trajectory::imu(trajectory.at(static_cast<double>(i) * dt));
+
+        // Midpoint rule: rotate by the mean angular velocity, and average the specific force over both orientations
+        const Eigen::Vector3d    omega = 0.5 * (previous.first + current.first);
+        const Eigen::Quaterniond next =
+            (orientation * Eigen::Quaterniond{Eigen::AngleAxisd{omega.norm() * dt, omega.normalized()}}).normalized();
+        const Eigen::Vector3d acceleration = 0.5 * (orientation * previous.second + next * current.second) + gravity;
+        position += velocity * dt + 0.5 * acceleration * dt * dt;
+        velocity += acceleration * dt;
+        orientation = next;
+        previous    = current;
+    }
+    const trajectory_state end = trajectory.at(static_cast<double>(steps) * dt);
+    return {(position - end.position).norm(), orientation.angularDistance(end.orientation)};
+}
+
+bool imu_integrates_to_poses(const synthetic_trajectory& trajectory) {
+    bool ok = true;
+    for (const double rate : {200.0, 2000.0}) {
+        const auto [position_error, angle_error] = integrate(trajectory, rate, 10.0);
+        std::printf("IMU at %4.0f Hz integrated for 10 s: %.2e m, %.2e rad from the ground truth\n", rate, position_error,
+                    angle_error);
+        // Dead reckoning drifts, but only by the integration error
+        ok = ok && position_error < (rate > 1000.0 ? 1e-3 : 0.05) && angle_error < 1e-3;
+    }
+    return ok;
+}
+
+bool stereo_pair_has_disparity(const synthetic_trajectory& trajectory) {
+    const synthetic_camera camera{752, 480, 3};
+    const trajectory_state state = trajectory.at(2.5);
+    const auto [left, right]     = camera.stereo(state);
+    // 0.11 m at 2 m, minus the body's distance along x, seen with a focal length of half the width
+    const int disparity = static_cast<int>(std::lround(376.0 * 0.11 / (2.0 - state.position.x())));
+    for (int y = 0; y < left.rows; y += 7) {
+        for (int x = 0; x + disparity < left.cols; x += 5) {
+            if (right.at<std::uint8_t>(y, x) != left.at<std::uint8_t>(y, x + disparity)) {
+                std::printf("the right image is not the left one shifted by %d pixels\n", disparity);
+                return false;
+            }
+        }
+    }
+    std::printf("right image is the left one shifted by the %d pixel disparity\n", disparity);
+    return true;
+}
+
+template<typename Function>
+double per_second(Function&& function, double seconds) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto end   = start + std::chrono::duration<double>{seconds};
+    long       count = 0;
+    while (std::chrono::steady_clock::now() < end) {
+        function(count++);
+    }
+    return static_cast<double>(count) / std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double               seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    const synthetic_trajectory trajectory{0};
+
+    if (!seeded_deterministically() || !derivatives_match_poses(trajectory) || !imu_integrates_to_poses(trajectory) ||
+        !stereo_pair_has_disparity(trajectory)) {
+        return 1;
+    }
+
+    double     sink     = 0.0;
+    const auto imu_rate = per_second(
+        [&](long i) {
+            sink += synthetic_trajectory::imu(trajectory.at(static_cast<double>(i) * 5e-4)).second.x();
+        },
+        seconds);
+    std::printf("\nIMU samples         %10.0f per second\n", imu_rate);
+
+    std::printf("\nresolution   stereo pairs/s   RGB-D frames/s\n");
+    for (const auto& [width, height] :
+         {std::pair{640, 480}, std::pair{752, 480}, std::pair{1280, 720}, std::pair{1920, 1080}}) {
+        const synthetic_camera camera{width, height, 0};
+        const double           stereo = per_second(
+            [&](long i) {
+                sink += camera.stereo(trajectory.at(static_cast<double>(i) / 120.0)).first.rows;
+            },
+            seconds);
+        const double rgb_depth = per_second(
+            [&](long i) {
+                sink += camera.rgb_depth(trajectory.at(static_cast<double>(i) / 120.0)).first.rows;
+            },
+            seconds);
+        std::printf("%4dx%-4d   %14.0f   %14.0f\n", width, height, stereo, rgb_depth);
+    }
+    return sink == 0.0 ? 1 : 0;
+}
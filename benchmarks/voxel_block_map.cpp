@@ -0,0 +1,263 @@
+/**
+ * Voxel-block index used by ADA scene management: the previous bucketed map vs. voxel_block_map.
+ *
+ * Replays a stream of scene updates against both structures the way spatial_hash does: for every scene, each listed
+ * voxel block is first cleaned (looked up and its face range set to -1, -1), then given a new face range (inserted if
+ * it is new). Reports the mean time per clean and per insert, and the number of blocks at the end.
+ *
+ * The stream is read from a whitespace-separated file with one line per updated voxel block,
+ *
+ *     <scene id> <x> <y> <z> <faces>
+ *
+ * grouped by scene id (e.g. dumped from scene_management's VB_update_lists for a ScanNet sequence). Without a file, a
+ * synthetic scan of a furnished 6 x 8 x 3 m room (about 27k surface blocks of 6.4 cm) is generated.
+ *
+ * Usage: voxel_block_map_benchmark [update stream file, or - for the synthetic scan] [repetitions]
+ */
+#include "illixr/voxel_block_map.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace ILLIXR;
+
+namespace {
+
+struct vb_update {
+    VoxelBlockIndex index;
+    int             faces;
+};
+
+using scene = std::vector<vb_update>;
+
+// The index spatial_hash used before voxel_block_map: 25,600 buckets, each scanned linearly
+class bucketed_map {
+public:
+    using entry = std::tuple<VoxelBlockIndex, int, int>;
+
+    bucketed_map() {
+        map_.reserve(25600);
+    }
+
+    static unsigned hash_vb(const VoxelBlockIndex& index) {
+        int x, y, z;
+        std::tie(x, y, z) = index;
+        auto hash         = (x * 73856093) ^ (y * 19349669) ^ (z * 83492791);
+        return std::abs(hash) % 25600;
+    }
+
+    void clean(const VoxelBlockIndex& index) {
+        auto it = map_.find(hash_vb(index));
+        if (it == map_.end()) {
+            return;
+        }
+        for (auto& vb_entry : it->second) {
+            if (std::get<0>(vb_entry) == index) {
+                std::get<1>(vb_entry) = -1;
+                std::get<2>(vb_entry) = -1;
+                return;
+            }
+        }
+    }
+
+    void assign(const VoxelBlockIndex& index, int first, int last) {
+        auto& bucket = map_[hash_vb(index)];
+        for (auto& vb_entry : bucket) {
+            if (std::get<0>(vb_entry) == index) {
+                std::get<1>(vb_entry) = first;
+                std::get<2>(vb_entry) = last;
+                return;
+            }
+        }
+        bucket.emplace_back(index, first, last);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        std::size_t count = 0;
+        for (const auto& bucket : map_) {
+            count += bucket.second.size();
+        }
+        return count;
+    }
+
+    [[nodiscard]] std::size_t longest_bucket() const {
+        std::size_t longest = 0;
+        for (const auto& bucket : map_) {
+            longest = std::max(longest, bucket.second.size());
+        }
+        return longest;
+    }
+
+private:
+    std::unordered_map<unsigned, std::vector<entry>> map_;
+};
+
+class open_addressing_map {
+public:
+    open_addressing_map() {
+        map_.reserve(65536);
+    }
+
+    void clean(const VoxelBlockIndex& index) {
+        if (auto* range = map_.find(index)) {
+            *range = {-1, -1};
+        }
+    }
+
+    void assign(const VoxelBlockIndex& index, int first, int last) {
+        map_[index] = {first, last};
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return map_.size();
+    }
+
+private:
+    voxel_block_map<std::pair<int, int>> map_;
+};
+
+std::vector<scene> read_stream(const char* path) {
+    std::ifstream      in{path};
+    std::vector<scene> scenes;
+    long               scene_id, last_id = -1;
+    int                x, y, z, faces;
+    while (in >> scene_id >> x >> y >> z >> faces) {
+        if (scene_id != last_id) {
+            scenes.emplace_back();
+            last_id = scene_id;
+        }
+        scenes.back().push_back({{x, y, z}, faces});
+    }
+    return scenes;
+}
+
+// A camera sweeping twice around a furnished room; every scene updates the surface blocks near where it looks
+std::vector<scene> synthesize_stream() {
+    constexpr int size_x = 94, size_y = 125, size_z = 47; // 6 x 8 x 3 m in 6.4 cm blocks
+    struct box {
+        int x0, y0, z0, x1, y1, z1;
+    };
+    const std::vector<box> furniture{{10, 10, 0, 40, 25, 12}, {60, 80, 0, 85, 115, 8}, {20, 70, 0, 35, 100, 14},
+                                     {70, 15, 0, 90, 30, 30}};
+
+    auto on_box_shell = [](const box& b, int x, int y, int z) {
+        const bool inside = x >= b.x0 && x <= b.x1 && y >= b.y0 && y <= b.y1 && z >= b.z0 && z <= b.z1;
+        return inside && (x == b.x0 || x == b.x1 || y == b.y0 || y == b.y1 || z == b.z0 || z == b.z1);
+    };
+    auto is_surface = [&](int x, int y, int z) {
+        if (x == 0 || x == size_x - 1 || y == 0 || y == size_y - 1 || z == 0 || z == size_z - 1) {
+            return true;
+        }
+        return std::any_of(furniture.begin(), furniture.end(), [&](const box& b) {
+            return on_box_shell(b, x, y, z);
+        });
+    };
+
+    std::mt19937                       rng{42};
+    std::uniform_int_distribution<int> faces{1, 24};
+    std::vector<scene>                 scenes;
+    constexpr int                      scene_count = 400;
+    constexpr int                      reach       = 14; // blocks visible around the looked-at point (about 0.9 m)
+    for (int s = 0; s < scene_count; ++s) {
+        // the looked-at point walks along the walls, twice around the room, at varying height
+        const double t  = 2.0 * static_cast<double>(s) / scene_count;
+        const double a  = 2.0 * 3.14159265358979 * t;
+        const int    cx = static_cast<int>((size_x - 1) * (0.5 + 0.5 * std::cos(a)));
+        const int    cy = static_cast<int>((size_y - 1) * (0.5 + 0.5 * std::sin(a)));
+        const int    cz = static_cast<int>((size_z - 1) * (0.3 + 0.4 * ((s % 50) / 50.0)));
+
+        scene update;
+        for (int x = std::max(0, cx - reach); x <= std::min(size_x - 1, cx + reach); ++x) {
+            for (int y = std::max(0, cy - reach); y <= std::min(size_y - 1, cy + reach); ++y) {
+                for (int z = std::max(0, cz - reach); z <= std::min(size_z - 1, cz + reach); ++z) {
+                    if (is_surface(x, y, z)) {
+                        update.push_back({{x - size_x / 2, y - size_y / 2, z}, faces(rng)});
+                    }
+                }
+            }
+        }
+        // and a wide pass over the floor and furniture, as when the camera tilts down
+        for (int x = 0; x < size_x; x += 3) {
+            for (int y = (s * 7) % 5; y < size_y; y += 5) {
+                for (int z = 0; z < 15; ++z) {
+                    if (is_surface(x, y, z)) {
+                        update.push_back({{x - size_x / 2, y - size_y / 2, z}, faces(rng)});
+                    }
+                }
+            }
+        }
+        scenes.push_back(std::move(update));
+    }
+    return scenes;
+}
+
+struct result {
+    double      clean_ns;
+    double      assign_ns;
+    std::size_t blocks;
+};
+
+template<typename Map>
+result replay(const std::vector<scene>& scenes, int repetitions, Map& map) {
+    std::chrono::nanoseconds clean{0}, assign{0};
+    std::size_t              operations = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        map       = Map{};
+        int faces = 0;
+        for (const auto& update : scenes) {
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& vb : update) {
+                map.clean(vb.index);
+            }
+            auto middle = std::chrono::steady_clock::now();
+            for (const auto& vb : update) {
+                map.assign(vb.index, faces, faces + vb.faces - 1);
+                faces += vb.faces;
+            }
+            auto end = std::chrono::steady_clock::now();
+            clean += middle - start;
+            assign += end - middle;
+            operations += update.size();
+        }
+    }
+    return {static_cast<double>(clean.count()) / static_cast<double>(operations),
+            static_cast<double>(assign.count()) / static_cast<double>(operations), map.size()};
+}
+
+void report(const char* name, const result& r) {
+    std::printf("%-16s %12.1f %12.1f %10zu\n", name, r.clean_ns, r.assign_ns, r.blocks);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool               from_file   = argc > 1 && std::string{argv[1]} != "-";
+    const std::vector<scene> scenes      = from_file ? read_stream(argv[1]) : synthesize_stream();
+    const int                repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::size_t updates = 0;
+    for (const auto& update : scenes) {
+        updates += update.size();
+    }
+    std::printf("%zu scenes, %zu voxel block updates, %d repetitions\n\n", scenes.size(), updates, repetitions);
+
+    bucketed_map        bucketed;
+    open_addressing_map open_addressing;
+    const result        bucketed_result        = replay(scenes, repetitions, bucketed);
+    const result        open_addressing_result = replay(scenes, repetitions, open_addressing);
+
+    std::printf("%-16s %12s %12s %10s\n", "index", "clean ns", "assign ns", "blocks");
+    report("bucketed (old)", bucketed_result);
+    report("voxel_block_map", open_addressing_result);
+    std::printf("\nlongest bucket in the old index: %zu blocks\n", bucketed.longest_bucket());
+    return 0;
+}
@@ -0,0 +1,52 @@
+/** @file cpu_frame.hpp
+ * @brief Eye buffers held in CPU memory, for renderers and reprojection that run without a GPU.
+ */
+#pragma once
+
+#include "illixr/data_format/poses/head_pose.hpp"
+#include "illixr/switchboard.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ILLIXR::data_format {
+
+/**
+ * @brief One eye image: tightly packed RGBA8 rows, top row first, with an optional depth buffer.
+ *
+ * Texture coordinates follow the Vulkan convention: (0, 0) is the top-left corner of the image. Depth holds device
+ * depth (the value the depth test compares), reversed or not as rendering_params::reverse_z says.
+ */
+struct cpu_eye_image {
+    int                       width  = 0;
+    int                       height = 0;
+    std::vector<std::uint8_t> rgba;  ///< width * height * 4 bytes
+    std::vector<float>        depth; ///< width * height values, or empty if there is no depth
+
+    cpu_eye_image() = default;
+
+    cpu_eye_image(int width_, int height_, bool with_depth = false)
+        : width{width_}
+        , height{height_}
+        , rgba(static_cast<std::size_t>(width_) * height_ * 4)
+        , depth(with_depth ? static_cast<std::size_t>(width_) * height_ : 0) { }
+};
+
+/**
+ * @brief A stereo frame in CPU memory and the pose it was rendered (or reprojected) for.
+ */
+struct cpu_rendered_frame : public switchboard::event {
+    std::array<cpu_eye_image, 2> eyes;
+    pose::fast_head_pose_type    render_pose;
+    time_point                   render_time;
+
+    cpu_rendered_frame() = default;
+
+    cpu_rendered_frame(std::array<cpu_eye_image, 2> eyes_, pose::fast_head_pose_type render_pose_, time_point render_time_)
+        : eyes{std::move(eyes_)}
+        , render_pose{std::move(render_pose_)}
+        , render_time{render_time_} { }
+};
+
+} // namespace ILLIXR::data_format
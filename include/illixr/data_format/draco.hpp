@@ -2,11 +2,81 @@
 
 #include "draco_illixr/mesh/mesh.h"
 #include "illixr/switchboard.hpp"
+#include "illixr/voxel_block_map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
 
 namespace ILLIXR::data_format {
 
-using VoxelBlockIndex = std::tuple<int, int, int>;
-using NewVB           = std::tuple<VoxelBlockIndex, std::vector<Eigen::Vector3d>, std::vector<Eigen::Vector3d>>;
+/**
+ * @brief Vertex positions (or colors) stored as one float array per coordinate.
+ *
+ * Draco quantizes positions to 14 bits and decodes them as float, so single precision loses nothing; it takes half
+ * the memory and copy bandwidth of Eigen::Vector3d, and each coordinate array can be copied or streamed on its own.
+ */
+struct vertex_array {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    void push_back(float vx, float vy, float vz) {
+        x.push_back(vx);
+        y.push_back(vy);
+        z.push_back(vz);
+    }
+
+    void reserve(std::size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        z.reserve(count);
+    }
+
+    void resize(std::size_t count) {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return x.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return x.empty();
+    }
+
+    [[nodiscard]] std::size_t size_in_bytes() const {
+        return 3 * x.size() * sizeof(float);
+    }
+
+    /// Vertex @p i in double precision, for consumers which need it
+    [[nodiscard]] Eigen::Vector3d as_double(std::size_t i) const {
+        return {x[i], y[i], z[i]};
+    }
+
+    /// Copies all vertices into @p out, starting at vertex @p at; @p out must already be large enough
+    void copy_to(vertex_array& out, std::size_t at) const {
+        std::copy(x.begin(), x.end(), out.x.begin() + static_cast<std::ptrdiff_t>(at));
+        std::copy(y.begin(), y.end(), out.y.begin() + static_cast<std::ptrdiff_t>(at));
+        std::copy(z.begin(), z.end(), out.z.begin() + static_cast<std::ptrdiff_t>(at));
+    }
+};
+
+/// Geometry of the faces that fall into one voxel block: three vertices per face, and optionally their colors
+struct vb_geometry {
+    vertex_array vertices;
+    vertex_array colors;
+};
+
+using scene_update_map = voxel_block_map<vb_geometry>;
 
 struct draco_type : public switchboard::event {
     std::unique_ptr<draco_illixr::Mesh>              preprocessed_mesh;
@@ -15,20 +85,20 @@ struct draco_type : public switchboard::event {
     unsigned                                         num_faces;
     unsigned                                         chunk_id;
     unsigned                                         max_chunk;
-    std::vector<Eigen::Vector3d>                     vertices;
-    std::vector<Eigen::Vector3d>                     colors;
-    std::unordered_map<unsigned, std::vector<NewVB>> scene_update_mapping;
+    vertex_array                                     vertices;
+    vertex_array                                     colors;
+    scene_update_map                                 scene_update_mapping;
     unsigned                                         face_number;
 
     // 91 for moving scene update mapping
-    draco_type(unsigned id, unsigned chunk_id_, std::unordered_map<unsigned, std::vector<NewVB>>&& inputUpdateMap)
+    draco_type(unsigned id, unsigned chunk_id_, scene_update_map&& inputUpdateMap)
         : frame_id(id)
         , chunk_id{chunk_id_}
         , scene_update_mapping(std::move(inputUpdateMap)) { }
 
     // 527 for moving generatePartialMesh
-    draco_type(std::unique_ptr<draco_illixr::Mesh> input_mesh, unsigned id, std::vector<Eigen::Vector3d>& vertices_,
-               std::vector<Eigen::Vector3d>& colors_, unsigned face_number_)
+    draco_type(std::unique_ptr<draco_illixr::Mesh> input_mesh, unsigned id, vertex_array& vertices_, vertex_array& colors_,
+               unsigned face_number_)
         : preprocessed_mesh(std::move(input_mesh))
         , frame_id(id)
         , vertices{vertices_}
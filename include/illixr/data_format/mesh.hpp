@@ -135,10 +135,11 @@ struct mesh_type : public switchboard::event {
         , num_vertices{num_vertices_}
         , reader{std::move(input_reader)} { }
 
-    [[maybe_unused]] mesh_type(const unsigned type_, const std::vector<char>& input_mesh, bool is_active, unsigned id_,
+    // takes the buffer by value, so that a codec can move its output in
+    [[maybe_unused]] mesh_type(const unsigned type_, std::vector<char> input_mesh, bool is_active, unsigned id_,
                                unsigned chunk_id_, unsigned max_chunk_)
         : type{type_}
-        , mesh(input_mesh)
+        , mesh(std::move(input_mesh))
         , active{is_active}
         , id{id_}
         , chunk_id{chunk_id_}
@@ -16,6 +16,7 @@
     #endif // __has_include(<Eigen/Dense>)
 #endif     // USING_OPENXR
 #include <map>
+#include <memory>
 
 namespace ILLIXR::data_format::pose {
 
@@ -216,29 +217,29 @@ struct fast_head_pose_type : public switchboard::event {
  * so that downstream stages can re-project the image to a more current pose.
  */
 struct [[maybe_unused]] texture_pose : public switchboard::event {
-    duration           offload_duration{};
-    unsigned char*     image{};
-    time_point         pose_time{};
-    Eigen::Vector3f    position;
-    Eigen::Quaternionf latest_quaternion;
-    Eigen::Quaternionf render_quaternion;
+    duration                         offload_duration{};
+    std::shared_ptr<unsigned char[]> image{}; ///< RGB pixels, freed with the last reference
+    time_point                       pose_time{};
+    Eigen::Vector3f                  position;
+    Eigen::Quaternionf               latest_quaternion;
+    Eigen::Quaternionf               render_quaternion;
 
     texture_pose() = default;
 
     /**
      * @brief Construct from explicit components.
      * @param offload_duration_    Time taken to offload / transfer the texture
-     * @param image_               Pointer to the rendered image data
+     * @param image_               The rendered image data
      * @param pose_time_           Timestamp of the pose used for rendering
      * @param position_            Translation at render time
      * @param latest_quaternion_   Most recent orientation at time of submission
      * @param render_quaternion_   Orientation used when the frame was rendered
      */
 
-    texture_pose(duration offload_duration_, unsigned char* image_, time_point pose_time_, Eigen::Vector3f position_,
-                 Eigen::Quaternionf latest_quaternion_, Eigen::Quaternionf render_quaternion_)
+    texture_pose(duration offload_duration_, std::shared_ptr<unsigned char[]> image_, time_point pose_time_,
+                 Eigen::Vector3f position_, Eigen::Quaternionf latest_quaternion_, Eigen::Quaternionf render_quaternion_)
         : offload_duration{offload_duration_}
-        , image{image_}
+        , image{std::move(image_)}
         , pose_time{pose_time_}
         , position{std::move(position_)}
         , latest_quaternion{std::move(latest_quaternion_)}
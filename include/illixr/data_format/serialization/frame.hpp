@@ -271,4 +271,209 @@ void load(Archive& ar, ILLIXR::data_format::compressed_frame& f, const unsigned
 
 } // namespace boost::serialization
 
+// ---------------------------------------------------------------------------
+// Compact codecs (see illixr/network/compact.hpp)
+// ---------------------------------------------------------------------------
+namespace ILLIXR::network::compact {
+
+template<>
+struct fields<ILLIXR::data_format::rendered_frame> {
+    using type = ILLIXR::data_format::rendered_frame;
+
+    static constexpr auto members() {
+        return std::make_tuple(&type::swapchain_indices, &type::swap_indices, &type::render_pose, &type::sample_time,
+                               &type::render_time);
+    }
+};
+
+/**
+ * compressed_frame owns raw codec buffers, so it has a hand-written codec. The layout follows the Boost save/load above,
+ * except that each buffer is written as (int32 size, bytes) and motion vectors are always present when flagged.
+ */
+template<>
+struct codec<ILLIXR::data_format::compressed_frame> {
+    static constexpr bool supported = true;
+    using type                      = ILLIXR::data_format::compressed_frame;
+
+    static void write(writer& out, const type& f) {
+        compact::write(out, f.nalu_only);
+        compact::write(out, f.use_depth);
+        compact::write(out, f.use_motion_vectors);
+#ifdef ILLIXR_LIBAV
+        if (f.nalu_only) {
+            write_nalu(out, f.left_color->data, f.left_color->size);
+            write_nalu(out, f.right_color->data, f.right_color->size);
+            if (f.use_depth) {
+                write_nalu(out, f.left_depth->data, f.left_depth->size);
+                write_nalu(out, f.right_depth->data, f.right_depth->size);
+            }
+            if (f.use_motion_vectors) {
+                write_nalu(out, f.left_motion_vec->data, f.left_motion_vec->size);
+                write_nalu(out, f.right_motion_vec->data, f.right_motion_vec->size);
+            }
+        } else {
+#endif
+#if defined(ILLIXR_LIBAV) || defined(NVENC_ENCODER) || defined(NVDEC_DECODER)
+            write_packet(out, f.left_color);
+            write_packet(out, f.right_color);
+            if (f.use_depth) {
+                write_packet(out, f.left_depth);
+                write_packet(out, f.right_depth);
+            }
+            if (f.use_motion_vectors) {
+                write_packet(out, f.left_motion_vec);
+                write_packet(out, f.right_motion_vec);
+            }
+#endif
+#ifdef ILLIXR_LIBAV
+        }
+#endif
+        compact::write(out, f.pose);
+        compact::write(out, f.near_z);
+        compact::write(out, f.far_z);
+#ifdef USING_OPENXR
+        compact::write(out, f.fov_left);
+        compact::write(out, f.fov_right);
+        compact::write(out, f.fov_up);
+        compact::write(out, f.fov_down);
+#endif
+        compact::write(out, f.sent_time);
+        compact::write(out, f.frame_number);
+        compact::write(out, f.pose_id);
+        compact::write(out, f.encode_time);
+        compact::write(out, f.is_keyframe);
+        compact::write(out, f.magic);
+    }
+
+    static void read(reader& in, type& f) {
+        compact::read(in, f.nalu_only);
+        compact::read(in, f.use_depth);
+        compact::read(in, f.use_motion_vectors);
+        if (f.nalu_only) {
+            f.left_color_nalu  = read_nalu(in, f.left_color_nalu_size);
+            f.right_color_nalu = read_nalu(in, f.right_color_nalu_size);
+            if (f.use_depth) {
+                f.left_depth_nalu  = read_nalu(in, f.left_depth_nalu_size);
+                f.right_depth_nalu = read_nalu(in, f.right_depth_nalu_size);
+            }
+            if (f.use_motion_vectors) {
+                // compressed_frame has nowhere to keep NALU-only motion vectors; skip them
+                for (int i = 0; i < 2; ++i) {
+                    in.view(static_cast<std::size_t>(nalu_size(in)));
+                }
+            }
+        } else {
+#if defined(ILLIXR_LIBAV) || defined(NVENC_ENCODER) || defined(NVDEC_DECODER)
+            read_packet(in, f.left_color);
+            read_packet(in, f.right_color);
+            if (f.use_depth) {
+                read_packet(in, f.left_depth);
+                read_packet(in, f.right_depth);
+            }
+            if (f.use_motion_vectors) {
+                read_packet(in, f.left_motion_vec);
+                read_packet(in, f.right_motion_vec);
+            }
+#else
+            throw std::runtime_error("compressed_frame: packet payload received, but not compiled with libav or NVENC/NVDEC");
+#endif
+        }
+        compact::read(in, f.pose);
+        compact::read(in, f.near_z);
+        compact::read(in, f.far_z);
+#ifdef USING_OPENXR
+        compact::read(in, f.fov_left);
+        compact::read(in, f.fov_right);
+        compact::read(in, f.fov_up);
+        compact::read(in, f.fov_down);
+#endif
+        compact::read(in, f.sent_time);
+        compact::read(in, f.frame_number);
+        compact::read(in, f.pose_id);
+        compact::read(in, f.encode_time);
+        compact::read(in, f.is_keyframe);
+        compact::read(in, f.magic);
+        if (f.magic != 0xdeadbeef) {
+            throw std::runtime_error("compressed_frame: magic number mismatch");
+        }
+    }
+
+private:
+    static void write_nalu(writer& out, const void* data, int32_t size) {
+        out.scalar<int32_t>(size);
+        out.bytes(data, static_cast<std::size_t>(size));
+    }
+
+    static int32_t nalu_size(reader& in) {
+        auto size = in.scalar<int32_t>();
+        if (size < 0) {
+            throw std::runtime_error("compressed_frame: negative NALU size");
+        }
+        return size;
+    }
+
+    // The returned buffer is released by ~compressed_frame
+    static char* read_nalu(reader& in, int32_t& size) {
+        size       = nalu_size(in);
+        char* data = static_cast<char*>(malloc(static_cast<std::size_t>(size)));
+        in.bytes(data, static_cast<std::size_t>(size));
+        return data;
+    }
+
+#ifdef ILLIXR_LIBAV
+    static void write_packet(writer& out, const AVPacket* pkt) {
+        write_nalu(out, pkt->data, pkt->size);
+        compact::write(out, static_cast<int64_t>(pkt->pts));
+        compact::write(out, static_cast<int64_t>(pkt->dts));
+        compact::write(out, static_cast<int32_t>(pkt->stream_index));
+        compact::write(out, static_cast<int32_t>(pkt->flags));
+        compact::write(out, static_cast<int64_t>(pkt->duration));
+        compact::write(out, static_cast<int64_t>(pkt->pos));
+        compact::write(out, static_cast<int32_t>(pkt->time_base.num));
+        compact::write(out, static_cast<int32_t>(pkt->time_base.den));
+        compact::write(out, static_cast<int32_t>(pkt->side_data_elems));
+        for (int i = 0; i < pkt->side_data_elems; i++) {
+            compact::write(out, static_cast<int32_t>(pkt->side_data[i].type));
+            compact::write(out, static_cast<uint64_t>(pkt->side_data[i].size));
+            out.bytes(pkt->side_data[i].data, pkt->side_data[i].size);
+        }
+    }
+
+    static void read_packet(reader& in, AVPacket*& pkt) {
+        pkt             = av_packet_alloc();
+        const auto size = nalu_size(in);
+        pkt->buf        = av_buffer_alloc(size);
+        pkt->data       = pkt->buf->data;
+        pkt->size       = size;
+        in.bytes(pkt->data, static_cast<std::size_t>(size));
+        pkt->pts             = in.scalar<int64_t>();
+        pkt->dts             = in.scalar<int64_t>();
+        pkt->stream_index    = in.scalar<int32_t>();
+        pkt->flags           = in.scalar<int32_t>();
+        pkt->duration        = in.scalar<int64_t>();
+        pkt->pos             = in.scalar<int64_t>();
+        pkt->time_base.num   = in.scalar<int32_t>();
+        pkt->time_base.den   = in.scalar<int32_t>();
+        pkt->side_data_elems = in.scalar<int32_t>();
+        pkt->side_data       = (AVPacketSideData*) malloc(sizeof(AVPacketSideData) * pkt->side_data_elems);
+        for (int i = 0; i < pkt->side_data_elems; i++) {
+            pkt->side_data[i].type = static_cast<AVPacketSideDataType>(in.scalar<int32_t>());
+            pkt->side_data[i].size = static_cast<size_t>(in.scalar<uint64_t>());
+            pkt->side_data[i].data = (uint8_t*) malloc(pkt->side_data[i].size);
+            in.bytes(pkt->side_data[i].data, pkt->side_data[i].size);
+        }
+    }
+#elif defined(NVENC_ENCODER) || defined(NVDEC_DECODER)
+    static void write_packet(writer& out, const std::vector<uint8_t>& pkt) {
+        compact::write(out, pkt);
+    }
+
+    static void read_packet(reader& in, std::vector<uint8_t>& pkt) {
+        compact::read(in, pkt);
+    }
+#endif
+};
+
+} // namespace ILLIXR::network::compact
+
 BOOST_CLASS_EXPORT_KEY(ILLIXR::data_format::compressed_frame)
@@ -6,6 +6,20 @@
 
 namespace boost::serialization {
 
+#ifndef USING_OPENXR
+template<class Archive>
+[[maybe_unused]] void serialize(Archive& ar, ILLIXR::data_format::pose::head_pose_type& pose, const unsigned int version) {
+    (void) version;
+    ar& boost::serialization::base_object<ILLIXR::switchboard::event>(pose);
+    ar& static_cast<ILLIXR::data_format::pose::pose_base&>(pose);
+    ar & pose.sensor_time;
+    ar& boost::serialization::make_array(pose.linear_velocity.data(), pose.linear_velocity.size());
+    ar& boost::serialization::make_array(pose.angular_velocity.data(), pose.angular_velocity.size());
+    ar & pose.linear_velocity_valid;
+    ar & pose.angular_velocity_valid;
+}
+#endif
+
 template<class Archive>
 [[maybe_unused]] void serialize(Archive& ar, ILLIXR::data_format::pose::fast_head_pose_type& pose, const unsigned int version) {
     (void) version;
@@ -17,5 +31,29 @@ template<class Archive>
 
 } // namespace boost::serialization
 
+namespace ILLIXR::network::compact {
+#ifndef USING_OPENXR
+template<>
+struct fields<ILLIXR::data_format::pose::head_pose_type> {
+    using type = ILLIXR::data_format::pose::head_pose_type;
+
+    static constexpr auto members() {
+        return std::make_tuple(&type::position, &type::orientation, &type::confidence, &type::valid, &type::sensor_time,
+                               &type::linear_velocity, &type::angular_velocity, &type::linear_velocity_valid,
+                               &type::angular_velocity_valid);
+    }
+};
+#endif
+
+template<>
+struct fields<ILLIXR::data_format::pose::fast_head_pose_type> {
+    using type = ILLIXR::data_format::pose::fast_head_pose_type;
+
+    static constexpr auto members() {
+        return std::make_tuple(&type::pose, &type::predict_computed_time, &type::predict_target_time);
+    }
+};
+} // namespace ILLIXR::network::compact
+
 BOOST_CLASS_EXPORT_KEY(ILLIXR::data_format::pose::head_pose_type)
 BOOST_CLASS_EXPORT_KEY(ILLIXR::data_format::pose::fast_head_pose_type)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "illixr/network/compact.hpp"
 #include "illixr/relative_clock.hpp"
 #include "illixr/switchboard.hpp"
 
@@ -71,4 +72,36 @@ void serialize(Archive& ar, POSE_DATA_TYPE& pose, const unsigned int version) {
 #endif
 } // namespace boost::serialization
 
+namespace ILLIXR::network::compact {
+template<>
+struct fields<ILLIXR::time_point> {
+    static constexpr auto members() {
+        return std::make_tuple(&ILLIXR::time_point::time_since_epoch_);
+    }
+};
+
+#ifdef USING_OPENXR
+template<>
+struct fields<QUATERNION_TYPE> {
+    static constexpr auto members() {
+        return std::make_tuple(&QUATERNION_TYPE::x, &QUATERNION_TYPE::y, &QUATERNION_TYPE::z, &QUATERNION_TYPE::w);
+    }
+};
+
+template<>
+struct fields<THREE_VECTOR_TYPE> {
+    static constexpr auto members() {
+        return std::make_tuple(&THREE_VECTOR_TYPE::x, &THREE_VECTOR_TYPE::y, &THREE_VECTOR_TYPE::z);
+    }
+};
+
+template<>
+struct fields<POSE_DATA_TYPE> {
+    static constexpr auto members() {
+        return std::make_tuple(&POSE_DATA_TYPE::position, &POSE_DATA_TYPE::orientation);
+    }
+};
+#endif
+} // namespace ILLIXR::network::compact
+
 BOOST_CLASS_EXPORT_KEY(ILLIXR::switchboard::event)
@@ -27,3 +27,24 @@ void serialize(Archive& ar, ILLIXR::data_format::pose::pose_base& pose, const un
 #endif
 
 } // namespace boost::serialization
+
+namespace ILLIXR::network::compact {
+#ifdef USING_OPENXR
+template<>
+struct fields<POSE_BASE_TYPE> {
+    static constexpr auto members() {
+        return std::make_tuple(&POSE_BASE_TYPE::pose, &POSE_BASE_TYPE::linear_velocity, &POSE_BASE_TYPE::angular_velocity,
+                               &POSE_BASE_TYPE::relation_flags);
+    }
+};
+#else
+template<>
+struct fields<ILLIXR::data_format::pose::pose_base> {
+    using type = ILLIXR::data_format::pose::pose_base;
+
+    static constexpr auto members() {
+        return std::make_tuple(&type::position, &type::orientation, &type::confidence, &type::valid);
+    }
+};
+#endif
+} // namespace ILLIXR::network::compact
@@ -1,22 +1,29 @@
 #pragma once
 
 #include "illixr/data_format/misc.hpp"
+#include "illixr/dataset_loader.hpp"
 #include "illixr/error_util.hpp"
+#include "illixr/iterators/csv_iterator.hpp"
 #include "illixr/switchboard.hpp"
 
 #include <eigen3/Eigen/Dense>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <spdlog/spdlog.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace ILLIXR;
 
-template<typename T>
-static std::map<ullong, T> load_data(const std::string& spath, const std::string& plugin_name,
-                                     std::map<ullong, T> (*func)(std::ifstream&, const std::string&),
-                                     const std::shared_ptr<switchboard>& sb, const std::string& file_name = "data.csv") {
+/**
+ * @brief The path of a dataset file, $ILLIXR_DATA/spath/file_name; aborts if ILLIXR_DATA is not set or the file cannot be
+ * opened.
+ */
+static std::string dataset_path(const std::string& spath, const std::string& plugin_name,
+                                const std::shared_ptr<switchboard>& sb, const std::string& file_name = "data.csv") {
     const char* illixr_data_c_str = sb->get_env_char("ILLIXR_DATA");
     if (!illixr_data_c_str) {
         ILLIXR::abort("Please define ILLIXR_DATA");
@@ -24,12 +31,38 @@ static std::map<ullong, T> load_data(const std::string& spath, const std::string
     const std::string subpath     = "/" + spath + "/" + file_name;
     std::string       illixr_data = std::string{illixr_data_c_str};
 
-    std::ifstream gt_file{illixr_data + subpath};
-
-    if (!gt_file.good()) {
+    if (!std::ifstream{illixr_data + subpath}.good()) {
         spdlog::get("illixr")->error("[{0}] $ILLIXR_DATA{1} ({2}{1}) is not a good path", plugin_name, subpath, illixr_data);
         ILLIXR::abort();
     }
+    return illixr_data + subpath;
+}
 
-    return func(gt_file, illixr_data + subpath);
+template<typename T>
+static std::map<ullong, T> load_data(const std::string& spath, const std::string& plugin_name,
+                                     std::map<ullong, T> (*func)(std::ifstream&, const std::string&),
+                                     const std::shared_ptr<switchboard>& sb, const std::string& file_name = "data.csv") {
+    const std::string path = dataset_path(spath, plugin_name, sb, file_name);
+    std::ifstream     gt_file{path};
+    return func(gt_file, path);
+}
+
+/**
+ * @brief A dataset_stream source reading the CSV file at @p path, after a header of @p skip lines.
+ *
+ * @p parse_row turns a row of the file into the row of the stream, (timestamp, value); it is called on the stream's
+ * loading thread.
+ */
+template<typename T>
+static typename dataset_stream<T>::source csv_dataset_source(const std::string& path, std::size_t skip,
+                                                             std::pair<ullong, T> (*parse_row)(const data_row&,
+                                                                                               const std::string&)) {
+    auto file = std::make_shared<std::ifstream>(path);
+    auto row  = std::make_shared<csv_iterator>(*file, skip);
+    return [file, row, path, parse_row](std::vector<std::pair<ullong, T>>& rows, std::size_t max_rows) {
+        for (; *row != csv_iterator{} && rows.size() < max_rows; ++*row) {
+            rows.push_back(parse_row(**row, path));
+        }
+        return *row != csv_iterator{};
+    };
 }
@@ -0,0 +1,383 @@
+#pragma once
+
+#include "data_format/misc.hpp"
+#include "phonebook.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ILLIXR {
+
+class dataset_loader;
+template<typename T>
+class dataset_stream;
+
+/**
+ * @brief The untyped state of a dataset_stream, which the dataset_loader reports on and budgets.
+ */
+class dataset_stream_base {
+public:
+    dataset_stream_base(const dataset_stream_base&)            = delete;
+    dataset_stream_base& operator=(const dataset_stream_base&) = delete;
+
+    [[nodiscard]] const std::string& name() const {
+        return name_;
+    }
+
+    /// Whether the stream is fully loaded, or holds as much as the memory budget allows and streams in the rest
+    [[nodiscard]] bool ready() const {
+        return ready_.load();
+    }
+
+    /// Whether every row has been loaded (some may have been released since)
+    [[nodiscard]] bool complete() const {
+        return complete_.load();
+    }
+
+    [[nodiscard]] std::size_t rows_loaded() const {
+        return rows_loaded_.load();
+    }
+
+    /// Approximate memory held by the loaded rows that have not been released
+    [[nodiscard]] std::size_t bytes_held() const {
+        return bytes_held_.load();
+    }
+
+    /// Time from opening the stream until it became ready (while loading, until now)
+    [[nodiscard]] std::chrono::duration<double> load_time() const {
+        using clock    = std::chrono::steady_clock;
+        const auto end = ready() ? clock::time_point{clock::duration{ready_time_.load()}} : clock::now();
+        return end - open_time_;
+    }
+
+protected:
+    inline dataset_stream_base(std::shared_ptr<dataset_loader> loader, std::string name, bool resident);
+    inline ~dataset_stream_base();
+
+    // Called by the loading thread
+    inline void mark_ready();
+    inline void mark_complete();
+
+    const std::shared_ptr<dataset_loader> loader_;
+    const std::string                     name_;
+    const bool                            resident_; ///< Exempt from the memory budget
+    std::atomic<bool>                     stop_{false};
+
+    std::atomic<bool>                                      ready_{false};
+    std::atomic<bool>                                      complete_{false};
+    std::atomic<std::size_t>                               rows_loaded_{0};
+    std::atomic<std::size_t>                               bytes_held_{0};
+    const std::chrono::steady_clock::time_point            open_time_{std::chrono::steady_clock::now()};
+    std::atomic<std::chrono::steady_clock::time_point::rep> ready_time_{0};
+
+    friend class dataset_loader;
+};
+
+/**
+ * @brief Loads the datasets of the offline plugins (offline_imu, offline_cam, ground_truth_slam, pose_lookup) in the
+ * background, each stream on its own thread, within a shared memory budget.
+ *
+ * A plugin opens its streams in its constructor, which returns at once, and reads the rows once the plugins start. The
+ * runtime calls wait_ready() after constructing every plugin and before starting the clock, so all datasets load at the
+ * same time, and alongside the other plugins' constructors, instead of one after another. wait_ready() then logs the
+ * load time of each stream.
+ *
+ * When the budget (ILLIXR_DATASET_MEMORY_BUDGET, in MiB; 0, the default, for none) is exceeded, a stream stops loading
+ * and counts as ready; it loads more as its reader releases the rows it is done with. Every stream may exceed the budget
+ * by one batch of rows, so that none of them starves. Resident streams (for readers that need random access) are always
+ * loaded completely and count towards the budget without being held to it.
+ */
+class dataset_loader
+    : public phonebook::service
+    , public std::enable_shared_from_this<dataset_loader> {
+public:
+    explicit dataset_loader(std::size_t memory_budget = 0)
+        : memory_budget_{memory_budget} { }
+
+    /// Sets the budget, in bytes, for the streams opened from now on and for the loading still to be done
+    void set_memory_budget(std::size_t memory_budget) {
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            memory_budget_ = memory_budget;
+        }
+        changed_.notify_all();
+    }
+
+    /**
+     * @brief Starts loading a stream in the background.
+     *
+     * @param name Name of the stream in the log, e.g. "offline_imu/imu0"
+     * @param source Reads the next rows; called on the stream's own thread
+     * @param size Memory held by a value beyond the row itself, if any
+     * @param resident Whether the reader needs every row at once (see dataset_stream::all())
+     */
+    template<typename T>
+    std::shared_ptr<dataset_stream<T>> open(std::string name, typename dataset_stream<T>::source source,
+                                            typename dataset_stream<T>::size_function size = nullptr, bool resident = false) {
+        return std::make_shared<dataset_stream<T>>(shared_from_this(), std::move(name), std::move(source), std::move(size),
+                                                   resident);
+    }
+
+    /**
+     * @brief Blocks until every open stream is ready, then logs how long each one took to load.
+     */
+    void wait_ready() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        changed_.wait(lock, [this] {
+            for (const dataset_stream_base* stream : streams_) {
+                if (!stream->ready()) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        for (const dataset_stream_base* stream : streams_) {
+            spdlog::get("illixr")->info("[dataset_loader] {}: {} rows, {:.1f} MiB in {:.3f} s{}", stream->name(),
+                                        stream->rows_loaded(), static_cast<double>(stream->bytes_held()) / (1 << 20),
+                                        stream->load_time().count(),
+                                        stream->complete() ? "" : "; streaming the rest within the memory budget");
+        }
+    }
+
+    /// Approximate memory held by all open streams
+    [[nodiscard]] std::size_t bytes_held() const {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        return bytes_held_;
+    }
+
+private:
+    friend class dataset_stream_base;
+    template<typename T>
+    friend class dataset_stream;
+
+    void add(dataset_stream_base* stream) {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        streams_.insert(stream);
+    }
+
+    void remove(dataset_stream_base* stream) {
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            streams_.erase(stream);
+            bytes_held_ -= stream->bytes_held();
+        }
+        changed_.notify_all();
+    }
+
+    /**
+     * @brief Takes @p bytes of the budget for @p stream, first waiting for room if the stream already holds rows. While
+     * it waits, the stream is ready. Returns false if the stream is being closed.
+     */
+    bool acquire(dataset_stream_base& stream, std::size_t bytes) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        const auto                   fits = [&] {
+            return stream.stop_.load() || stream.resident_ || memory_budget_ == 0 || stream.bytes_held() == 0 ||
+                bytes_held_ + bytes <= memory_budget_;
+        };
+        if (!fits()) {
+            lock.unlock();
+            stream.mark_ready();
+            lock.lock();
+            changed_.wait(lock, fits);
+        }
+        if (stream.stop_.load()) {
+            return false;
+        }
+        bytes_held_ += bytes;
+        return true;
+    }
+
+    void release(std::size_t bytes) {
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            bytes_held_ -= bytes;
+        }
+        changed_.notify_all();
+    }
+
+    void notify() {
+        // Taking the lock orders the change before the waiters' next check
+        { const std::lock_guard<std::mutex> lock{mutex_}; }
+        changed_.notify_all();
+    }
+
+    mutable std::mutex             mutex_;
+    std::condition_variable        changed_;
+    std::set<dataset_stream_base*> streams_;
+    std::size_t                    memory_budget_;
+    std::size_t                    bytes_held_ = 0;
+};
+
+dataset_stream_base::dataset_stream_base(std::shared_ptr<dataset_loader> loader, std::string name, bool resident)
+    : loader_{std::move(loader)}
+    , name_{std::move(name)}
+    , resident_{resident} {
+    loader_->add(this);
+}
+
+dataset_stream_base::~dataset_stream_base() {
+    loader_->remove(this);
+}
+
+void dataset_stream_base::mark_ready() {
+    if (!ready_.exchange(true)) {
+        ready_time_ = std::chrono::steady_clock::now().time_since_epoch().count();
+        loader_->notify();
+    }
+}
+
+void dataset_stream_base::mark_complete() {
+    complete_ = true;
+    mark_ready();
+    spdlog::get("illixr")->debug("[dataset_loader] {}: loaded {} rows in {:.3f} s", name_, rows_loaded_.load(),
+                                 std::chrono::duration<double>{std::chrono::steady_clock::now() - open_time_}.count());
+}
+
+/**
+ * @brief Rows of one dataset file, (timestamp, value) in file order, loaded by a background thread.
+ *
+ * The reader walks the rows by index with at(), which blocks until the row is loaded, and gives back the rows it is done
+ * with through release_before(). Rows stay in place while they are held, so the pointers at() returns stay valid until
+ * then.
+ *
+ * \code{.cpp}
+ * // constructor
+ * imu_ = phonebook_->lookup_impl<dataset_loader>()->open<imu_row>("imu0", csv_dataset_source<imu_row>(path, &parse_row));
+ * // later, once the plugins have started
+ * for (std::size_t i = 0; const auto* row = imu_->at(i); imu_->release_before(++i)) { ... }
+ * \endcode
+ */
+template<typename T>
+class dataset_stream : public dataset_stream_base {
+public:
+    using row = std::pair<ullong, T>;
+    /// Appends up to the given number of rows; returns false once there are no more
+    using source = std::function<bool(std::vector<row>&, std::size_t)>;
+    /// Memory held by a value beyond sizeof(row), e.g. the pixels of an image
+    using size_function = std::function<std::size_t(const T&)>;
+
+    /// Rows read from the source between checks of the memory budget
+    static constexpr std::size_t batch_rows = 256;
+
+    dataset_stream(std::shared_ptr<dataset_loader> loader, std::string name, source source, size_function size, bool resident)
+        : dataset_stream_base{std::move(loader), std::move(name), resident}
+        , source_{std::move(source)}
+        , size_{std::move(size)}
+        , thread_{[this] {
+            load();
+        }} { }
+
+    ~dataset_stream() {
+        stop_ = true;
+        loader_->notify();
+        thread_.join();
+    }
+
+    /**
+     * @brief The row at @p index, waiting for it to be loaded; nullptr past the last row. @p index must not have been
+     * released.
+     */
+    const row* at(std::size_t index) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        loaded_.wait(lock, [&] {
+            return index < first_index_ + rows_.size() || complete();
+        });
+        assert(index >= first_index_ && "dataset_stream: row already released");
+        if (index >= first_index_ + rows_.size()) {
+            return nullptr;
+        }
+        return &rows_[index - first_index_];
+    }
+
+    /**
+     * @brief Drops the rows before @p index, making room in the memory budget for the rows after the loaded ones.
+     */
+    void release_before(std::size_t index) {
+        std::size_t released = 0;
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            while (first_index_ < index && !rows_.empty()) {
+                released += row_bytes(rows_.front());
+                rows_.pop_front();
+                ++first_index_;
+            }
+        }
+        if (released > 0) {
+            bytes_held_ -= released;
+            loader_->release(released);
+        }
+    }
+
+    /**
+     * @brief Every row, waiting for the whole stream to load. Only for streams opened as resident, whose rows are never
+     * released.
+     */
+    const std::deque<row>& all() {
+        assert(resident_ && "dataset_stream: all() needs a resident stream");
+        std::unique_lock<std::mutex> lock{mutex_};
+        loaded_.wait(lock, [this] {
+            return complete();
+        });
+        return rows_;
+    }
+
+private:
+    std::size_t row_bytes(const row& r) const {
+        return sizeof(row) + (size_ ? size_(r.second) : 0);
+    }
+
+    void load() {
+        std::vector<row> batch;
+        bool             more = true;
+        while (more && !stop_) {
+            batch.clear();
+            more = source_(batch, batch_rows);
+
+            std::size_t bytes = 0;
+            for (const row& r : batch) {
+                bytes += row_bytes(r);
+            }
+            if (!loader_->acquire(*this, bytes)) {
+                break;
+            }
+            {
+                const std::lock_guard<std::mutex> lock{mutex_};
+                std::move(batch.begin(), batch.end(), std::back_inserter(rows_));
+                bytes_held_  += bytes;
+                rows_loaded_ += batch.size();
+            }
+            loaded_.notify_all();
+        }
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            mark_complete();
+        }
+        loaded_.notify_all();
+    }
+
+    source        source_;
+    size_function size_;
+
+    std::mutex              mutex_;
+    std::condition_variable loaded_;
+    std::deque<row>         rows_;
+    std::size_t             first_index_ = 0; ///< Index of rows_.front() in the file
+
+    std::thread thread_; ///< Last, so that it starts after everything it uses
+};
+
+} // namespace ILLIXR
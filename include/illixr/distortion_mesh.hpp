@@ -0,0 +1,70 @@
+#pragma once
+
+#include "illixr/hmd.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ILLIXR {
+
+/**
+ * @brief The lens distortion mesh shared by the warp plugins, built on the CPU.
+ *
+ * Each eye is a regular grid of (eye_tiles_wide + 1) x (eye_tiles_high + 1) vertices. The positions are the undistorted
+ * grid in NDC; the distortion lives in the per-channel UVs, which are the tangent-angle coefficients that
+ * HMD::build_distortion_meshes computes (the warp shaders turn them into texture coordinates). Both eyes share one index
+ * list. Vertex i of eye e is at e * vertices_per_eye + i in positions and in each uv array.
+ *
+ * build() evaluates the spline for a whole row at a time with branch-free loops the compiler can vectorize, and splits
+ * the rows across threads when the mesh is large enough for that to pay off. load() additionally keeps the result in an
+ * on-disk cache keyed by every hmd_info_t field that affects the mesh, so restarts with the same display skip the build.
+ */
+struct distortion_mesh {
+    int                                                               vertices_per_eye = 0;
+    std::vector<std::uint32_t>                                        indices;
+    std::vector<HMD::mesh_coord3d_t>                                  positions;
+    std::array<std::vector<HMD::uv_coord_t>, HMD::NUM_COLOR_CHANNELS> uv;
+
+    /**
+     * @brief Builds the mesh for @p hmd_info.
+     *
+     * @param compare_images Output the undistorted tangent angles instead (ILLIXR_COMPARE_IMAGES)
+     * @param thread_count Worker threads to use; 0 picks one per core for large meshes and a single thread otherwise
+     */
+    static distortion_mesh build(const HMD::hmd_info_t& hmd_info, bool compare_images, unsigned thread_count = 0);
+
+    /**
+     * @brief Returns the cached mesh for @p hmd_info from @p cache_dir, building and caching it if there is none.
+     *
+     * An empty @p cache_dir disables the cache. Cache files that cannot be read or written are logged and otherwise
+     * ignored, so the cache never stops a plugin from starting. ILLIXR_COMPARE_IMAGES is honoured as in
+     * HMD::build_distortion_meshes.
+     */
+    static distortion_mesh load(const HMD::hmd_info_t& hmd_info, const std::string& cache_dir);
+
+    /**
+     * @brief The cache directory used when ILLIXR_DISTORTION_CACHE is not set: $XDG_CACHE_HOME/illixr, or
+     * $HOME/.cache/illixr. Empty if neither variable is set.
+     */
+    static std::string default_cache_dir();
+
+    /**
+     * @brief The file name load() uses for @p hmd_info, a hash of the fields that affect the mesh.
+     */
+    static std::string cache_file_name(const HMD::hmd_info_t& hmd_info, bool compare_images);
+
+    /**
+     * @brief Writes the mesh to @p path, atomically replacing any existing file. Returns false on failure.
+     */
+    bool save(const std::string& path, const HMD::hmd_info_t& hmd_info, bool compare_images) const;
+
+    /**
+     * @brief Reads a mesh written by save() for the same @p hmd_info. Returns false if the file is missing, truncated,
+     * or was written for different parameters.
+     */
+    bool read(const std::string& path, const HMD::hmd_info_t& hmd_info, bool compare_images);
+};
+
+} // namespace ILLIXR
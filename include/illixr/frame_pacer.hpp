@@ -0,0 +1,250 @@
+#pragma once
+
+#include "relative_clock.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace ILLIXR {
+
+/**
+ * @brief Estimates the display's vsync period and phase from the observed buffer swaps, learns how long before a vsync
+ * the warp has to wake up, and picks wakeup deadlines that meet a target miss rate.
+ *
+ * The vsync model is a line through the recent swap times, t = phase + k * period, where k counts vsyncs. Each swap's
+ * vsync number is the previous one plus the interval between them in units of the shortest typical interval (the 10th
+ * percentile), so missed frames just skip numbers and the estimate does not lock onto a multiple of the period as long
+ * as some frames make consecutive vsyncs. The line is then fit with the Theil-Sen estimator: the period is the median
+ * of the slopes between all pairs of swaps and the phase the median of the intercepts. Up to half of the swaps can be
+ * arbitrarily late (a preempted thread, a compositor hiccup) without moving the estimate.
+ *
+ * The lead is the time from the start of the warp's work, i.e. the deadline it slept towards, to the point it hands its
+ * frame to the swap. It includes the scheduler's wakeup latency and the warp's own cost. The deadline for a
+ * vsync is that vsync minus the (1 - target miss rate) quantile of the recent leads, plus a safety margin.
+ *
+ * The pacer only does arithmetic on the times it is given, so it can be driven by a recorded swap-time trace as well as
+ * by the live display (see benchmarks/frame_pacer.cpp).
+ *
+ * \code{.cpp}
+ * // _p_should_skip()
+ * return skip_for(pacer_.plan_wakeup(clock_->now()) - clock_->now());
+ * // after the warp
+ * pacer_.record_work_done(clock_->now());
+ * swap_buffers();
+ * pacer_.record_swap(clock_->now());
+ * \endcode
+ */
+class frame_pacer {
+public:
+    /**
+     * @param nominal_period The display period to assume until enough swaps have been seen
+     * @param target_miss_rate Fraction of frames allowed to miss their vsync for the warp being too late
+     * @param safety_margin Added to the learned lead
+     */
+    explicit frame_pacer(duration nominal_period, double target_miss_rate = 0.01,
+                         duration safety_margin = std::chrono::microseconds{500})
+        : nominal_period_{nominal_period}
+        , target_miss_rate_{std::clamp(target_miss_rate, 0.0, 1.0)}
+        , safety_margin_{safety_margin}
+        , period_{nominal_period} { }
+
+    /**
+     * @brief Adds the time a buffer swap completed, refits the vsync model, and counts a miss if the frame planned by the
+     * last plan_wakeup() was shown a vsync or more late.
+     */
+    void record_swap(time_point swap_time) {
+        swaps_.push_back(swap_time);
+        if (swaps_.size() > swap_history) {
+            swaps_.pop_front();
+        }
+        fit();
+
+        if (planned_) {
+            planned_ = false;
+            ++frames_;
+            if (swap_time - planned_vsync_ > period_ / 2) {
+                ++missed_frames_;
+            }
+        }
+    }
+
+    /**
+     * @brief Adds the time the planned frame's work finished (just before the swap), as a sample of the lead.
+     */
+    void record_work_done(time_point done_time) {
+        if (!planned_) {
+            return;
+        }
+        leads_.push_back(done_time - work_start_);
+        if (leads_.size() > lead_history) {
+            leads_.pop_front();
+        }
+        lead_ = learned_lead();
+    }
+
+    /**
+     * @brief Picks the first vsync the next frame can still make with the learned lead, and returns the time to wake up
+     * for it, which is never before @p now. Before the first swap the vsyncs are unknown, and the work starts at once.
+     */
+    time_point plan_wakeup(time_point now) {
+        if (swaps_.empty()) {
+            return now;
+        }
+        planned_vsync_ = next_vsync(now + lead_);
+        work_start_    = std::max(planned_vsync_ + (-lead_), now);
+        planned_       = true;
+        return work_start_;
+    }
+
+    /**
+     * @brief The first vsync at or after @p time, according to the fitted model; until a swap is seen, @p time plus the
+     * nominal period.
+     */
+    [[nodiscard]] time_point next_vsync(time_point time) const {
+        if (swaps_.empty()) {
+            return time + nominal_period_;
+        }
+        const double periods = std::ceil(static_cast<double>((time - phase_).count()) / static_cast<double>(period_.count()));
+        return phase_ + duration{static_cast<duration::rep>(std::llround(periods * static_cast<double>(period_.count())))};
+    }
+
+    /// The estimated display period
+    [[nodiscard]] duration period() const {
+        return period_;
+    }
+
+    /// The time of one vsync according to the fit; the others are whole periods away from it
+    [[nodiscard]] time_point phase() const {
+        return phase_;
+    }
+
+    /// How long before a vsync plan_wakeup() wakes up, including the safety margin
+    [[nodiscard]] duration lead() const {
+        return lead_;
+    }
+
+    /// Median distance of the recent swaps from the fitted vsyncs
+    [[nodiscard]] duration jitter() const {
+        return jitter_;
+    }
+
+    /// Planned frames seen by record_swap()
+    [[nodiscard]] std::size_t frames() const {
+        return frames_;
+    }
+
+    /// Planned frames that were shown at least one vsync after the one they were planned for
+    [[nodiscard]] std::size_t missed_frames() const {
+        return missed_frames_;
+    }
+
+    static constexpr std::size_t swap_history = 64;
+    static constexpr std::size_t lead_history = 256;
+
+    /// Leads seen before the learned quantile replaces the initial guess
+    static constexpr std::size_t min_lead_samples = 16;
+
+private:
+    template<typename T>
+    static T median(std::vector<T>& values) {
+        auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+
+    void fit() {
+        const time_point origin = swaps_.front();
+        if (swaps_.size() < 3) {
+            phase_ = swaps_.back();
+            return;
+        }
+
+        // Number the vsyncs from interval to interval, so that the rounding error of the interval does not add up
+        std::vector<double> offsets(swaps_.size());
+        std::vector<double> intervals(swaps_.size() - 1);
+        for (std::size_t i = 0; i < swaps_.size(); ++i) {
+            offsets[i] = static_cast<double>((swaps_[i] - origin).count());
+            if (i > 0) {
+                intervals[i - 1] = offsets[i] - offsets[i - 1];
+            }
+        }
+        auto tenth = intervals.begin() + static_cast<std::ptrdiff_t>(intervals.size() / 10);
+        std::nth_element(intervals.begin(), tenth, intervals.end());
+        const double index_period = *tenth;
+        if (index_period <= 0.0) {
+            return;
+        }
+        std::vector<double> indices(offsets.size(), 0.0);
+        for (std::size_t i = 1; i < offsets.size(); ++i) {
+            indices[i] = indices[i - 1] + std::max(1.0, std::round((offsets[i] - offsets[i - 1]) / index_period));
+        }
+
+        slopes_.clear();
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            for (std::size_t j = i + 1; j < offsets.size(); ++j) {
+                if (indices[j] != indices[i]) {
+                    slopes_.push_back((offsets[j] - offsets[i]) / (indices[j] - indices[i]));
+                }
+            }
+        }
+        if (slopes_.empty()) {
+            return;
+        }
+        const double slope = median(slopes_);
+
+        std::vector<double> intercepts(offsets.size());
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            intercepts[i] = offsets[i] - slope * indices[i];
+        }
+        const double intercept = median(intercepts);
+
+        std::vector<double> residuals(offsets.size());
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            residuals[i] = std::abs(offsets[i] - intercept - slope * indices[i]);
+        }
+
+        period_ = duration{static_cast<duration::rep>(std::llround(slope))};
+        phase_  = origin + duration{static_cast<duration::rep>(std::llround(intercept))};
+        jitter_ = duration{static_cast<duration::rep>(std::llround(median(residuals)))};
+        if (leads_.size() < min_lead_samples) {
+            lead_ = learned_lead();
+        }
+    }
+
+    [[nodiscard]] duration learned_lead() const {
+        // Until there are enough samples, wake up a tenth of a period early, as timewarp_gl used to
+        if (leads_.size() < min_lead_samples) {
+            return period_ / 10 + safety_margin_;
+        }
+        std::vector<duration> sorted(leads_.begin(), leads_.end());
+        const auto rank = static_cast<std::size_t>(std::ceil((1.0 - target_miss_rate_) * static_cast<double>(sorted.size())));
+        auto       kth  = sorted.begin() + static_cast<std::ptrdiff_t>(std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0));
+        std::nth_element(sorted.begin(), kth, sorted.end());
+        // Never plan to wake up more than a period early; the frame would then be aimed at the vsync after
+        return std::min(*kth + safety_margin_, period_);
+    }
+
+    const duration nominal_period_;
+    const double   target_miss_rate_;
+    const duration safety_margin_;
+
+    std::deque<time_point> swaps_;
+    std::deque<duration>   leads_;
+    std::vector<double>    slopes_;
+
+    duration   period_;
+    time_point phase_{};
+    duration   jitter_{};
+    duration   lead_{nominal_period_ / 10 + safety_margin_};
+
+    bool        planned_ = false;
+    time_point  planned_vsync_{};
+    time_point  work_start_{};
+    std::size_t frames_        = 0;
+    std::size_t missed_frames_ = 0;
+};
+
+} // namespace ILLIXR
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<Eigen/Core>)
+    #include <Eigen/Core>
+    #include <Eigen/Geometry>
+#else
+    #include <eigen3/Eigen/Core>
+    #include <eigen3/Eigen/Geometry>
+#endif
+
+/**
+ * @file compact.hpp
+ * @brief Schema-based binary serialization for switchboard events.
+ *
+ * The compact format is a fixed, little-endian layout derived at compile time from a per-type field list. Unlike the
+ * Boost archives it carries no class names, versions or tracking information, and involves no virtual dispatch: the
+ * receiver must already know which type is on the topic (the switchboard does). It is selected per topic with
+ * `topic_config::SerializationMethod::COMPACT`, and the topic's codec is registered with
+ * `switchboard::register_compact_codec()`.
+ *
+ * A type is made serializable by listing its members:
+ *
+ * \code{.cpp}
+ * template<>
+ * struct ILLIXR::network::compact::fields<my_event> {
+ *     static constexpr auto members() {
+ *         return std::make_tuple(&my_event::timestamp, &my_event::position);
+ *     }
+ * };
+ * \endcode
+ *
+ * Members are encoded in the listed order. Members of base classes may be listed directly. Types whose layout cannot be
+ * described by a member list (e.g. ones holding raw buffers) specialize `codec` instead.
+ */
+namespace ILLIXR::network::compact {
+
+/**
+ * @brief Appends little-endian values to a byte buffer.
+ */
+class writer {
+public:
+    explicit writer(std::vector<char>& out)
+        : out_{out} { }
+
+    void bytes(const void* data, std::size_t size) {
+        const char* begin = static_cast<const char*>(data);
+        out_.insert(out_.end(), begin, begin + size);
+    }
+
+    template<typename T>
+    void scalar(T value) {
+        static_assert(std::is_arithmetic_v<T>, "compact::writer::scalar requires an arithmetic type");
+        char raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::reverse(raw, raw + sizeof(T));
+#endif
+        bytes(raw, sizeof(T));
+    }
+
+    void reserve(std::size_t size) {
+        out_.reserve(out_.size() + size);
+    }
+
+private:
+    std::vector<char>& out_;
+};
+
+/**
+ * @brief Reads little-endian values from a byte buffer.
+ *
+ * @throws std::runtime_error if a read runs past the end of the buffer.
+ */
+class reader {
+public:
+    reader(const char* data, std::size_t size)
+        : data_{data}
+        , remaining_{size} { }
+
+    /**
+     * @brief Returns a pointer to the next @p size bytes and skips past them.
+     */
+    const char* view(std::size_t size) {
+        if (size > remaining_) {
+            throw std::runtime_error("[compact] message truncated: needed " + std::to_string(size) + " bytes, have " +
+                                     std::to_string(remaining_));
+        }
+        const char* at = data_;
+        data_ += size;
+        remaining_ -= size;
+        return at;
+    }
+
+    void bytes(void* dst, std::size_t size) {
+        std::memcpy(dst, view(size), size);
+    }
+
+    template<typename T>
+    T scalar() {
+        static_assert(std::is_arithmetic_v<T>, "compact::reader::scalar requires an arithmetic type");
+        char raw[sizeof(T)];
+        bytes(raw, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::reverse(raw, raw + sizeof(T));
+#endif
+        T value;
+        std::memcpy(&value, raw, sizeof(T));
+        return value;
+    }
+
+    [[nodiscard]] std::size_t remaining() const {
+        return remaining_;
+    }
+
+private:
+    const char* data_;
+    std::size_t remaining_;
+};
+
+/**
+ * @brief Member list of a struct, in wire order. Specialize with a static `members()` returning a tuple of member
+ * pointers.
+ */
+template<typename T>
+struct fields;
+
+/**
+ * @brief Encoder/decoder for a single type. `supported` is false for types with no compact representation.
+ */
+template<typename T, typename Enable = void>
+struct codec {
+    static constexpr bool supported = false;
+};
+
+template<typename T>
+inline constexpr bool is_serializable_v = codec<T>::supported;
+
+template<typename T>
+void write(writer& out, const T& value) {
+    codec<T>::write(out, value);
+}
+
+template<typename T>
+void read(reader& in, T& value) {
+    codec<T>::read(in, value);
+}
+
+// bool is written as one byte, regardless of sizeof(bool)
+template<>
+struct codec<bool> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, bool value) {
+        out.scalar<std::uint8_t>(value ? 1 : 0);
+    }
+
+    static void read(reader& in, bool& value) {
+        value = in.scalar<std::uint8_t>() != 0;
+    }
+};
+
+template<typename T>
+struct codec<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, T value) {
+        out.scalar<T>(value);
+    }
+
+    static void read(reader& in, T& value) {
+        value = in.scalar<T>();
+    }
+};
+
+// Enums are written as their underlying type
+template<typename T>
+struct codec<T, std::enable_if_t<std::is_enum_v<T>>> {
+    static constexpr bool supported = true;
+    using underlying                = std::underlying_type_t<T>;
+
+    static void write(writer& out, T value) {
+        out.scalar<underlying>(static_cast<underlying>(value));
+    }
+
+    static void read(reader& in, T& value) {
+        value = static_cast<T>(in.scalar<underlying>());
+    }
+};
+
+// Durations are written as int64 nanoseconds, so that both ends agree regardless of the local representation
+template<typename Rep, typename Period>
+struct codec<std::chrono::duration<Rep, Period>> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, const std::chrono::duration<Rep, Period>& value) {
+        out.scalar<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(value).count());
+    }
+
+    static void read(reader& in, std::chrono::duration<Rep, Period>& value) {
+        value = std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(
+            std::chrono::nanoseconds{in.scalar<std::int64_t>()});
+    }
+};
+
+template<typename T, std::size_t N>
+struct codec<std::array<T, N>, std::enable_if_t<is_serializable_v<T>>> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, const std::array<T, N>& value) {
+        for (const auto& item : value) {
+            compact::write(out, item);
+        }
+    }
+
+    static void read(reader& in, std::array<T, N>& value) {
+        for (auto& item : value) {
+            compact::read(in, item);
+        }
+    }
+};
+
+// Vectors of arithmetic types (i.e. byte buffers) are a uint64 element count followed by the elements
+template<typename T>
+struct codec<std::vector<T>, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, const std::vector<T>& value) {
+        out.scalar<std::uint64_t>(value.size());
+        if constexpr (sizeof(T) == 1) {
+            out.bytes(value.data(), value.size());
+        } else {
+            for (T item : value) {
+                out.scalar<T>(item);
+            }
+        }
+    }
+
+    static void read(reader& in, std::vector<T>& value) {
+        const auto count = in.scalar<std::uint64_t>();
+        if (count > in.remaining() / sizeof(T)) {
+            throw std::runtime_error("[compact] vector length exceeds message size");
+        }
+        value.resize(static_cast<std::size_t>(count));
+        if constexpr (sizeof(T) == 1) {
+            in.bytes(value.data(), value.size());
+        } else {
+            for (T& item : value) {
+                item = in.scalar<T>();
+            }
+        }
+    }
+};
+
+// Fixed-size Eigen matrices/vectors: coefficients in storage order
+template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct codec<Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols>, std::enable_if_t<(Rows > 0 && Cols > 0)>> {
+    static constexpr bool supported = true;
+    using matrix_type               = Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols>;
+
+    static void write(writer& out, const matrix_type& value) {
+        for (int i = 0; i < Rows * Cols; ++i) {
+            out.scalar<Scalar>(value.data()[i]);
+        }
+    }
+
+    static void read(reader& in, matrix_type& value) {
+        for (int i = 0; i < Rows * Cols; ++i) {
+            value.data()[i] = in.scalar<Scalar>();
+        }
+    }
+};
+
+// Quaternions: x, y, z, w (Eigen's coefficient order)
+template<typename Scalar, int Options>
+struct codec<Eigen::Quaternion<Scalar, Options>> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, const Eigen::Quaternion<Scalar, Options>& value) {
+        for (int i = 0; i < 4; ++i) {
+            out.scalar<Scalar>(value.coeffs()[i]);
+        }
+    }
+
+    static void read(reader& in, Eigen::Quaternion<Scalar, Options>& value) {
+        for (int i = 0; i < 4; ++i) {
+            value.coeffs()[i] = in.scalar<Scalar>();
+        }
+    }
+};
+
+// Structs with a field list
+template<typename T>
+struct codec<T, std::void_t<decltype(fields<T>::members())>> {
+    static constexpr bool supported = true;
+
+    static void write(writer& out, const T& value) {
+        std::apply(
+            [&](auto... member) {
+                (compact::write(out, value.*member), ...);
+            },
+            fields<T>::members());
+    }
+
+    static void read(reader& in, T& value) {
+        std::apply(
+            [&](auto... member) {
+                (compact::read(in, value.*member), ...);
+            },
+            fields<T>::members());
+    }
+};
+
+/**
+ * @brief Appends the compact encoding of @p value to @p out.
+ */
+template<typename T>
+void encode(const T& value, std::vector<char>& out) {
+    static_assert(is_serializable_v<T>, "type has no compact codec; specialize compact::fields or compact::codec");
+    writer w{out};
+    compact::write(w, value);
+}
+
+/**
+ * @brief Decodes @p size bytes at @p data into @p value.
+ *
+ * @throws std::runtime_error if the buffer is too short, or longer than the encoding of @p T.
+ */
+template<typename T>
+void decode(const char* data, std::size_t size, T& value) {
+    static_assert(is_serializable_v<T>, "type has no compact codec; specialize compact::fields or compact::codec");
+    reader r{data, size};
+    compact::read(r, value);
+    if (r.remaining() != 0) {
+        throw std::runtime_error("[compact] " + std::to_string(r.remaining()) + " trailing bytes after message");
+    }
+}
+
+} // namespace ILLIXR::network::compact
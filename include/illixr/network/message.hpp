@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ILLIXR::network {
+
+/**
+ * @brief A contiguous, read-only span of bytes that keeps its backing storage alive.
+ *
+ * The span does not own the bytes directly; instead it holds a reference-counted handle (`owner`) to whatever object
+ * does (a serialization buffer, a switchboard event, ...). This lets a payload be handed from the serializer to the
+ * socket without being copied.
+ */
+struct segment {
+    std::shared_ptr<const void> owner;
+    const char*                 data = nullptr;
+    std::size_t                 size = 0;
+};
+
+/**
+ * @brief A scatter/gather message: an ordered list of segments which are sent back-to-back on the wire.
+ *
+ * Backends prepend their own framing header as an additional segment and hand the whole list to the socket in a
+ * single gathered write (`writev`/`sendmsg`), so that large payloads are never copied after serialization.
+ *
+ * \code{.cpp}
+ * auto buffer = std::make_shared<std::vector<char>>(serialize(event));
+ * network::message msg{buffer};
+ * backend->topic_send(topic_name, std::move(msg));
+ * \endcode
+ */
+class message {
+public:
+    message() = default;
+
+    /**
+     * @brief Takes ownership of @p bytes, without copying them.
+     */
+    explicit message(std::string&& bytes) {
+        append(std::make_shared<const std::string>(std::move(bytes)));
+    }
+
+    /**
+     * @brief Shares ownership of @p bytes (any container with `data()` and `size()`).
+     */
+    template<typename Container>
+    explicit message(std::shared_ptr<Container> bytes) {
+        append(std::move(bytes));
+    }
+
+    /**
+     * @brief Appends a segment which shares ownership of the container @p bytes.
+     */
+    template<typename Container>
+    void append(std::shared_ptr<Container> bytes) {
+        const char* data = reinterpret_cast<const char*>(bytes->data());
+        std::size_t size = bytes->size() * sizeof(*bytes->data());
+        append(std::shared_ptr<const void>{std::move(bytes)}, data, size);
+    }
+
+    /**
+     * @brief Appends @p size bytes at @p data; @p owner must keep them alive for the lifetime of this message.
+     */
+    void append(std::shared_ptr<const void> owner, const char* data, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        size_ += size;
+        segments_.push_back(segment{std::move(owner), data, size});
+    }
+
+    /**
+     * @brief Appends a copy of @p bytes. Intended for small pieces such as headers or trailers.
+     */
+    void append_copy(const std::string& bytes) {
+        append(std::make_shared<const std::string>(bytes));
+    }
+
+    [[nodiscard]] const std::vector<segment>& segments() const {
+        return segments_;
+    }
+
+    /**
+     * @brief Total number of bytes across all segments.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Copies all segments into one contiguous string.
+     *
+     * Only for transports which cannot do gathered writes; this is the copy the message type exists to avoid.
+     */
+    [[nodiscard]] std::string flatten() const {
+        std::string out;
+        out.reserve(size_);
+        for (const auto& seg : segments_) {
+            out.append(seg.data, seg.size);
+        }
+        return out;
+    }
+
+private:
+    std::vector<segment> segments_;
+    std::size_t          size_ = 0;
+};
+
+} // namespace ILLIXR::network
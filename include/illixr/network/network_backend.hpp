@@ -1,6 +1,7 @@
 #pragma once
 
 #include "illixr/phonebook.hpp"
+#include "message.hpp"
 #include "topic_config.hpp"
 
 #include <memory>
@@ -32,10 +33,21 @@ public:
 
     /**
      * Called when a message is requested to be sent on a topic by a plugin.
+     *
+     * The backend should write the segments of @p msg to the wire without first copying them into one buffer.
+     * @param topic_name The name of the topic.
+     * @param msg The message to send.
+     */
+    virtual void topic_send(std::string topic_name, message&& msg) = 0;
+
+    /**
+     * Convenience overload for a payload which is already a single contiguous string; the string is moved, not copied.
      * @param topic_name The name of the topic.
-     * @param message The message to send.
+     * @param bytes The message to send.
      */
-    virtual void topic_send(std::string topic_name, std::string&& message) = 0;
+    void topic_send(std::string topic_name, std::string&& bytes) {
+        topic_send(std::move(topic_name), message{std::move(bytes)});
+    }
 
     virtual void start_client() = 0;
 
@@ -25,15 +25,21 @@
     #include <arpa/inet.h>
     #include <netinet/in.h>
     #include <netinet/tcp.h>
+    #include <cerrno>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include <unistd.h>
     #define BYTE_TYPE   ssize_t
     #define SOCKET_TYPE int
 #endif
 
 #include "illixr/export.hpp"
+#include "illixr/network/message.hpp"
 
+#include <algorithm>
+#include <climits>
 #include <string>
+#include <vector>
 
 namespace ILLIXR::network {
 
@@ -147,6 +153,25 @@ public:
         return std::string(buffer, bytes_read);
     }
 
+    // Read exactly `size` bytes into `dst`. Returns false if the connection was closed or failed first.
+    [[nodiscard]] bool read_exact(char* dst, size_t size) const {
+        while (size > 0) {
+            BYTE_TYPE bytes_read =
+#if defined(_WIN32) || defined(_WIN64)
+                recv(fd_, dst, static_cast<int>(min(BUFFER_SIZE, size)), 0);
+#else
+                read(fd_, dst, std::min(BUFFER_SIZE, size));
+            if (bytes_read < 0 && errno == EINTR)
+                continue;
+#endif
+            if (bytes_read <= 0)
+                return false;
+            dst += bytes_read;
+            size -= static_cast<size_t>(bytes_read);
+        }
+        return true;
+    }
+
     // Write data to the socket
     void write_data(const std::string& buffer) {
         auto it = buffer.begin();
@@ -155,6 +180,50 @@ public:
         } while (it != buffer.end());
     }
 
+    // Write the segments back-to-back with a gathered write, so they never have to be copied into one buffer
+    void write_segments(const std::vector<segment>& segments) const {
+#if defined(_WIN32) || defined(_WIN64)
+        for (const auto& seg : segments) {
+            const char* data = seg.data;
+            size_t      left = seg.size;
+            while (left > 0) {
+                BYTE_TYPE bytes_written = send(fd_, data, static_cast<int>(min(left, size_t{INT_MAX})), 0);
+                if (bytes_written < 0)
+                    throw std::runtime_error("Write failed");
+                data += bytes_written;
+                left -= static_cast<size_t>(bytes_written);
+            }
+        }
+#else
+        std::vector<iovec> iov;
+        iov.reserve(segments.size());
+        for (const auto& seg : segments) {
+            iov.push_back(iovec{const_cast<char*>(seg.data), seg.size});
+        }
+
+        size_t first = 0;
+        while (first < iov.size()) {
+            const auto count         = static_cast<int>(std::min(iov.size() - first, MAX_IOV));
+            BYTE_TYPE  bytes_written = writev(fd_, iov.data() + first, count);
+            if (bytes_written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("Write failed");
+            }
+            // skip the fully written segments, then trim the partially written one
+            auto remaining = static_cast<size_t>(bytes_written);
+            while (first < iov.size() && remaining >= iov[first].iov_len) {
+                remaining -= iov[first].iov_len;
+                ++first;
+            }
+            if (remaining > 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+#endif
+    }
+
     // Disable naggle algorithm. This allows socket to flush data immediately after calling write().
     void enable_no_delay() const {
 #if defined(_WIN32) || defined(_WIN64)
@@ -226,6 +295,8 @@ private:
     SOCKET_TYPE fd_;
     /* maximum size of a read */
     static constexpr size_t BUFFER_SIZE = 1024 * 256;
+    /* maximum number of segments per gathered write (UIO_MAXIOV on Linux) */
+    static constexpr size_t MAX_IOV = 1024;
 };
 
 } // namespace ILLIXR::network
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <optional>
+#include <string>
 
 namespace ILLIXR::network {
 
@@ -16,9 +17,41 @@ struct topic_config {
     packetization_type                                    packetization      = DEFAULT;
     std::optional<std::chrono::duration<long, std::nano>> latency;
 
-    enum SerializationMethod { BOOST, PROTOBUF } serialization_method;
+    /**
+     * BOOST: polymorphic Boost binary archive of the event.
+     * PROTOBUF: the event is an `event_wrapper<std::string>` holding an already-serialized message, sent as-is.
+     * COMPACT: fixed little-endian layout from the event type's field list (see compact.hpp).
+     */
+    enum SerializationMethod { BOOST, PROTOBUF, COMPACT } serialization_method;
 
     enum TransportMethod { TCP, UDP } transport_method;
 };
 
+/**
+ * @brief Name of @p method as sent in the backends' create_topic control messages.
+ */
+inline std::string serialization_method_name(topic_config::SerializationMethod method) {
+    switch (method) {
+    case topic_config::SerializationMethod::BOOST:
+        return "BOOST";
+    case topic_config::SerializationMethod::COMPACT:
+        return "COMPACT";
+    default:
+        return "PROTOBUF";
+    }
+}
+
+/**
+ * @brief Inverse of serialization_method_name(); unknown names map to PROTOBUF, as before COMPACT existed.
+ */
+inline topic_config::SerializationMethod serialization_method_from_name(const std::string& name) {
+    if (name == "BOOST") {
+        return topic_config::SerializationMethod::BOOST;
+    }
+    if (name == "COMPACT") {
+        return topic_config::SerializationMethod::COMPACT;
+    }
+    return topic_config::SerializationMethod::PROTOBUF;
+}
+
 } // namespace ILLIXR::network
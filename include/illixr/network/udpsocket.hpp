@@ -22,12 +22,16 @@
     #include <arpa/inet.h>
     #include <netinet/in.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include <unistd.h>
     #define BYTE_TYPE   ssize_t
     #define SOCKET_TYPE int
 #endif
 
 #include "illixr/export.hpp"
+#include "illixr/network/message.hpp"
+
+#include <vector>
 
 namespace ILLIXR::network {
 
@@ -126,6 +130,38 @@ public:
         return sent == static_cast<BYTE_TYPE>(buffer.size());
     }
 
+    // Send the segments as a single datagram to the previously set peer address, without joining them first.
+    // Returns false if no peer has been set or the send fails.
+    bool write_segments(const std::vector<segment>& segments) const {
+        if (!peer_set_)
+            return false;
+        size_t total = 0;
+        for (const auto& seg : segments) {
+            total += seg.size;
+        }
+#if defined(_WIN32) || defined(_WIN64)
+        std::string buffer;
+        buffer.reserve(total);
+        for (const auto& seg : segments) {
+            buffer.append(seg.data, seg.size);
+        }
+        return write_data(buffer);
+#else
+        std::vector<iovec> iov;
+        iov.reserve(segments.size());
+        for (const auto& seg : segments) {
+            iov.push_back(iovec{const_cast<char*>(seg.data), seg.size});
+        }
+        msghdr msg{};
+        msg.msg_name    = const_cast<sockaddr_in*>(&peer_addr_);
+        msg.msg_namelen = sizeof(peer_addr_);
+        msg.msg_iov     = iov.data();
+        msg.msg_iovlen  = iov.size();
+        BYTE_TYPE sent  = sendmsg(fd_, &msg, 0);
+        return sent == static_cast<BYTE_TYPE>(total);
+#endif
+    }
+
     // Send a datagram to an explicit destination (used by the server to reply to a specific client).
     bool write_data_to(const std::string& buffer, const sockaddr_in& dest) const {
         BYTE_TYPE sent = sendto(fd_,
@@ -3,6 +3,7 @@
 #include "export.hpp"
 #include "phonebook.hpp"
 #include "record_logger.hpp"
+#include "thread_scheduler.hpp"
 
 #include <memory>
 #include <spdlog/common.h>
@@ -50,7 +51,11 @@ public:
         , phonebook_{pb}
         , record_logger_{phonebook_->lookup_impl<record_logger>()}
         , gen_guid_{phonebook_->lookup_impl<gen_guid>()}
-        , id_{gen_guid_->get()} { }
+        , id_{gen_guid_->get()} {
+        if (phonebook_->has_impl<thread_scheduler>()) {
+            phonebook_->lookup_impl<thread_scheduler>()->register_plugin(id_, name_);
+        }
+    }
 
     virtual ~plugin() = default;
 
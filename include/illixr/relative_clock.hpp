@@ -2,9 +2,14 @@
 
 #include "phonebook.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <ratio>
+#include <set>
+#include <thread>
 
 namespace ILLIXR {
 
@@ -96,6 +101,11 @@ inline bool operator!=(const time_point& lhs, const time_point& rhs) {
  * because it needs to have data (namely _m_start) shared across link-time boundaries. There's no
  * clean way to do this with static variables, so instead I use instance variables and Phonebook.
  *
+ * In virtual time (ILLIXR_VIRTUAL_TIME), `now()` does not follow the wall clock. It only moves when every registered
+ * time source (e.g. offline_imu and offline_cam replaying a dataset) is waiting in `advance_to()` and no switchboard
+ * callback has work queued or running; it then jumps to the earliest deadline. A replay thus runs as fast as the
+ * pipeline can process it, and every component that reads `now()` sees the same, reproducible times.
+ *
  * [1]: https://en.cppreference.com/w/cpp/named_req/Clock
  */
 class relative_clock : public phonebook::service {
@@ -105,6 +115,9 @@ public:
 
     [[nodiscard]] time_point now() const {
         assert(this->is_started() && "Can't call now() before this clock has been start()ed.");
+        if (virtual_time_) {
+            return time_point{duration{virtual_now_.load(std::memory_order_acquire)}};
+        }
         return time_point{std::chrono::steady_clock::now() - start_};
     }
 
@@ -134,8 +147,148 @@ public:
         return time_point{start_.time_since_epoch()};
     }
 
+    /**
+     * @brief Selects virtual time; must be called before any plugin is created.
+     */
+    void set_virtual_time(bool enable) {
+        virtual_time_ = enable;
+    }
+
+    [[nodiscard]] bool is_virtual_time() const {
+        return virtual_time_;
+    }
+
+    /**
+     * @brief Blocks the calling thread until @p deadline.
+     *
+     * In real time this sleeps; in virtual time it waits for the clock to be moved past @p deadline by the time sources.
+     */
+    void sleep_until(time_point deadline) {
+        wait_until(deadline, false);
+    }
+
+    void sleep_for(duration d) {
+        sleep_until(now() + d);
+    }
+
+    /**
+     * @brief Registers a time source; in virtual time, the clock only moves while every time source waits in
+     * `advance_to()`. Call this before the clock is started (i.e. from a plugin's constructor), so that no source can
+     * run ahead of one that has not registered yet, and call `remove_time_source()` once the source has no more data.
+     */
+    void add_time_source() {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        ++time_sources_;
+        had_time_sources_ = true;
+    }
+
+    void remove_time_source() {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        assert(time_sources_ > 0);
+        --time_sources_;
+        advance_if_idle();
+    }
+
+    /**
+     * @brief Called by a time source to wait for its next sample at @p deadline.
+     *
+     * Same as `sleep_until()` in real time. In virtual time, the clock jumps to the earliest pending deadline once
+     * every time source waits here and no switchboard callback has work.
+     */
+    void advance_to(time_point deadline) {
+        wait_until(deadline, true);
+    }
+
+    /**
+     * @brief Whether any time source has registered; virtual time cannot move without one.
+     */
+    [[nodiscard]] bool has_time_sources() const {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        return had_time_sources_;
+    }
+
+    /**
+     * @brief Whether every time source that registered has since run out of data.
+     */
+    [[nodiscard]] bool time_sources_finished() const {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        return had_time_sources_ && time_sources_ == 0;
+    }
+
+    /**
+     * @brief Marks an event as queued for (or being handled by) a switchboard callback; virtual time waits for it.
+     */
+    void begin_work() {
+        busy_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void end_work() {
+        if (busy_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            advance_if_idle();
+        }
+    }
+
+    /**
+     * @brief Releases every thread waiting on virtual time, for shutdown.
+     */
+    void cancel_sleeps() {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        cancelled_ = true;
+        wake_.notify_all();
+    }
+
 private:
+    void wait_until(time_point deadline, bool time_source) {
+        if (!virtual_time_) {
+            std::this_thread::sleep_until(start_ + deadline.time_since_epoch());
+            return;
+        }
+
+        const clock_rep_             target = deadline.time_since_epoch().count();
+        std::unique_lock<std::mutex> lock{mutex_};
+        if (virtual_now_.load(std::memory_order_relaxed) >= target || cancelled_) {
+            return;
+        }
+        auto waiting = deadlines_.insert(target);
+        if (time_source) {
+            ++sleeping_sources_;
+            advance_if_idle();
+        }
+        wake_.wait(lock, [&] {
+            return virtual_now_.load(std::memory_order_relaxed) >= target || cancelled_;
+        });
+        if (time_source) {
+            --sleeping_sources_;
+        }
+        deadlines_.erase(waiting);
+    }
+
+    // Moves virtual time to the earliest deadline if the pipeline is idle; mutex_ must be held
+    void advance_if_idle() {
+        if (time_sources_ == 0 || sleeping_sources_ < time_sources_ || busy_.load(std::memory_order_acquire) != 0 ||
+            deadlines_.empty()) {
+            return;
+        }
+        if (*deadlines_.begin() > virtual_now_.load(std::memory_order_relaxed)) {
+            virtual_now_.store(*deadlines_.begin(), std::memory_order_release);
+        }
+        wake_.notify_all();
+    }
+
     std::chrono::steady_clock::time_point start_;
+
+    // Virtual time
+    bool                      virtual_time_ = false;
+    std::atomic<clock_rep_>   virtual_now_{0};
+    mutable std::mutex        mutex_;
+    std::condition_variable   wake_;
+    std::multiset<clock_rep_> deadlines_;
+    std::size_t               time_sources_     = 0;
+    std::size_t               sleeping_sources_ = 0;
+    bool                      had_time_sources_ = false;
+    bool                      cancelled_        = false;
+    std::atomic<std::size_t>  busy_{0};
 };
 
 using duration = relative_clock::duration;
@@ -37,11 +37,16 @@ public:
         return switchboard_;
     }
 
+    std::shared_ptr<relative_clock> get_clock() {
+        return clock_;
+    }
+
     virtual ~runtime() = default;
 
 protected:
-    bool                         enable_monado_ = false;
-    std::shared_ptr<switchboard> switchboard_;
+    bool                            enable_monado_ = false;
+    std::shared_ptr<switchboard>    switchboard_;
+    std::shared_ptr<relative_clock> clock_;
 };
 
 extern "C" MY_EXPORT_API runtime* runtime_factory();
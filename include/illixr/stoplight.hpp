@@ -3,6 +3,7 @@
 #include "phonebook.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 
@@ -78,6 +79,19 @@ public:
         return false;
     }
 
+    /**
+     * @brief Wait for the event to be set, or until @p deadline.
+     *
+     * Returns whether the event was actually set.
+     */
+    template<class Clock, class Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const {
+        std::unique_lock<std::mutex> lock{mutex_};
+        return cv_.wait_until(lock, deadline, [this] {
+            return value_.load();
+        });
+    }
+
 private:
     mutable std::mutex              mutex_;
     mutable std::condition_variable cv_;
@@ -117,6 +131,14 @@ public:
         return should_stop_.is_set();
     }
 
+    /**
+     * @brief Blocks until @p deadline, returning early (with true) if the application is asked to stop.
+     */
+    template<class Clock, class Duration>
+    bool wait_for_should_stop_until(const std::chrono::time_point<Clock, Duration>& deadline) const {
+        return should_stop_.wait_until(deadline);
+    }
+
     void signal_should_stop() {
         should_stop_.set();
     }
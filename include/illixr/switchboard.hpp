@@ -6,10 +6,13 @@
 #include "concurrentqueue/blockingconcurrentqueue.hpp"
 #include "export.hpp"
 #include "managed_thread.hpp"
+#include "network/compact.hpp"
 #include "network/network_backend.hpp"
 #include "network/topic_config.hpp"
 #include "phonebook.hpp"
 #include "record_logger.hpp"
+#include "relative_clock.hpp"
+#include "thread_scheduler.hpp"
 
 #ifdef Success
     #undef Success // For 'Success' conflict
@@ -50,6 +53,8 @@ const std::vector<std::string> ENV_VARS    = {
     "ILLIXR_ENABLE_PRE_SLEEP",
     "ILLIXR_LOG_LEVEL",
     "ILLIXR_RUN_DURATION",
+    "ILLIXR_SCHEDULING",
+    "ILLIXR_VIRTUAL_TIME",
 };
 /**
  * @Should be private to Switchboard.
@@ -199,17 +204,21 @@ private:
     public:
         topic_subscription(const std::string& topic_name, plugin_id_t plugin_id,
                            std::function<void(ptr<const event>&&, std::size_t)> callback,
-                           const std::shared_ptr<record_logger>&                record_logger_)
+                           const std::shared_ptr<record_logger>&                record_logger_,
+                           const std::shared_ptr<relative_clock>&               clock,
+                           const std::shared_ptr<thread_scheduler>&             scheduler)
             : topic_name_{topic_name}
             , plugin_id_{plugin_id}
             , callback_{std::move(callback)}
             , record_logger_{record_logger_}
             , cb_log_{record_logger_}
+            , clock_{clock && clock->is_virtual_time() ? clock : nullptr}
+            , scheduler_{scheduler}
             , thread_{[this] {
                           this->thread_body();
                       },
-                      [] {
-                          thread_on_start();
+                      [this] {
+                          this->thread_on_start();
                       },
                       [this] {
                           this->thread_on_stop();
@@ -224,6 +233,10 @@ private:
          */
         void enqueue(ptr<const event>&& this_event) {
             if (thread_.get_state() == managed_thread::state::running) {
+                // Counted before the consumer can see the event, so that the count never drops below zero
+                if (clock_) {
+                    clock_->begin_work();
+                }
                 [[maybe_unused]] bool ret = queue_.enqueue(std::move(this_event));
                 assert(ret);
                 enqueued_++;
@@ -231,7 +244,10 @@ private:
         }
 
     private:
-        static void thread_on_start() {
+        void thread_on_start() {
+            if (scheduler_) {
+                scheduler_->apply_to_subscription(plugin_id_, topic_name_);
+            }
 #ifndef NDEBUG
             // spdlog::get("illixr")->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%^%l%$] [switchboard] thread %t %v");
             // spdlog::get("illixr")->debug("start");
@@ -265,6 +281,9 @@ private:
                                            {std::chrono::high_resolution_clock::now()},
                                        }});
                 }
+                if (clock_) {
+                    clock_->end_work();
+                }
             } else {
                 // Nothing to do.
                 idle_cycles_++;
@@ -282,6 +301,9 @@ private:
                     // std::cerr << "deq (stopping) " << ptr_to_str(reinterpret_cast<const void*>(this_event.get_ro())) << " "
                     // << this_event.use_count() << " v\n";
                     this_event.reset();
+                    if (clock_) {
+                        clock_->end_work();
+                    }
                 }
             }
 
@@ -303,6 +325,8 @@ private:
         std::function<void(ptr<const event>&&, std::size_t)>  callback_;
         const std::shared_ptr<record_logger>                  record_logger_;
         record_coalescer                                      cb_log_;
+        const std::shared_ptr<relative_clock>                 clock_; ///< Only set in virtual time
+        const std::shared_ptr<thread_scheduler>               scheduler_;
         moodycamel::BlockingConcurrentQueue<ptr<const event>> queue_{8 /*max size estimate*/};
         moodycamel::ConsumerToken                             token_{queue_};
         static constexpr std::chrono::milliseconds            queue_timeout_{100};
@@ -336,14 +360,32 @@ private:
         ptr<const event> dequeue() {
             ptr<const event> obj;
             queue_size_--;
+            if (pending_) {
+                obj.swap(pending_);
+                return obj;
+            }
             queue_.wait_dequeue(token_, obj);
             return obj;
         }
 
+        /**
+         * @brief Blocks until an event is available or @p timeout passes, without consuming the event.
+         *
+         * Returns true if the next `dequeue()` will not block. Like `dequeue()`, only to be called from the consumer.
+         */
+        template<typename Rep, typename Period>
+        bool wait_for_data(const std::chrono::duration<Rep, Period>& timeout) {
+            if (pending_) {
+                return true;
+            }
+            return queue_.wait_dequeue_timed(token_, pending_, timeout);
+        }
+
     private:
         moodycamel::BlockingConcurrentQueue<ptr<const event>> queue_{8 /*max size estimate*/};
         moodycamel::ConsumerToken                             token_{queue_};
         std::atomic<size_t>                                   queue_size_{0};
+        ptr<const event>                                      pending_; ///< Taken off queue_ by wait_for_data()
     };
 
     /**
@@ -362,10 +404,13 @@ private:
      */
     class topic {
     public:
-        topic(std::string name, const std::type_info& ty, std::shared_ptr<record_logger> record_logger_)
+        topic(std::string name, const std::type_info& ty, std::shared_ptr<record_logger> record_logger_,
+              std::shared_ptr<relative_clock> clock, std::shared_ptr<thread_scheduler> scheduler)
             : name_{std::move(name)}
             , type_info_{ty}
             , record_logger_{std::move(record_logger_)}
+            , clock_{std::move(clock)}
+            , scheduler_{std::move(scheduler)}
             , latest_index_{0} { }
 
         const std::string& name() {
@@ -435,19 +480,66 @@ private:
             // this_event->use_count() << " (= 1 + len(sub)) \n";
         }
 
-        [[maybe_unused]] void deserialize_and_put(std::vector<char>& buffer, network::topic_config& config) {
-            if (config.serialization_method == network::topic_config::SerializationMethod::BOOST) {
-                // TODO: Need to differentiate and support protobuf deserialization
-                boost::iostreams::stream<boost::iostreams::array_source> stream{buffer.data(), buffer.size()};
-                // Use no_header for cross-platform compatibility (sizeof(long) differs between Windows and Linux)
-                boost::archive::binary_iarchive ia{stream, boost::archive::no_header};
-                ptr<event>                      this_event;
-                ia >> this_event;
-                put(std::move(this_event));
-            } else {
-                ptr<event> message = std::make_shared<event_wrapper<std::string>>((std::string(buffer.begin(), buffer.end())));
-                put(std::move(message));
+        /**
+         * @brief Deserializes a message received from the network and publishes it to the topic.
+         *
+         * @p buffer is consumed: PROTOBUF payloads are moved into the published event without copying. This runs on the
+         * network backend's receive thread, so a message that cannot be decoded is logged and dropped.
+         */
+        [[maybe_unused]] void deserialize_and_put(std::string&& buffer, const network::topic_config& config) {
+            ptr<event> this_event;
+            try {
+                if (config.serialization_method == network::topic_config::SerializationMethod::BOOST) {
+                    // TODO: Need to differentiate and support protobuf deserialization
+                    boost::iostreams::stream<boost::iostreams::array_source> stream{buffer.data(), buffer.size()};
+                    // Use no_header for cross-platform compatibility (sizeof(long) differs between Windows and Linux)
+                    boost::archive::binary_iarchive ia{stream, boost::archive::no_header};
+                    ia >> this_event;
+                } else if (config.serialization_method == network::topic_config::SerializationMethod::COMPACT) {
+                    const compact_codec* codec = get_compact_codec();
+                    if (codec == nullptr) {
+                        spdlog::get("illixr")->error("[switchboard] topic '{}' dropped a COMPACT message: no compact codec is "
+                                                     "registered for it",
+                                                     name_);
+                        return;
+                    }
+                    this_event = codec->decode(buffer.data(), buffer.size());
+                } else {
+                    this_event = std::make_shared<event_wrapper<std::string>>(std::move(buffer));
+                }
+            } catch (const std::exception& e) {
+                spdlog::get("illixr")->error("[switchboard] topic '{}' dropped a message it could not decode: {}", name_,
+                                             e.what());
+                return;
             }
+            put(std::move(this_event));
+        }
+
+        /**
+         * @brief Converts the topic's events to and from COMPACT network messages.
+         */
+        struct compact_codec {
+            std::function<void(const event&, std::vector<char>&)> encode;
+            std::function<ptr<event>(const char*, std::size_t)>   decode;
+        };
+
+        /**
+         * @brief Installs the codec used for COMPACT messages; only the first call has any effect.
+         *
+         * Called through switchboard::register_compact_codec().
+         */
+        void set_compact_codec(compact_codec codec) {
+            std::call_once(compact_codec_once_, [&] {
+                compact_codec_ = std::move(codec);
+                has_compact_codec_.store(true, std::memory_order_release);
+            });
+        }
+
+        /**
+         * @brief The codec for COMPACT messages, or nullptr if none was registered.
+         */
+        [[nodiscard]] const compact_codec* get_compact_codec() const {
+            return has_compact_codec_.load(std::memory_order_acquire) ? &compact_codec_ : nullptr;
         }
 
         /**
@@ -459,7 +551,7 @@ private:
             // Write on subscriptions_.
             // Must acquire unique state on subscriptions_lock_
             const std::unique_lock lock{subscriptions_lock_};
-            subscriptions_.emplace_back(name_, plugin_id, callback, record_logger_);
+            subscriptions_.emplace_back(name_, plugin_id, callback, record_logger_, clock_, scheduler_);
         }
 
         topic_buffer& get_buffer() {
@@ -483,14 +575,19 @@ private:
     private:
         static constexpr std::size_t latest_buffer_size_ = 256;
 
-        const std::string                                 name_;
-        const std::type_info&                             type_info_;
-        const std::shared_ptr<record_logger>              record_logger_;
-        std::atomic<size_t>                               latest_index_;
-        std::array<ptr<const event>, latest_buffer_size_> latest_buffer_;
-        std::list<topic_subscription>                     subscriptions_;
-        std::list<topic_buffer>                           buffers_;
-        std::shared_mutex                                 subscriptions_lock_;
+        const std::string                                   name_;
+        const std::type_info&                               type_info_;
+        const std::shared_ptr<record_logger>                record_logger_;
+        const std::shared_ptr<relative_clock>               clock_;
+        const std::shared_ptr<thread_scheduler>             scheduler_;
+        std::atomic<size_t>                                 latest_index_;
+        std::array<ptr<const event>, latest_buffer_size_>   latest_buffer_;
+        std::list<topic_subscription>                       subscriptions_;
+        std::list<topic_buffer>                             buffers_;
+        std::shared_mutex                                   subscriptions_lock_;
+        compact_codec                                       compact_codec_;
+        std::once_flag                                      compact_codec_once_;
+        std::atomic<bool>                                   has_compact_codec_{false};
     };
 
 public:
@@ -582,6 +679,16 @@ public:
             return this_specific_event;
         }
 
+        /**
+         * @brief Sleeps until an event is available or @p timeout passes; returns true if `dequeue()` will not block.
+         *
+         * See also `threadloop::wait_for_data()`, which wraps this for `_p_should_skip()`.
+         */
+        template<typename Rep, typename Period>
+        bool wait_for_data(const std::chrono::duration<Rep, Period>& timeout) {
+            return topic_buffer_.wait_for_data(timeout);
+        }
+
     private:
         topic&        topic_;
         size_t        serial_no_ = 0;
@@ -640,25 +747,42 @@ public:
             , backend_{std::move(backend)}
             , config_{config} { }
 
+        /**
+         * @brief Serializes @p this_specific_event and hands it to the backend as a scatter/gather message.
+         *
+         * The serialized bytes are referenced (not copied) by the message all the way down to the socket.
+         */
         void put(ptr<Serializable_event>&& this_specific_event) override {
             if (backend_->is_topic_networked(this->topic_.name())) {
                 if (config_.serialization_method == network::topic_config::SerializationMethod::BOOST) {
                     auto base_event = std::dynamic_pointer_cast<event>(std::move(this_specific_event));
                     assert(base_event && "Event is not derived from switchboard::event");
                     // Default serialization method - Boost
-                    std::vector<char>                                                                        buffer;
-                    boost::iostreams::back_insert_device<std::vector<char>>                                  inserter{buffer};
+                    auto                                                    buffer = std::make_shared<std::vector<char>>();
+                    boost::iostreams::back_insert_device<std::vector<char>> inserter{*buffer};
                     boost::iostreams::stream_buffer<boost::iostreams::back_insert_device<std::vector<char>>> stream{inserter};
-                    // Use no_header for cross-platform compatibility (sizeof(long) differs between Windows and Linux)
-                    boost::archive::binary_oarchive oa{stream, boost::archive::no_header};
-                    oa << base_event;
+                    {
+                        // Use no_header for cross-platform compatibility (sizeof(long) differs between Windows and Linux)
+                        boost::archive::binary_oarchive oa{stream, boost::archive::no_header};
+                        oa << base_event;
+                    }
                     // flush
                     stream.pubsync();
-                    backend_->topic_send(this->topic_.name(), std::move(std::string(buffer.begin(), buffer.end())));
+                    backend_->topic_send(this->topic_.name(), network::message{std::move(buffer)});
+                } else if (config_.serialization_method == network::topic_config::SerializationMethod::COMPACT) {
+                    // No type header: the receiving topic already knows the event type. get_network_writer() made sure
+                    // that the topic has a codec.
+                    auto buffer = std::make_shared<std::vector<char>>();
+                    this->topic_.get_compact_codec()->encode(*this_specific_event, *buffer);
+                    backend_->topic_send(this->topic_.name(), network::message{std::move(buffer)});
                 } else {
-                    // PROTOBUF - this_specific_event will be a string
-                    auto        message_ptr = std::dynamic_pointer_cast<event_wrapper<std::string>>(this_specific_event);
-                    std::string message     = **message_ptr;
+                    // PROTOBUF - this_specific_event will be a string, which the message keeps alive instead of copying
+                    auto message_ptr = std::dynamic_pointer_cast<const event_wrapper<std::string>>(
+                        ptr<const Serializable_event>{std::move(this_specific_event)});
+                    assert(message_ptr && "PROTOBUF topics must carry event_wrapper<std::string>");
+                    const std::string& bytes = **message_ptr;
+                    network::message   message;
+                    message.append(std::shared_ptr<const void>{message_ptr}, bytes.data(), bytes.size());
                     backend_->topic_send(this->topic_.name(), std::move(message));
                 }
             } else {
@@ -677,7 +801,9 @@ public:
      */
     explicit switchboard(const phonebook* pb)
         : phonebook_{pb}
-        , record_logger_{pb ? pb->lookup_impl<record_logger>() : nullptr} {
+        , record_logger_{pb ? pb->lookup_impl<record_logger>() : nullptr}
+        , clock_{pb && pb->has_impl<relative_clock>() ? pb->lookup_impl<relative_clock>() : nullptr}
+        , scheduler_{pb && pb->has_impl<thread_scheduler>() ? pb->lookup_impl<thread_scheduler>() : nullptr} {
         for (const auto& item : ENV_VARS) {
             char* value = getenv(item.c_str());
             if (value) {
@@ -851,6 +977,7 @@ public:
      *
      * If the requested backend has not been registered (e.g., the UDP plugin
      * was not loaded) a runtime_error is thrown with a descriptive message.
+     * COMPACT topics also throw unless register_compact_codec() was called first.
      *
      * @tparam Specific_event  The event type to be transported.
      * @param  topic_name      Name of the switchboard topic.
@@ -883,7 +1010,35 @@ public:
         if (registry_.find(topic_name) == registry_.end())
             backend->topic_create(topic_name, config);
 
-        return network_writer<Specific_event>{try_register_topic<Specific_event>(topic_name), backend, config};
+        topic& _topic = try_register_topic<Specific_event>(topic_name);
+        if (config.serialization_method == network::topic_config::SerializationMethod::COMPACT &&
+            _topic.get_compact_codec() == nullptr) {
+            throw std::runtime_error("[switchboard] topic '" + topic_name +
+                                     "' uses COMPACT serialization, but register_compact_codec() was not called for it");
+        }
+        return network_writer<Specific_event>{_topic, backend, config};
+    }
+
+    /**
+     * @brief Lets @p topic_name carry @p Specific_event as COMPACT network messages, in both directions.
+     *
+     * Call it in the plugins that write or read the topic over the network, before their network writer is created. The
+     * codec comes from the type's serialization header (e.g. `data_format/serialization/head_pose.hpp`), which the
+     * calling file must include; topics without a codec drop the COMPACT messages they receive.
+     */
+    template<typename Specific_event>
+    void register_compact_codec(const std::string& topic_name) {
+        static_assert(network::compact::is_serializable_v<Specific_event>,
+                      "type has no compact codec; include its header from data_format/serialization");
+        try_register_topic<Specific_event>(topic_name)
+            .set_compact_codec({[](const event& this_event, std::vector<char>& buffer) {
+                                    network::compact::encode(static_cast<const Specific_event&>(this_event), buffer);
+                                },
+                                [](const char* data, std::size_t size) -> ptr<event> {
+                                    auto this_event = std::make_shared<Specific_event>();
+                                    network::compact::decode(data, size, *this_event);
+                                    return this_event;
+                                }});
     }
 
     /**
@@ -922,6 +1077,8 @@ private:
     std::unordered_map<std::string, topic>       registry_;
     std::shared_mutex                            registry_lock_;
     std::shared_ptr<record_logger>               record_logger_;
+    std::shared_ptr<relative_clock>              clock_;
+    std::shared_ptr<thread_scheduler>            scheduler_;
     std::unordered_map<std::string, std::string> env_vars_;
 
     template<typename Specific_event>
@@ -947,7 +1104,10 @@ private:
 #endif
         // Topic not found. Need to create it here.
         const std::unique_lock lock{registry_lock_};
-        return registry_.try_emplace(topic_name, topic_name, typeid(Specific_event), record_logger_).first->second;
+        topic& _topic =
+            registry_.try_emplace(topic_name, topic_name, typeid(Specific_event), record_logger_, clock_, scheduler_)
+                .first->second;
+        return _topic;
     }
 
     /**
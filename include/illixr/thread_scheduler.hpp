@@ -0,0 +1,377 @@
+#pragma once
+
+#include "phonebook.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace ILLIXR {
+
+/**
+ * @brief Places ILLIXR's threads on CPUs and sets their scheduling class and priority, as given in the profile.
+ *
+ * Configured by ILLIXR_SCHEDULING (main builds it from the profile's `scheduling` section), a `;`-separated list of
+ * entries such as
+ *
+ *     timewarp_gl: cpus=2-3 policy=fifo priority=80 isolate; openvins: cpus=4-7 nice=5; timewarp_gl/imu: cpus=1
+ *
+ * An entry named after a plugin applies to its threadloop thread and to its switchboard callback threads; an entry named
+ * `plugin/topic` applies to that plugin's callback thread on that topic instead. The fields are all optional:
+ * - cpus: the CPUs the threads may run on, e.g. `0,2-3`
+ * - policy: `other` (the default, time-shared class), `fifo` or `rr`; the real-time classes need CAP_SYS_NICE or an
+ *   rtprio limit
+ * - priority: 1 to 99, for `fifo` and `rr`
+ * - nice: -20 to 19, for `other`
+ * - isolate: keep every other threadloop and switchboard callback thread that has no cpus of its own off these CPUs
+ *
+ * Threads apply their entry themselves when they start, and log where they actually ended up. Only threadloop and
+ * switchboard callback threads are placed: the main thread, the network backend's threads, and threads that plugins
+ * create on their own are not, and isolate does not keep them off the isolated CPUs either. To fence those too, start
+ * ILLIXR under `taskset` or in a cpuset that excludes the isolated CPUs.
+ */
+class thread_scheduler : public phonebook::service {
+public:
+    enum class sched_class { inherit, other, fifo, rr };
+
+    struct thread_policy {
+        std::set<int>      cpus;
+        sched_class        policy   = sched_class::inherit;
+        int                priority = 0;
+        std::optional<int> nice;
+        bool               isolate = false;
+    };
+
+    /**
+     * @brief Parses @p spec (see above), replacing any previous configuration.
+     *
+     * Throws std::invalid_argument if @p spec is malformed.
+     */
+    void configure(const std::string& spec) {
+        std::map<std::string, thread_policy> policies;
+        std::istringstream                   entries{spec};
+        std::string                          entry;
+        while (std::getline(entries, entry, ';')) {
+            if (entry.find_first_not_of(" \t\n") == std::string::npos) {
+                continue;
+            }
+            const auto colon = entry.find(':');
+            if (colon == std::string::npos) {
+                throw std::invalid_argument{"[thread_scheduler] Expected 'target: settings' in '" + entry + "'"};
+            }
+            policies[trim(entry.substr(0, colon))] = parse_policy(entry.substr(colon + 1));
+        }
+
+        std::set<int> isolated;
+        for (const auto& [target, policy] : policies) {
+            if (policy.isolate) {
+                isolated.insert(policy.cpus.begin(), policy.cpus.end());
+            }
+        }
+
+        const std::lock_guard<std::mutex> lock{mutex_};
+        policies_ = std::move(policies);
+        shared_cpus_.clear();
+        if (!isolated.empty()) {
+            for (int cpu = 0; cpu < online_cpus(); ++cpu) {
+                if (isolated.count(cpu) == 0) {
+                    shared_cpus_.insert(cpu);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Logs the configuration, and warns about entries that name no loaded plugin.
+     */
+    void report(const std::vector<std::string>& plugin_names) const {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        for (const auto& [target, policy] : policies_) {
+            const std::string plugin = target.substr(0, target.find('/'));
+            if (std::find(plugin_names.begin(), plugin_names.end(), plugin) == plugin_names.end()) {
+                spdlog::get("illixr")->warn("[thread_scheduler] '{}' does not name a loaded plugin", target);
+            }
+            spdlog::get("illixr")->info("[thread_scheduler] {}: {}", target, describe(policy));
+        }
+        if (!shared_cpus_.empty()) {
+            spdlog::get("illixr")->info("[thread_scheduler] Other threads: CPUs {}", cpu_list(shared_cpus_));
+        }
+    }
+
+    /**
+     * @brief Records @p name as the plugin behind @p plugin_id, for its callback threads.
+     */
+    void register_plugin(std::size_t plugin_id, const std::string& name) {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        plugin_names_[plugin_id] = name;
+    }
+
+    /**
+     * @brief Applies the entry for @p plugin to the calling thread, a threadloop.
+     */
+    void apply_to_threadloop(const std::string& plugin) {
+        apply(plugin, lookup(plugin), "threadloop");
+    }
+
+    /**
+     * @brief Applies the entry for @p topic of @p plugin_id (or for the whole plugin) to the calling thread, a
+     * switchboard callback thread.
+     */
+    void apply_to_subscription(std::size_t plugin_id, const std::string& topic) {
+        std::string plugin;
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            auto                              found = plugin_names_.find(plugin_id);
+            plugin = found == plugin_names_.end() ? "plugin " + std::to_string(plugin_id) : found->second;
+        }
+        auto policy = lookup(plugin + "/" + topic);
+        apply(plugin + "/" + topic, policy ? policy : lookup(plugin), "callback");
+    }
+
+private:
+    static std::string trim(const std::string& s) {
+        const auto begin = s.find_first_not_of(" \t\n");
+        const auto end   = s.find_last_not_of(" \t\n");
+        return begin == std::string::npos ? std::string{} : s.substr(begin, end - begin + 1);
+    }
+
+    static int to_int(const std::string& field, const std::string& value, int min, int max) {
+        int result;
+        try {
+            std::size_t used;
+            result = std::stoi(value, &used);
+            if (used != value.size()) {
+                throw std::invalid_argument{value};
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument{"[thread_scheduler] " + field + "=" + value + " is not a number"};
+        }
+        if (result < min || result > max) {
+            throw std::invalid_argument{"[thread_scheduler] " + field + "=" + value + " is out of range [" +
+                                        std::to_string(min) + ", " + std::to_string(max) + "]"};
+        }
+        return result;
+    }
+
+    static std::set<int> parse_cpus(const std::string& value) {
+        std::set<int>      cpus;
+        std::istringstream ranges{value};
+        std::string        range;
+        while (std::getline(ranges, range, ',')) {
+            const auto dash  = range.find('-');
+            const int  first = to_int("cpus", range.substr(0, dash), 0, CPU_LIMIT - 1);
+            const int  last =
+                dash == std::string::npos ? first : to_int("cpus", range.substr(dash + 1), first, CPU_LIMIT - 1);
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.insert(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    static thread_policy parse_policy(const std::string& settings) {
+        thread_policy      policy;
+        std::istringstream fields{settings};
+        std::string        field;
+        while (fields >> field) {
+            const auto  equals = field.find('=');
+            const auto  key    = field.substr(0, equals);
+            std::string value  = equals == std::string::npos ? std::string{} : field.substr(equals + 1);
+            if (key == "isolate") {
+                policy.isolate = value.empty() || value == "true";
+            } else if (key == "cpus") {
+                policy.cpus = parse_cpus(value);
+            } else if (key == "policy") {
+                if (value == "other") {
+                    policy.policy = sched_class::other;
+                } else if (value == "fifo") {
+                    policy.policy = sched_class::fifo;
+                } else if (value == "rr") {
+                    policy.policy = sched_class::rr;
+                } else {
+                    throw std::invalid_argument{"[thread_scheduler] Unknown policy '" + value + "'"};
+                }
+            } else if (key == "priority") {
+                policy.priority = to_int(key, value, 1, 99);
+            } else if (key == "nice") {
+                policy.nice = to_int(key, value, -20, 19);
+            } else {
+                throw std::invalid_argument{"[thread_scheduler] Unknown setting '" + field + "'"};
+            }
+        }
+
+        const bool real_time = policy.policy == sched_class::fifo || policy.policy == sched_class::rr;
+        if (real_time && policy.priority == 0) {
+            throw std::invalid_argument{"[thread_scheduler] fifo and rr need a priority in '" + settings + "'"};
+        }
+        if (policy.isolate && policy.cpus.empty()) {
+            throw std::invalid_argument{"[thread_scheduler] isolate needs cpus in '" + settings + "'"};
+        }
+        return policy;
+    }
+
+    static std::string cpu_list(const std::set<int>& cpus) {
+        std::string list;
+        for (auto it = cpus.begin(); it != cpus.end();) {
+            int first = *it;
+            int last  = first;
+            while (++it != cpus.end() && *it == last + 1) {
+                last = *it;
+            }
+            list += (list.empty() ? "" : ",") + std::to_string(first) + (last > first ? "-" + std::to_string(last) : "");
+        }
+        return list;
+    }
+
+    static std::string describe(const thread_policy& policy) {
+        std::string text = policy.cpus.empty() ? "any CPU" : "CPUs " + cpu_list(policy.cpus);
+        switch (policy.policy) {
+        case sched_class::inherit:
+            break;
+        case sched_class::other:
+            text += ", SCHED_OTHER";
+            break;
+        case sched_class::fifo:
+            text += ", SCHED_FIFO priority " + std::to_string(policy.priority);
+            break;
+        case sched_class::rr:
+            text += ", SCHED_RR priority " + std::to_string(policy.priority);
+            break;
+        }
+        if (policy.nice) {
+            text += ", nice " + std::to_string(*policy.nice);
+        }
+        return text + (policy.isolate ? ", isolated" : "");
+    }
+
+    std::optional<thread_policy> lookup(const std::string& target) const {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        auto                              found = policies_.find(target);
+        if (found != policies_.end()) {
+            return found->second;
+        }
+        return std::nullopt;
+    }
+
+#if defined(__linux__)
+    static constexpr int CPU_LIMIT = CPU_SETSIZE;
+
+    static int online_cpus() {
+        return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    static int to_linux(sched_class policy) {
+        switch (policy) {
+        case sched_class::fifo:
+            return SCHED_FIFO;
+        case sched_class::rr:
+            return SCHED_RR;
+        default:
+            return SCHED_OTHER;
+        }
+    }
+
+    static sched_class from_linux(int policy) {
+        switch (policy) {
+        case SCHED_FIFO:
+            return sched_class::fifo;
+        case SCHED_RR:
+            return sched_class::rr;
+        default:
+            return sched_class::other;
+        }
+    }
+
+    void apply(const std::string& target, const std::optional<thread_policy>& policy, const char* kind) {
+        std::set<int> cpus;
+        {
+            const std::lock_guard<std::mutex> lock{mutex_};
+            cpus = policy && !policy->cpus.empty() ? policy->cpus : shared_cpus_;
+        }
+        if (!policy && cpus.empty()) {
+            return; // nothing configured for this thread
+        }
+
+        const auto tid = static_cast<pid_t>(syscall(SYS_gettid));
+        if (!cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus) {
+                CPU_SET(cpu, &set);
+            }
+            if (const int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); error != 0) {
+                spdlog::get("illixr")->warn("[thread_scheduler] {} ({}): cannot run on CPUs {}: {}", target, kind,
+                                            cpu_list(cpus), std::strerror(error));
+            }
+        }
+        if (policy && policy->policy != sched_class::inherit) {
+            sched_param param{};
+            param.sched_priority = policy->policy == sched_class::other ? 0 : policy->priority;
+            if (const int error = pthread_setschedparam(pthread_self(), to_linux(policy->policy), &param); error != 0) {
+                spdlog::get("illixr")->warn("[thread_scheduler] {} ({}): cannot set {}: {}", target, kind, describe(*policy),
+                                            std::strerror(error));
+            }
+        }
+        if (policy && policy->nice && setpriority(PRIO_PROCESS, static_cast<id_t>(tid), *policy->nice) != 0) {
+            spdlog::get("illixr")->warn("[thread_scheduler] {} ({}): cannot set nice {}: {}", target, kind, *policy->nice,
+                                        std::strerror(errno));
+        }
+
+        // report what the thread actually got, rather than what was asked for
+        thread_policy actual;
+        cpu_set_t     set;
+        if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    actual.cpus.insert(cpu);
+                }
+            }
+        }
+        int         linux_policy;
+        sched_param param{};
+        if (pthread_getschedparam(pthread_self(), &linux_policy, &param) == 0) {
+            actual.policy   = from_linux(linux_policy);
+            actual.priority = param.sched_priority;
+        }
+        actual.nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+        spdlog::get("illixr")->info("[thread_scheduler] {} ({}, tid {}): {}", target, kind, tid, describe(actual));
+    }
+#else
+    static constexpr int CPU_LIMIT = 1024;
+
+    static int online_cpus() {
+        return 0;
+    }
+
+    void apply(const std::string& target, const std::optional<thread_policy>& policy, const char* kind) {
+        if (policy) {
+            spdlog::get("illixr")->warn("[thread_scheduler] {} ({}): thread placement is only supported on Linux", target,
+                                        kind);
+        }
+    }
+#endif
+
+    mutable std::mutex                   mutex_;
+    std::map<std::string, thread_policy> policies_;
+    std::map<std::size_t, std::string>   plugin_names_;
+    std::set<int>                        shared_cpus_; ///< CPUs left to unconfigured threads when some are isolated
+};
+
+} // namespace ILLIXR
@@ -7,6 +7,7 @@
 #include "record_logger.hpp"
 #include "stoplight.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
@@ -29,6 +30,21 @@ const record_header _threadloop_iteration_header{
         {"wall_time_stop", typeid(std::chrono::high_resolution_clock::time_point)},
     }};
 
+/**
+ * Logged once per threadloop when it stops. `wait_*` covers `_p_should_skip()` and the skips it asks for, i.e. the time
+ * spent deciding whether, and waiting until, there is work: the wall time minus the CPU time is time spent idle, the CPU
+ * time is time spent polling.
+ */
+const record_header _threadloop_stop_header{
+    "threadloop_stop",
+    {
+        {"plugin_id", typeid(std::size_t)},
+        {"iterations", typeid(std::size_t)},
+        {"skips", typeid(std::size_t)},
+        {"wait_cpu_time", typeid(std::chrono::nanoseconds)},
+        {"wait_wall_time", typeid(std::chrono::nanoseconds)},
+    }};
+
 /**
  * @brief A reusable threadloop for plugins.
  *
@@ -40,7 +56,8 @@ class threadloop : public plugin {
 public:
     threadloop(const std::string& name, phonebook* pb)
         : plugin{name, pb}
-        , stoplight_{pb->lookup_impl<stoplight>()} { }
+        , stoplight_{pb->lookup_impl<stoplight>()}
+        , scheduler_{pb->has_impl<thread_scheduler>() ? pb->lookup_impl<thread_scheduler>() : nullptr} { }
 
     /**
      * @brief Starts the thread.
@@ -103,6 +120,10 @@ protected:
         /// the order of 1-10ms. This is nicer to the other threads in the system.
         skip_and_yield,
 
+        /// Block, without using the CPU, until the deadline given to `skip_until()` or `skip_for()` (or until the
+        /// application stops). Return it through those functions rather than directly.
+        skip_and_sleep,
+
         /// Calls stop.
         stop,
     };
@@ -114,6 +135,55 @@ protected:
         return skip_option::run;
     }
 
+    /**
+     * @brief Blocks the thread until @p reader (a `switchboard::buffered_reader`) has an event, for use in
+     * `_p_should_skip()` by plugins that only have work to do when data arrives.
+     *
+     * Returns `run` once data is available. The wait is bounded by @p timeout so that the loop still notices
+     * the stoplight; on timeout it returns `skip_and_spin`, and the loop simply waits again.
+     *
+     * \code{.cpp}
+     * skip_option _p_should_skip() override {
+     *     return wait_for_data(reader_);
+     * }
+     * void _p_one_iteration() override {
+     *     auto datum = reader_.dequeue(); // does not block
+     * }
+     * \endcode
+     */
+    template<typename Reader>
+    skip_option wait_for_data(Reader& reader, std::chrono::milliseconds timeout = std::chrono::milliseconds{100}) {
+        return reader.wait_for_data(timeout) ? skip_option::run : skip_option::skip_and_spin;
+    }
+
+    /**
+     * @brief Skips this iteration and sleeps until @p deadline, for use in `_p_should_skip()` by plugins that know when
+     * their next work is due (e.g. the next vsync or a periodic report) instead of polling for it.
+     *
+     * \code{.cpp}
+     * skip_option _p_should_skip() override {
+     *     if (std::chrono::steady_clock::now() < next_report_) {
+     *         return skip_until(next_report_);
+     *     }
+     *     next_report_ += std::chrono::seconds{1};
+     *     return skip_option::run;
+     * }
+     * \endcode
+     */
+    skip_option skip_until(std::chrono::steady_clock::time_point deadline) {
+        wake_time_ = deadline;
+        return skip_option::skip_and_sleep;
+    }
+
+    /**
+     * @brief Skips this iteration and sleeps for @p timeout; see `skip_until()`.
+     */
+    template<typename Rep, typename Period>
+    skip_option skip_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return skip_until(std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout));
+    }
+
     /**
      * @brief Gets called at setup time, from the new thread.
      */
@@ -142,6 +212,10 @@ private:
     void thread_main() {
         record_coalescer it_log{record_logger_};
 
+        if (scheduler_) {
+            scheduler_->apply_to_threadloop(name_);
+        }
+
         // TODO: In the future, synchronize the main loop instead of the setup.
         // This is currently not possible because relative_clock is required in
         // some setup functions, and relative_clock is only guaranteed to be
@@ -150,15 +224,25 @@ private:
         _p_thread_setup();
 
         while (!stoplight_->check_should_stop() && !should_terminate()) {
+            const auto wait_start_cpu_time  = thread_cpu_time();
+            const auto wait_start_wall_time = std::chrono::steady_clock::now();
+
             skip_option s = _p_should_skip();
+            if (s == skip_option::skip_and_yield) {
+                std::this_thread::yield();
+            } else if (s == skip_option::skip_and_sleep) {
+                stoplight_->wait_for_should_stop_until(wake_time_);
+            }
+
+            wait_cpu_time_  += thread_cpu_time() - wait_start_cpu_time;
+            wait_wall_time_ += std::chrono::steady_clock::now() - wait_start_wall_time;
 
             switch (s) {
             case skip_option::skip_and_yield:
-                std::this_thread::yield();
-                ++skip_no;
-                break;
             case skip_option::skip_and_spin:
+            case skip_option::skip_and_sleep:
                 ++skip_no;
+                ++total_skips_;
                 break;
             case skip_option::run: {
                 auto iteration_start_cpu_time  = thread_cpu_time();
@@ -189,12 +273,34 @@ private:
             }
         }
     break_loop:
-        [[maybe_unused]] int cpp_requires_a_statement_after_a_label_plz_optimize_me_away;
+        log_wait_time();
+    }
+
+    void log_wait_time() {
+        record_logger_->log(record{_threadloop_stop_header,
+                                   {
+                                       {id_},
+                                       {iteration_no},
+                                       {total_skips_},
+                                       {wait_cpu_time_},
+                                       {wait_wall_time_},
+                                   }});
+
+        const auto wall_ms = std::chrono::duration<double, std::milli>{wait_wall_time_}.count();
+        const auto cpu_ms  = std::chrono::duration<double, std::milli>{wait_cpu_time_}.count();
+        spdlog::get("illixr")->debug("[threadloop] {}: {} iterations, {} skips; waited {:.1f} ms, idle for {:.1f} ms and "
+                                     "polling for {:.1f} ms",
+                                     name_, iteration_no, total_skips_, wall_ms, std::max(wall_ms - cpu_ms, 0.0), cpu_ms);
     }
 
-    std::atomic<bool>                internal_stop_{false};
-    std::thread                      thread_;
-    std::shared_ptr<const stoplight> stoplight_;
+    std::atomic<bool>                     internal_stop_{false};
+    std::thread                           thread_;
+    std::shared_ptr<const stoplight>      stoplight_;
+    std::shared_ptr<thread_scheduler>     scheduler_;
+    std::chrono::steady_clock::time_point wake_time_;
+    std::size_t                           total_skips_ = 0;
+    std::chrono::nanoseconds              wait_cpu_time_{0};
+    std::chrono::nanoseconds              wait_wall_time_{0};
 };
 
 } // namespace ILLIXR
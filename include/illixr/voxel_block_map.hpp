@@ -0,0 +1,295 @@
+#pragma once
+
+#include "error_util.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ILLIXR {
+
+/// Integer coordinates of a voxel block (a brick of 8x8x8 voxels) in the reconstruction grid
+using VoxelBlockIndex = std::tuple<int, int, int>;
+
+/**
+ * @brief Hash table from voxel block coordinates to @p Value, using open addressing with linear probing.
+ *
+ * Keys are the three coordinates packed into one 63-bit integer, so distinct blocks never share a key and a lookup is
+ * a single probe sequence over a flat array, comparing one integer per slot. The table doubles whenever it is more than
+ * half full. Coordinates must lie in [-2^20, 2^20), i.e. within about 8 km of the origin at 8 mm voxels; storing a block
+ * outside that range aborts, in every build type, rather than letting it share a key with another block.
+ *
+ * There is no erase: the mesh pipeline marks stale blocks in their value instead, and empties whole maps with clear().
+ *
+ * \code{.cpp}
+ * voxel_block_map<std::pair<int, int>> ranges;
+ * ranges[{1, -2, 3}] = {0, 41};
+ * if (auto* range = ranges.find({1, -2, 3})) { ... }
+ * for (const auto& [index, range] : ranges) { ... }
+ * \endcode
+ */
+template<typename Value>
+class voxel_block_map {
+public:
+    static constexpr int coordinate_bits = 21;
+
+    template<bool Const>
+    class basic_iterator;
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    voxel_block_map() = default;
+
+    explicit voxel_block_map(std::size_t expected_size) {
+        reserve(expected_size);
+    }
+
+    /**
+     * @brief Whether every coordinate of @p index fits the key, i.e. lies in [-2^20, 2^20).
+     */
+    static bool in_range(const VoxelBlockIndex& index) {
+        return in_range(std::get<0>(index)) && in_range(std::get<1>(index)) && in_range(std::get<2>(index));
+    }
+
+    /**
+     * @brief Packs @p index into the table's key. Each coordinate is stored as 21-bit two's complement.
+     *
+     * Aborts if @p index is out of range: masking it would give the key of another block.
+     */
+    static std::uint64_t pack(const VoxelBlockIndex& index) {
+        constexpr std::uint64_t mask = (std::uint64_t{1} << coordinate_bits) - 1;
+        if (!in_range(index)) {
+            ILLIXR::abort("[voxel_block_map] voxel block (" + std::to_string(std::get<0>(index)) + ", " +
+                          std::to_string(std::get<1>(index)) + ", " + std::to_string(std::get<2>(index)) +
+                          ") is outside the " + std::to_string(coordinate_bits) + "-bit coordinate range");
+        }
+        return ((static_cast<std::uint64_t>(std::get<0>(index)) & mask) << (2 * coordinate_bits)) |
+            ((static_cast<std::uint64_t>(std::get<1>(index)) & mask) << coordinate_bits) |
+            (static_cast<std::uint64_t>(std::get<2>(index)) & mask);
+    }
+
+    static VoxelBlockIndex unpack(std::uint64_t key) {
+        return {unpack_coordinate(key >> (2 * coordinate_bits)), unpack_coordinate(key >> coordinate_bits),
+                unpack_coordinate(key)};
+    }
+
+    /**
+     * @brief Returns the value stored for @p index, or nullptr.
+     */
+    Value* find(const VoxelBlockIndex& index) {
+        // A block out of range can never have been stored
+        if (size_ == 0 || !in_range(index)) {
+            return nullptr;
+        }
+        slot& s = slots_[probe(pack(index))];
+        return s.key == empty_key ? nullptr : &s.value;
+    }
+
+    const Value* find(const VoxelBlockIndex& index) const {
+        return const_cast<voxel_block_map*>(this)->find(index);
+    }
+
+    /**
+     * @brief Returns the value stored for @p index, inserting a value-initialized one if there is none.
+     */
+    Value& operator[](const VoxelBlockIndex& index) {
+        return *try_emplace(index).first;
+    }
+
+    /**
+     * @brief Inserts a value constructed from @p args unless @p index is already present.
+     * @return The stored value, and whether it was inserted.
+     */
+    template<typename... Args>
+    std::pair<Value*, bool> try_emplace(const VoxelBlockIndex& index, Args&&... args) {
+        if (2 * (size_ + 1) > slots_.size()) {
+            rehash(slots_.empty() ? min_capacity : 2 * slots_.size());
+        }
+        const std::uint64_t key = pack(index);
+        slot&               s   = slots_[probe(key)];
+        if (s.key != empty_key) {
+            return {&s.value, false};
+        }
+        s.key   = key;
+        s.value = Value(std::forward<Args>(args)...);
+        ++size_;
+        return {&s.value, true};
+    }
+
+    /**
+     * @brief Makes room for @p expected_size entries without rehashing.
+     */
+    void reserve(std::size_t expected_size) {
+        std::size_t capacity = min_capacity;
+        while (capacity < 2 * expected_size) {
+            capacity *= 2;
+        }
+        if (capacity > slots_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    /**
+     * @brief Removes all entries. The slot array is kept, so refilling the map to a similar size does not allocate
+     * (values are reset by assignment; their own storage is released).
+     */
+    void clear() {
+        if (size_ == 0) {
+            return;
+        }
+        for (auto& s : slots_) {
+            if (s.key != empty_key) {
+                s.key   = empty_key;
+                s.value = Value{};
+            }
+        }
+        size_ = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const {
+        return slots_.size();
+    }
+
+    iterator begin() {
+        return iterator{slots_.data(), slots_.data() + slots_.size()};
+    }
+
+    iterator end() {
+        return iterator{slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+    }
+
+    const_iterator begin() const {
+        return const_iterator{slots_.data(), slots_.data() + slots_.size()};
+    }
+
+    const_iterator end() const {
+        return const_iterator{slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+    }
+
+private:
+    // Packed keys use the low 63 bits, so this can never be a valid key
+    static constexpr std::uint64_t empty_key    = ~std::uint64_t{0};
+    static constexpr std::size_t   min_capacity = 64;
+
+    struct slot {
+        std::uint64_t key = empty_key;
+        Value         value{};
+    };
+
+    static bool in_range(int coordinate) {
+        return coordinate >= -(1 << (coordinate_bits - 1)) && coordinate < (1 << (coordinate_bits - 1));
+    }
+
+    static int unpack_coordinate(std::uint64_t bits) {
+        constexpr std::uint64_t mask     = (std::uint64_t{1} << coordinate_bits) - 1;
+        constexpr std::uint64_t sign_bit = std::uint64_t{1} << (coordinate_bits - 1);
+        bits &= mask;
+        return static_cast<int>(static_cast<std::int64_t>(bits ^ sign_bit) - static_cast<std::int64_t>(sign_bit));
+    }
+
+    // splitmix64 finalizer: neighbouring blocks differ in only a few low bits of each coordinate field
+    static std::uint64_t mix(std::uint64_t key) {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    /// Index of the slot holding @p key, or of the empty slot where it would be inserted
+    std::size_t probe(std::uint64_t key) const {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t       i    = mix(key) & mask;
+        while (slots_[i].key != key && slots_[i].key != empty_key) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void rehash(std::size_t capacity) {
+        std::vector<slot> old(capacity);
+        old.swap(slots_);
+        for (auto& s : old) {
+            if (s.key != empty_key) {
+                slot& target = slots_[probe(s.key)];
+                target.key   = s.key;
+                target.value = std::move(s.value);
+            }
+        }
+    }
+
+    std::vector<slot> slots_;
+    std::size_t       size_ = 0;
+
+public:
+    /**
+     * @brief Forward iterator over the occupied slots, in table order. Dereferences to a (index, value reference) pair.
+     */
+    template<bool Const>
+    class basic_iterator {
+    public:
+        using slot_pointer      = std::conditional_t<Const, const slot*, slot*>;
+        using value_reference   = std::conditional_t<Const, const Value&, Value&>;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::pair<VoxelBlockIndex, value_reference>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = value_type;
+
+        basic_iterator(slot_pointer at, slot_pointer end)
+            : at_{at}
+            , end_{end} {
+            skip_empty();
+        }
+
+        reference operator*() const {
+            return {unpack(at_->key), at_->value};
+        }
+
+        basic_iterator& operator++() {
+            ++at_;
+            skip_empty();
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const basic_iterator& other) const {
+            return at_ == other.at_;
+        }
+
+        bool operator!=(const basic_iterator& other) const {
+            return at_ != other.at_;
+        }
+
+    private:
+        void skip_empty() {
+            while (at_ != end_ && at_->key == empty_key) {
+                ++at_;
+            }
+        }
+
+        slot_pointer at_;
+        slot_pointer end_;
+    };
+};
+
+} // namespace ILLIXR
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core/mat.hpp>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+/**
+ * @file depth_planes.hpp
+ * @brief Splits 16-bit depth into two 8-bit planes for the video encoder (device side), and merges them back (server
+ * side).
+ *
+ * The encoder carries depth as two 8-bit grey images: the high bytes (MSB) and the low bytes (LSB). The kernels use
+ * AVX2, SSE2 or NEON, whichever the build targets, and a scalar loop for the tail and for other targets; all of them
+ * give identical results. Samples are assumed to be stored little-endian, as on every platform ILLIXR runs on.
+ */
+namespace ILLIXR {
+
+namespace depth_planes_detail {
+
+inline void split_scalar(const std::uint16_t* src, std::uint8_t* msb, std::uint8_t* lsb, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        msb[i] = static_cast<std::uint8_t>(src[i] >> 8);
+        lsb[i] = static_cast<std::uint8_t>(src[i] & 0xFF);
+    }
+}
+
+inline void merge_scalar(const std::uint8_t* msb, const std::uint8_t* lsb, std::uint16_t* dst, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<std::uint16_t>((msb[i] << 8) | lsb[i]);
+    }
+}
+
+} // namespace depth_planes_detail
+
+/**
+ * @brief Splits @p count 16-bit samples into their high bytes (@p msb) and low bytes (@p lsb).
+ */
+inline void split_depth16(const std::uint16_t* src, std::uint8_t* msb, std::uint8_t* lsb, std::size_t count) {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i low_byte = _mm256_set1_epi16(0x00FF);
+    for (; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        // packus works within 128-bit lanes, so the 64-bit quarters come out as a0 b0 a1 b1
+        const __m256i high = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        const __m256i low  = _mm256_packus_epi16(_mm256_and_si256(a, low_byte), _mm256_and_si256(b, low_byte));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(msb + i), _mm256_permute4x64_epi64(high, 0xD8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lsb + i), _mm256_permute4x64_epi64(low, 0xD8));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(msb + i), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lsb + i),
+                         _mm_packus_epi16(_mm_and_si128(a, low_byte), _mm_and_si128(b, low_byte)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= count; i += 16) {
+        // de-interleaves the bytes: val[0] holds the low bytes, val[1] the high bytes
+        const uint8x16x2_t bytes = vld2q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+        vst1q_u8(msb + i, bytes.val[1]);
+        vst1q_u8(lsb + i, bytes.val[0]);
+    }
+#endif
+    depth_planes_detail::split_scalar(src + i, msb + i, lsb + i, count - i);
+}
+
+/**
+ * @brief Rebuilds @p count 16-bit samples from their high bytes (@p msb) and low bytes (@p lsb).
+ */
+inline void merge_depth16(const std::uint8_t* msb, const std::uint8_t* lsb, std::uint16_t* dst, std::size_t count) {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= count; i += 32) {
+        // unpack works within 128-bit lanes, so the quarters are put in the order a0 a2 a1 a3 first
+        const __m256i high = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(msb + i)), 0xD8);
+        const __m256i low  = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lsb + i)), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_unpacklo_epi8(low, high));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), _mm256_unpackhi_epi8(low, high));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 16 <= count; i += 16) {
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(msb + i));
+        const __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lsb + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(low, high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(low, high));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x2_t bytes{{vld1q_u8(lsb + i), vld1q_u8(msb + i)}};
+        vst2q_u8(reinterpret_cast<std::uint8_t*>(dst + i), bytes);
+    }
+#endif
+    depth_planes_detail::merge_scalar(msb + i, lsb + i, dst + i, count - i);
+}
+
+/**
+ * @brief Splits a CV_16U image into packed (row stride == width) MSB and LSB planes at @p msb and @p lsb, e.g. straight
+ * into the video encoder's input buffers.
+ */
+inline void split_depth16(const cv::Mat& depth16, std::uint8_t* msb, std::uint8_t* lsb) {
+    CV_Assert(depth16.type() == CV_16U);
+    if (depth16.isContinuous()) {
+        split_depth16(depth16.ptr<std::uint16_t>(), msb, lsb, depth16.total());
+        return;
+    }
+    const auto cols = static_cast<std::size_t>(depth16.cols);
+    for (int y = 0; y < depth16.rows; ++y) {
+        split_depth16(depth16.ptr<std::uint16_t>(y), msb + y * cols, lsb + y * cols, cols);
+    }
+}
+
+/**
+ * @brief Splits a CV_16U image into two CV_8UC1 images, (re)allocating them if needed.
+ */
+inline void split_depth16(const cv::Mat& depth16, cv::Mat& out_msb, cv::Mat& out_lsb) {
+    out_msb.create(depth16.size(), CV_8UC1);
+    out_lsb.create(depth16.size(), CV_8UC1);
+    split_depth16(depth16, out_msb.ptr<std::uint8_t>(), out_lsb.ptr<std::uint8_t>());
+}
+
+/**
+ * @brief Merges two CV_8UC1 planes of the same size into a CV_16U image, (re)allocating it if needed.
+ */
+inline void merge_depth16(const cv::Mat& msb, const cv::Mat& lsb, cv::Mat& out_depth16) {
+    CV_Assert(msb.type() == CV_8UC1 && lsb.type() == CV_8UC1 && msb.size() == lsb.size());
+    out_depth16.create(msb.size(), CV_16U);
+    if (msb.isContinuous() && lsb.isContinuous() && out_depth16.isContinuous()) {
+        merge_depth16(msb.ptr<std::uint8_t>(), lsb.ptr<std::uint8_t>(), out_depth16.ptr<std::uint16_t>(), msb.total());
+        return;
+    }
+    for (int y = 0; y < msb.rows; ++y) {
+        merge_depth16(msb.ptr<std::uint8_t>(y), lsb.ptr<std::uint8_t>(y), out_depth16.ptr<std::uint16_t>(y),
+                      static_cast<std::size_t>(msb.cols));
+    }
+}
+
+} // namespace ILLIXR
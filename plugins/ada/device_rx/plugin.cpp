@@ -44,23 +44,19 @@ using namespace ILLIXR::data_format;
 }
 
 threadloop::skip_option device_rx::_p_should_skip() {
-    return skip_option::run;
+    return wait_for_data(sr_reader_);
 }
 
 void device_rx::_p_one_iteration() {
-    if (sr_reader_.size() > 0) {
-        spdlog::get("illixr")->debug("[device_rx] Received packet");
-        auto                   buffer_ptr = sr_reader_.dequeue();
-        std::string            buffer_str = **buffer_ptr;
-        std::string::size_type end        = buffer_str.find(delimiter_);
-        spdlog::get("illixr")->debug("   Buffer size: {},   end: {}", buffer_str.size(), end);
-        spdlog::get("illixr")->debug("   Buffer: {}", buffer_str);
-        sr_output_proto::CompressMeshData sr_output;
-        if (sr_output.ParseFromString(buffer_str.substr(0, end))) {
-            receive_sr_output(sr_output);
-        } else {
-            spdlog::get("illixr")->error("client_rx: Cannot parse SR output!");
-        }
+    spdlog::get("illixr")->debug("[device_rx] Received packet");
+    // Each event holds exactly one message (the backend frames them by length), so it is parsed in place
+    auto               buffer_ptr = sr_reader_.dequeue();
+    const std::string& buffer     = **buffer_ptr;
+    spdlog::get("illixr")->debug("   Buffer size: {}", buffer.size());
+    if (sr_output_.ParseFromArray(buffer.data(), static_cast<int>(buffer.size()))) {
+        receive_sr_output(sr_output_);
+    } else {
+        spdlog::get("illixr")->error("client_rx: Cannot parse SR output!");
     }
 }
 
@@ -73,8 +69,8 @@ void device_rx::receive_sr_output(const sr_output_proto::CompressMeshData& sr_ou
         unsigned           scene_id   = sr_output.request_id();
         std::vector<char>  payload(dataString.begin(), dataString.end());
 
-        mesh_.put(mesh_.allocate<mesh_type>(mesh_type{sr_output.chunk_id() % chunck_number_, payload, false, scene_id,
-                                                      sr_output.chunk_id(), sr_output.max_chunk()}));
+        mesh_.put(mesh_.allocate<mesh_type>(mesh_type{sr_output.chunk_id() % chunck_number_, std::move(payload), false,
+                                                      scene_id, sr_output.chunk_id(), sr_output.max_chunk()}));
 
         auto t1          = std::chrono::high_resolution_clock::now();
         auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
@@ -38,13 +38,12 @@ private:
     int      last_id_ = -1;
     unsigned chunck_number_;
 
-    std::string buffer_str_;
+    sr_output_proto::CompressMeshData sr_output_; ///< Reused for every received message
 
     const std::string data_path_ = std::filesystem::current_path().string() + "/recorded_data";
     std::ofstream     receiving_latency_;
     std::ofstream     vb_timestamp_;
     std::ofstream     device_unpackage_time_;
-    const std::string delimiter_ = "EEND!";
 };
 
 } // namespace ILLIXR
@@ -82,7 +82,7 @@ void device_tx::send_scene_recon_data(switchboard::ptr<const scene_recon_type> d
     }
 
     // Build Payload
-    pose = outgoing_payload->mutable_input_pose();
+    pose = outgoing_payload.mutable_input_pose();
 
     // pyh assign outgoing pose & image information
     pose->set_p_x(datum->pose.position.x());
@@ -97,31 +97,27 @@ void device_tx::send_scene_recon_data(switchboard::ptr<const scene_recon_type> d
     // Depth
     cv::Mat cur_depth = datum->depth;
 
-    sr_input_proto::ImgData* depth_img_msb = outgoing_payload->mutable_depth_img_msb_data();
-    sr_input_proto::ImgData* depth_img_lsb = outgoing_payload->mutable_depth_img_lsb_data();
+    sr_input_proto::ImgData* depth_img_msb = outgoing_payload.mutable_depth_img_msb_data();
+    sr_input_proto::ImgData* depth_img_lsb = outgoing_payload.mutable_depth_img_lsb_data();
 
     depth_img_msb->set_rows(cur_depth.rows);
     depth_img_msb->set_columns(cur_depth.cols);
     depth_img_lsb->set_rows(cur_depth.rows);
     depth_img_lsb->set_columns(cur_depth.cols);
 
-    cv::Mat depth_msb, depth_lsb;
-
-    auto decompose_start = std::chrono::high_resolution_clock::now();
-
-    decompose_16bit_to_8bit(cur_depth, depth_msb, depth_lsb);
-
-    auto decompose_end      = std::chrono::high_resolution_clock::now();
-    auto duration_decompose = std::chrono::duration_cast<std::chrono::microseconds>(decompose_end - decompose_start).count();
-    frame_send_timing_ << "Decompose " << (static_cast<double>(duration_decompose) / 1000.0) << "\n";
-
     auto depth_encoding_start = std::chrono::high_resolution_clock::now();
     {
         std::lock_guard<std::mutex> lk{mutex_};
         img_ready_ = false;
     }
 
-    encoder_->enqueue(depth_msb, depth_lsb);
+    // the MSB/LSB planes are written straight into the encoder's input buffers
+    encoder_->enqueue_depth(cur_depth);
+
+    auto decompose_end = std::chrono::high_resolution_clock::now();
+    auto duration_decompose =
+        std::chrono::duration_cast<std::chrono::microseconds>(decompose_end - depth_encoding_start).count();
+    frame_send_timing_ << "Decompose " << (static_cast<double>(duration_decompose) / 1000.0) << "\n";
 
     {
         std::unique_lock<std::mutex> lock{mutex_};
@@ -141,17 +137,20 @@ void device_tx::send_scene_recon_data(switchboard::ptr<const scene_recon_type> d
     frame_send_timing_ << "Encode " << (static_cast<double>(duration_depth_encoding) / 1000.0) << " " << depth_img_msb->size()
                        << " " << depth_img_lsb->size() << "\n";
 
-    outgoing_payload->set_id(static_cast<int>(frame_id_));
+    outgoing_payload.set_id(static_cast<int>(frame_id_));
 
-    // serialize protobuf directly into place (no temporary std::string)
-    send_buf_ = outgoing_payload->SerializeAsString();
+    // The network backend frames every message with its length, so no delimiter is appended. The buffer is moved into
+    // the event and referenced (not copied) by the network writer
+    std::string send_buf;
+    outgoing_payload.SerializeToString(&send_buf);
+    const size_t send_size = send_buf.size();
 
     // send
-    ada_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(send_buf_ + delimiter));
+    ada_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(send_buf)));
     spdlog::get("illixr")->debug(
-        "Pose of frame {}: {}, {}, {}; {}, {}, {}, {}", frame_id_, outgoing_payload->input_pose().p_x(),
-        outgoing_payload->input_pose().p_y(), outgoing_payload->input_pose().p_z(), outgoing_payload->input_pose().o_w(),
-        outgoing_payload->input_pose().o_x(), outgoing_payload->input_pose().o_y(), outgoing_payload->input_pose().o_z());
+        "Pose of frame {}: {}, {}, {}; {}, {}, {}, {}", frame_id_, outgoing_payload.input_pose().p_x(),
+        outgoing_payload.input_pose().p_y(), outgoing_payload.input_pose().p_z(), outgoing_payload.input_pose().o_w(),
+        outgoing_payload.input_pose().o_x(), outgoing_payload.input_pose().o_y(), outgoing_payload.input_pose().o_z());
 
     {
         std::lock_guard<std::mutex> lk{mutex_};
@@ -161,7 +160,7 @@ void device_tx::send_scene_recon_data(switchboard::ptr<const scene_recon_type> d
 
     auto fullframe          = std::chrono::high_resolution_clock::now();
     auto fullframe_duration = std::chrono::duration_cast<std::chrono::microseconds>(fullframe - t0).count();
-    frame_send_timing_ << "FullFrame " << (static_cast<double>(fullframe_duration) / 1000.0) << " " << send_buf_.size() << "\n";
+    frame_send_timing_ << "FullFrame " << (static_cast<double>(fullframe_duration) / 1000.0) << " " << send_size << "\n";
 
     if (frame_id_ % fps_ == 0 && frame_id_ > 0) {
         since_epoch = fullframe.time_since_epoch();
@@ -176,32 +175,7 @@ void device_tx::send_scene_recon_data(switchboard::ptr<const scene_recon_type> d
         starting_timestamp_.flush();
     }
     frame_id_++;
-    delete outgoing_payload;
-    outgoing_payload = new sr_input_proto::SRSendData();
-}
-
-void device_tx::decompose_16bit_to_8bit(const cv::Mat& depth16, cv::Mat& out_msb, cv::Mat& out_lsb) {
-    CV_Assert(depth16.type() == CV_16U);
-    out_msb.create(depth16.size(), CV_8UC1);
-    out_lsb.create(depth16.size(), CV_8UC1);
-
-    const int rows = depth16.rows;
-    const int cols = depth16.cols;
-
-    for (int y = 0; y < rows; ++y) {
-        const auto src = depth16.ptr<uint16_t>(y);
-        auto       msb = out_msb.ptr<uint8_t>(y);
-        auto       lsb = out_lsb.ptr<uint8_t>(y);
-        for (int x = 0; x < cols; ++x) {
-            const uint16_t v = src[x];
-            msb[x]           = static_cast<uint8_t>(v >> 8);
-            lsb[x]           = static_cast<uint8_t>(v & 0xFF);
-        }
-    }
-}
-
-device_tx::~device_tx() {
-    delete outgoing_payload;
+    outgoing_payload.Clear();
 }
 
 PLUGIN_MAIN(device_tx)
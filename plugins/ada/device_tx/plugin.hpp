@@ -27,8 +27,6 @@
 
 namespace ILLIXR {
 
-const std::string delimiter = "EEND!";
-
 class device_tx
     : public threadloop
     , public device_to_server_base {
@@ -38,15 +36,11 @@ public:
     void start() override;
 
     void send_scene_recon_data(switchboard::ptr<const data_format::scene_recon_type> datum);
-    ~device_tx() override;
 
 protected:
     void _p_one_iteration() override;
 
 private:
-    // pyh more cache and memory friendly, less overhead
-    static void decompose_16bit_to_8bit(const cv::Mat& depth16, cv::Mat& out_msb, cv::Mat& out_lsb);
-
     const std::shared_ptr<switchboard>                                   switchboard_;
     const std::shared_ptr<relative_clock>                                clock_;
     const std::shared_ptr<stoplight>                                     stoplight_;
@@ -58,11 +52,10 @@ private:
     std::ofstream     starting_timestamp_;
     std::ofstream     frame_send_timing_;
 
-    unsigned                    frame_id_{0};
-    sr_input_proto::SRSendData* outgoing_payload = new sr_input_proto::SRSendData();
-    sr_input_proto::Pose*       pose             = nullptr;
+    unsigned                   frame_id_{0};
+    sr_input_proto::SRSendData outgoing_payload; ///< Reused (Clear()ed) every frame
+    sr_input_proto::Pose*      pose = nullptr;
 
-    std::string send_buf_;
     std::string msb_bytes_;
     std::string lsb_bytes_;
 };
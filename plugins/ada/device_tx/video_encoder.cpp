@@ -1,5 +1,6 @@
 #include "video_encoder.hpp"
 
+#include "../depth_planes.hpp"
 #include "illixr/error_util.hpp"
 
 #include <gst/app/gstappsrc.h>
@@ -22,7 +23,26 @@ void ada_video_encoder::enqueue(cv::Mat& img0, cv::Mat& img1) {
     gst_buffer_unmap(b0, &m0);
     gst_buffer_unmap(b1, &m1);
 
-    // ada_video_encoder.cpp (enqueue)
+    push_frame(b0, b1);
+}
+
+void ada_video_encoder::enqueue_depth(const cv::Mat& depth16) {
+    const gsize sz = depth16.total();
+
+    GstBuffer* b0 = gst_buffer_new_allocate(nullptr, sz, nullptr);
+    GstBuffer* b1 = gst_buffer_new_allocate(nullptr, sz, nullptr);
+
+    GstMapInfo m0, m1;
+    gst_buffer_map(b0, &m0, GST_MAP_WRITE);
+    gst_buffer_map(b1, &m1, GST_MAP_WRITE);
+    split_depth16(depth16, m0.data, m1.data);
+    gst_buffer_unmap(b0, &m0);
+    gst_buffer_unmap(b1, &m1);
+
+    push_frame(b0, b1);
+}
+
+void ada_video_encoder::push_frame(GstBuffer* b0, GstBuffer* b1) {
     const guint   fps_n = 30, fps_d = 1;
     const guint64 pts       = gst_util_uint64_scale(frame_idx_, (guint64) GST_SECOND * fps_d, fps_n);
     const guint64 dur       = gst_util_uint64_scale(1, (guint64) GST_SECOND * fps_d, fps_n);
@@ -13,7 +13,15 @@ public:
     GstFlowReturn cb_appsink_msb(GstElement* sink) override;
     GstFlowReturn cb_appsink_lsb(GstElement* sink) override;
 
+    /**
+     * @brief Splits a CV_16U depth image straight into the encoder's MSB and LSB input buffers and queues them; the same
+     * as split_depth16 followed by enqueue(), without the intermediate planes.
+     */
+    void enqueue_depth(const cv::Mat& depth16);
+
 private:
+    void push_frame(GstBuffer* b0, GstBuffer* b1);
+
     GstSample* samp0_{};
     GstSample* samp1_{};
     guint64    frame_idx_ = 0;
@@ -1,9 +1,6 @@
 #include "plugin.hpp"
 
-#include "illixr/concurrentqueue/readwritequeue/readerwritercircularbuffer.h"
-
-#include <atomic>
-#include <condition_variable>
+#include <algorithm>
 #include <draco_illixr/compression/encode.h>
 #include <draco_illixr/compression/expert_encode.h>
 #include <draco_illixr/io/file_reader_factory.h>
@@ -14,7 +11,6 @@
 #include <filesystem>
 #include <fstream>
 #include <mutex>
-#include <queue>
 #include <spdlog/spdlog.h>
 #include <thread>
 
@@ -27,72 +23,63 @@ const int speed_                        = 10 - compression_level_;
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
 
-using b_queue = moodycamel::BlockingReaderWriterCircularBuffer<std::shared_ptr<const mesh_type>>;
-
-std::vector<b_queue> queue_;
-std::mutex           writer_mutex_;
-std::atomic<bool>    done_{false};
-
-std::string data_path_;
-
 const float origin[] = {0.0f, 0.0f, 0.0f};
 const float range    = 2000.0f;
 
-void compress(const uint idx, std::shared_ptr<switchboard::writer<mesh_type>> writer) {
-    std::shared_ptr<const mesh_type> datum;
-    draco_illixr::Encoder            encoder_;
-    encoder_.SetAttributeExplicitQuantization(draco_illixr::GeometryAttribute::POSITION, 14, 3, origin, range);
-
-    encoder_.SetAttributeQuantization(draco_illixr::GeometryAttribute::TEX_COORD, tex_coords_quantization_bits_);
-    encoder_.SetAttributeQuantization(draco_illixr::GeometryAttribute::NORMAL, normals_quantization_bits_);
-    encoder_.SetAttributeQuantization(draco_illixr::GeometryAttribute::GENERIC, generic_quantization_bits_);
-    encoder_.SetSpeedOptions(speed_, speed_);
-
-    std::fstream compression_latency_;
-    compression_latency_.open(data_path_ + "/compression_latency_" + std::to_string(idx) + ".csv", std::ios::out);
-    if (!compression_latency_.is_open()) {
-        spdlog::get("illixr")->error("Failed to open compression latency file {}", idx);
+struct mesh_compression::encoder_context {
+    draco_illixr::Encoder encoder;
+    // only holds pointers to the mesh being decoded, so one decoder serves every chunk
+    draco_illixr::PlyDecoder ply_decoder;
+    std::fstream             latency;
+};
+
+std::unique_ptr<mesh_compression::encoder_context> mesh_compression::make_encoder_context(unsigned worker) const {
+    auto context = std::make_unique<encoder_context>();
+    context->encoder.SetAttributeExplicitQuantization(draco_illixr::GeometryAttribute::POSITION, 14, 3, origin, range);
+
+    context->encoder.SetAttributeQuantization(draco_illixr::GeometryAttribute::TEX_COORD, tex_coords_quantization_bits_);
+    context->encoder.SetAttributeQuantization(draco_illixr::GeometryAttribute::NORMAL, normals_quantization_bits_);
+    context->encoder.SetAttributeQuantization(draco_illixr::GeometryAttribute::GENERIC, generic_quantization_bits_);
+    context->encoder.SetSpeedOptions(speed_, speed_);
+
+    context->latency.open(data_path_ + "/compression_latency_" + std::to_string(worker) + ".csv", std::ios::out);
+    if (!context->latency.is_open()) {
+        spdlog::get("illixr")->error("Failed to open compression latency file {}", worker);
     }
+    return context;
+}
 
-    while (true) {
-        if (queue_[idx].wait_dequeue_timed(datum, std::chrono::milliseconds(2))) {
-            auto start = std::chrono::high_resolution_clock::now();
+void mesh_compression::compress(encoder_context& context, const switchboard::ptr<const mesh_type>& datum) {
+    auto start = std::chrono::high_resolution_clock::now();
 
-            std::unique_ptr<draco_illixr::PlyDecoder> ply_decoder = std::make_unique<draco_illixr::PlyDecoder>();
-            std::unique_ptr<draco_illixr::Mesh>       draco_mesh  = std::make_unique<draco_illixr::Mesh>();
+    std::unique_ptr<draco_illixr::Mesh> draco_mesh = std::make_unique<draco_illixr::Mesh>();
 
-            ply_decoder->out_mesh_        = draco_mesh.get();
-            ply_decoder->out_point_cloud_ = static_cast<draco_illixr::PointCloud*>(draco_mesh.get());
+    context.ply_decoder.out_mesh_        = draco_mesh.get();
+    context.ply_decoder.out_point_cloud_ = static_cast<draco_illixr::PointCloud*>(draco_mesh.get());
 
-            ply_decoder->DecodeExternal(datum->reader, false);
-            // ply_decoder->DecodeExternal(std::move(datum->reader), false);
+    context.ply_decoder.DecodeExternal(datum->reader, false);
 
-            // expert_encoder.reset(new draco_illixr::ExpertEncoder(*(std::move(draco_mesh))));
-            // draco_illixr::PointCloud *draco_pc = draco_mesh.get();
-            std::unique_ptr<draco_illixr::ExpertEncoder> expert_encoder_ =
-                std::make_unique<draco_illixr::ExpertEncoder>(*draco_mesh);
-            expert_encoder_->Reset(encoder_.CreateExpertEncoderOptions(*draco_mesh));
+    // the mesh, and the expert encoder bound to it, are the only per-chunk codec objects
+    draco_illixr::ExpertEncoder expert_encoder{*draco_mesh};
+    expert_encoder.Reset(context.encoder.CreateExpertEncoderOptions(*draco_mesh));
 
-            // expert_encoder->Reset(encoder.CreateExpertEncoderOptions(*draco_pc));
-            draco_illixr::EncoderBuffer draco_buffer;
+    draco_illixr::EncoderBuffer draco_buffer;
 
-            const draco_illixr::Status status   = expert_encoder_->EncodeToBuffer(&draco_buffer);
-            auto                       end      = std::chrono::high_resolution_clock::now();
-            auto                       duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    const draco_illixr::Status status   = expert_encoder.EncodeToBuffer(&draco_buffer);
+    auto                       end      = std::chrono::high_resolution_clock::now();
+    auto                       duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    if (!status.ok()) {
+        spdlog::get("illixr")->error("Failed to compress chunk {} of scene {}: {}", datum->chunk_id, datum->id,
+                                     status.error_msg_string());
+    }
 
-            unsigned mesh_t = datum->type;
-            compression_latency_ << (duration / 1000.0) << "\n";
-            compression_latency_.flush();
+    context.latency << (duration / 1000.0) << "\n";
+    context.latency.flush();
 
-            {
-                std::lock_guard<std::mutex> lock(writer_mutex_);
-                writer->put(writer->allocate<mesh_type>(
-                    mesh_type{mesh_t, *(draco_buffer.buffer()), datum->active, datum->id, datum->chunk_id, datum->max_chunk}));
-            }
-        }
-        if (done_) {
-            break;
-        }
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        compressed_mesh_->put(compressed_mesh_->allocate<mesh_type>(mesh_type{
+            datum->type, std::move(*draco_buffer.buffer()), datum->active, datum->id, datum->chunk_id, datum->max_chunk}));
     }
 }
 
@@ -109,29 +96,31 @@ void compress(const uint idx, std::shared_ptr<switchboard::writer<mesh_type>> wr
             spdlog::get("illixr")->error("Failed to create data directory.");
         }
     }
-    mesh_count_ = switchboard_->get_env_ulong("MESH_COMPRESS_PARALLELISM", 8);
-
-    for (uint i = 0; i < mesh_count_; i++) {
-        queue_.push_back(b_queue(8));
-        compress_thread_.push_back(std::thread(compress, i, compressed_mesh_));
-    }
+    // chunks go to whichever worker is least busy, so this need not match the number of chunks per scene
+    mesh_count_ = switchboard_->get_env_ulong("MESH_COMPRESS_PARALLELISM",
+                                              std::clamp(std::thread::hardware_concurrency(), 1u, 8u));
+
+    workers_ = std::make_unique<mesh_worker_pool<switchboard::ptr<const mesh_type>, encoder_context>>(
+        mesh_count_, 8,
+        [this](unsigned worker) {
+            return make_encoder_context(worker);
+        },
+        [this](encoder_context& context, const switchboard::ptr<const mesh_type>& datum) {
+            compress(context, datum);
+        });
     switchboard_->schedule<mesh_type>(id_, "requested_scene", [&](switchboard::ptr<const mesh_type> datum, std::size_t) {
         this->process_mesh(datum);
     });
 }
 
 void mesh_compression::process_mesh(switchboard::ptr<const mesh_type> datum) {
-    while (!queue_[datum->type].try_enqueue(datum)) { }
+    // blocks while the chosen worker's queue is full
+    workers_->submit(std::move(datum));
 }
 
 mesh_compression::~mesh_compression() {
-    {
-        std::lock_guard<std::mutex> lock(writer_mutex_);
-        done_ = true;
-    }
-    for (auto& t : compress_thread_) {
-        t.join();
-    }
+    // finish the queued chunks before the writer goes away
+    workers_.reset();
 }
 
 PLUGIN_MAIN(mesh_compression)
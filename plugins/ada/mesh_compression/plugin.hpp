@@ -1,11 +1,16 @@
 #pragma once
 
+#include "../mesh_worker_pool.hpp"
 #include "illixr/data_format/mesh.hpp"
 #include "illixr/phonebook.hpp"
 #include "illixr/plugin.hpp"
 #include "illixr/relative_clock.hpp"
 #include "illixr/switchboard.hpp"
 
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace ILLIXR {
 
 class mesh_compression : public plugin {
@@ -17,12 +22,23 @@ public:
     void process_mesh(switchboard::ptr<const data_format::mesh_type> datum);
 
 private:
-    uint mesh_count_;
+    // per-worker Draco encoder state, kept for the lifetime of the worker
+    struct encoder_context;
+
+    std::unique_ptr<encoder_context> make_encoder_context(unsigned worker) const;
+
+    void compress(encoder_context& context, const switchboard::ptr<const data_format::mesh_type>& datum);
+
+    uint        mesh_count_;
+    std::string data_path_;
 
     // ILLIXR related variables
     const std::shared_ptr<switchboard>                           switchboard_;
     std::shared_ptr<switchboard::writer<data_format::mesh_type>> compressed_mesh_;
-    std::vector<std::thread>                                     compress_thread_;
+    std::mutex                                                   writer_mutex_;
+
+    // declared last, so that the workers are stopped before anything they use is destroyed
+    std::unique_ptr<mesh_worker_pool<switchboard::ptr<const data_format::mesh_type>, encoder_context>> workers_;
 };
 
 } // namespace ILLIXR
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../mesh_worker_pool.hpp"
 #include "illixr/data_format/draco.hpp"
 #include "illixr/data_format/mesh.hpp"
 #include "illixr/phonebook.hpp"
@@ -23,6 +24,8 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -30,9 +33,6 @@
 
 namespace ILLIXR {
 
-using VoxelBlockIndex = std::tuple<int, int, int>;
-using NewVB           = std::tuple<VoxelBlockIndex, std::vector<Eigen::Vector3d>, std::vector<Eigen::Vector3d>>;
-
 class mesh_decompression : public plugin {
 public:
     [[maybe_unused]] mesh_decompression(const std::string& name_, phonebook* pb_);
@@ -42,10 +42,21 @@ public:
     void process_frame(switchboard::ptr<const data_format::mesh_type> datum);
 
 private:
+    // per-worker Draco decoder state, kept for the lifetime of the worker
+    struct decoder_context;
+
+    std::unique_ptr<decoder_context> make_decoder_context(unsigned worker) const;
+
+    void decompress(decoder_context& context, const switchboard::ptr<const data_format::mesh_type>& datum);
+
     uint                                                          mesh_count_;
+    std::string                                                   data_path_;
     const std::shared_ptr<switchboard>                            switchboard_;
     std::shared_ptr<switchboard::writer<data_format::draco_type>> decoded_mesh_;
-    std::vector<std::thread>                                      decompress_thread_;
+    std::mutex                                                    writer_mutex_;
+
+    // declared last, so that the workers are stopped before anything they use is destroyed
+    std::unique_ptr<mesh_worker_pool<switchboard::ptr<const data_format::mesh_type>, decoder_context>> workers_;
 };
 
 } // namespace ILLIXR
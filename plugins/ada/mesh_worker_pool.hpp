@@ -0,0 +1,114 @@
+#pragma once
+
+#include "illixr/concurrentqueue/readwritequeue/readerwritercircularbuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ILLIXR {
+
+/**
+ * @brief Fixed set of worker threads for the ADA mesh codecs, each with its own long-lived @p Context.
+ *
+ * A @p Context (e.g. a Draco encoder with its options, or a decoder with its scratch buffers) is made once per worker,
+ * on that worker's thread, from the worker's index, and handed to every job the worker runs. Jobs go to the worker with
+ * the fewest outstanding jobs; submit() blocks while that worker's queue is full, so a slow codec pushes back on its
+ * producer instead of being spun on.
+ *
+ * @p Job must be a nullable pointer type (a null job is how the workers are told to stop). Each worker queue is
+ * single-producer, so submit() must only ever be called from one thread, as from a switchboard callback.
+ */
+template<typename Job, typename Context>
+class mesh_worker_pool {
+public:
+    using context_factory = std::function<std::unique_ptr<Context>(unsigned worker)>;
+    using handler         = std::function<void(Context&, const Job&)>;
+
+    mesh_worker_pool(std::size_t worker_count, std::size_t queue_depth, context_factory make_context, handler handle)
+        : make_context_{std::move(make_context)}
+        , handle_{std::move(handle)} {
+        worker_count = std::max<std::size_t>(worker_count, 1);
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            workers_.push_back(std::make_unique<worker>(queue_depth));
+        }
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            workers_[i]->thread = std::thread([this, i] {
+                run(i);
+            });
+        }
+    }
+
+    mesh_worker_pool(const mesh_worker_pool&)            = delete;
+    mesh_worker_pool& operator=(const mesh_worker_pool&) = delete;
+
+    /**
+     * @brief Finishes the jobs already queued, then stops the workers.
+     */
+    ~mesh_worker_pool() {
+        for (auto& w : workers_) {
+            w->queue.wait_enqueue(Job{});
+        }
+        for (auto& w : workers_) {
+            w->thread.join();
+        }
+    }
+
+    /**
+     * @brief Queues @p job on the least loaded worker, waiting for room in its queue if needed.
+     */
+    void submit(Job job) {
+        // start the scan after the last pick, so that idle workers take turns
+        std::size_t best = (last_picked_ + 1) % workers_.size();
+        for (std::size_t n = 1; n < workers_.size(); ++n) {
+            const std::size_t i = (last_picked_ + 1 + n) % workers_.size();
+            if (workers_[i]->outstanding.load(std::memory_order_relaxed) <
+                workers_[best]->outstanding.load(std::memory_order_relaxed)) {
+                best = i;
+            }
+        }
+        last_picked_ = best;
+        workers_[best]->outstanding.fetch_add(1, std::memory_order_relaxed);
+        workers_[best]->queue.wait_enqueue(std::move(job));
+    }
+
+    [[nodiscard]] std::size_t worker_count() const {
+        return workers_.size();
+    }
+
+private:
+    struct worker {
+        explicit worker(std::size_t queue_depth)
+            : queue{queue_depth} { }
+
+        moodycamel::BlockingReaderWriterCircularBuffer<Job> queue;
+        std::atomic<unsigned>                               outstanding{0}; // queued plus running jobs
+        std::thread                                         thread;
+    };
+
+    void run(std::size_t index) {
+        std::unique_ptr<Context> context = make_context_(static_cast<unsigned>(index));
+        worker&                  self    = *workers_[index];
+        Job                      job;
+        while (true) {
+            self.queue.wait_dequeue(job);
+            if (!job) {
+                break;
+            }
+            handle_(*context, job);
+            job = Job{};
+            self.outstanding.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    context_factory                      make_context_;
+    handler                              handle_;
+    std::vector<std::unique_ptr<worker>> workers_;
+    std::size_t                          last_picked_ = 0;
+};
+
+} // namespace ILLIXR
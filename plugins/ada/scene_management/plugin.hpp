@@ -11,6 +11,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <map>
 
 namespace ILLIXR {
 class scene_management : public threadloop {
@@ -32,14 +33,18 @@ private:
     // switchboard::buffered_reader<data_format::draco_type> input_inactive_mesh_;
     // switchboard::buffered_reader<data_format::vb_type>    input_vb_lists_;
 
-    std::vector<switchboard::ptr<const data_format::draco_type>> pending_chunks_;
-    std::vector<switchboard::ptr<const data_format::vb_type>>    pending_clean_reqs_;
+    // a scene whose chunks are still arriving; they are merged into it one by one
+    struct pending_scene {
+        staged_scene staged;
+        double       merge_ms = 0.0;
+    };
+
+    std::map<unsigned, pending_scene>                         pending_scenes_;
+    std::vector<switchboard::ptr<const data_format::vb_type>> pending_clean_reqs_;
 
     spatial_hash grid_;
 
-    int      current_id_;
     int      last_processed_;
-    unsigned chunk_counter_;
     bool     mesh_processing_;
     bool     clean_waiting_;
     int      last_cleaned_;
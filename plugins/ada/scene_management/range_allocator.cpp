@@ -0,0 +1,85 @@
+#include "range_allocator.hpp"
+
+#include <climits>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+using namespace ILLIXR;
+
+void range_allocator::release(int first, int last) {
+    if (last < first) {
+        return;
+    }
+
+    auto next = by_first_.lower_bound(first);
+    if (next != by_first_.end() && next->first <= last) {
+        spdlog::get("illixr")->error("released range {} to {} overlaps free range {} to {}", first, last, next->first,
+                                     next->second);
+        return;
+    }
+    if (next != by_first_.begin()) {
+        auto previous = std::prev(next);
+        if (previous->second >= first) {
+            spdlog::get("illixr")->error("released range {} to {} overlaps free range {} to {}", first, last,
+                                         previous->first, previous->second);
+            return;
+        }
+        if (previous->second == first - 1) {
+            first = previous->first;
+            erase(previous);
+        }
+    }
+    if (next != by_first_.end() && next->first == last + 1) {
+        last = next->second;
+        erase(next);
+    }
+    insert(first, last);
+}
+
+std::optional<int> range_allocator::allocate(int count) {
+    if (count <= 0) {
+        return std::nullopt;
+    }
+    auto fit = by_size_.lower_bound({count, INT_MIN});
+    if (fit == by_size_.end()) {
+        return std::nullopt;
+    }
+
+    const int first = fit->second;
+    auto      range = by_first_.find(first);
+    const int last  = range->second;
+    erase(range);
+    if (last - first + 1 > count) {
+        insert(first + count, last);
+    }
+    return first;
+}
+
+void range_allocator::clear() {
+    by_first_.clear();
+    by_size_.clear();
+    free_faces_ = 0;
+}
+
+int range_allocator::largest_range() const {
+    return by_size_.empty() ? 0 : by_size_.rbegin()->first;
+}
+
+double range_allocator::fragmentation() const {
+    if (free_faces_ == 0) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(largest_range()) / static_cast<double>(free_faces_);
+}
+
+void range_allocator::insert(int first, int last) {
+    by_first_.emplace(first, last);
+    by_size_.emplace(last - first + 1, first);
+    free_faces_ += last - first + 1;
+}
+
+void range_allocator::erase(std::map<int, int>::iterator range) {
+    by_size_.erase({range->second - range->first + 1, range->first});
+    free_faces_ -= range->second - range->first + 1;
+    by_first_.erase(range);
+}
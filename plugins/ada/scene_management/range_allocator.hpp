@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+namespace ILLIXR {
+
+/**
+ * @brief Free list of face ranges in the scene mesh.
+ *
+ * Free ranges are kept both by position, to merge a released range with its free neighbours, and by size, to find the
+ * smallest range a voxel block fits in (best fit). Both allocate() and release() are O(log n) in the number of free
+ * ranges. Ranges are inclusive [first, last] face indices, as in map_VB_to_range_.
+ */
+class range_allocator {
+public:
+    /**
+     * @brief Returns the faces [first, last] to the free list, merging them with adjacent free ranges.
+     *
+     * Empty ranges are ignored; a range overlapping one that is already free is rejected and logged.
+     */
+    void release(int first, int last);
+
+    /**
+     * @brief Takes @p count faces from the smallest free range which holds them, preferring the lowest position.
+     * @return The first face of the allocation, or nullopt if no free range is large enough.
+     */
+    std::optional<int> allocate(int count);
+
+    void clear();
+
+    /// Free ranges by first face, mapping to their last face
+    [[nodiscard]] const std::map<int, int>& ranges() const {
+        return by_first_;
+    }
+
+    [[nodiscard]] std::size_t range_count() const {
+        return by_first_.size();
+    }
+
+    [[nodiscard]] long free_faces() const {
+        return free_faces_;
+    }
+
+    [[nodiscard]] int largest_range() const;
+
+    /**
+     * @brief Share of the free faces which are not in the largest free range: 0 when all free space is contiguous
+     * (or there is none), approaching 1 as it splinters into many small ranges.
+     */
+    [[nodiscard]] double fragmentation() const;
+
+private:
+    void insert(int first, int last);
+    void erase(std::map<int, int>::iterator range);
+
+    std::map<int, int>            by_first_;
+    std::set<std::pair<int, int>> by_size_; ///< (size, first)
+    long                          free_faces_ = 0;
+};
+
+} // namespace ILLIXR
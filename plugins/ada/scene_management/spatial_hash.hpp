@@ -1,34 +1,68 @@
 #pragma once
 
+#include "illixr/data_format/draco.hpp"
+#include "illixr/voxel_block_map.hpp"
+#include "range_allocator.hpp"
+
 #include <eigen3/Eigen/Dense>
 #include <set>
 #include <tuple>
 #include <vector>
 
 namespace ILLIXR {
-using VoxelBlockIndex = std::tuple<int, int, int>;
-// index of -1 mean it is cleaned, this should be the range of face
-using Vector_range = std::tuple<VoxelBlockIndex, int, int>;
-// vertices			colors
-using NewVB = std::tuple<VoxelBlockIndex, std::vector<Eigen::Vector3d>, std::vector<Eigen::Vector3d>>;
+// first and last face of a voxel block in the mesh; -1, -1 means it is cleaned
+using Face_range = std::pair<int, int>;
 
 // 9/2 used to store nullified ranges, first two are start and end indices of the nullified range, followed by the face vector
 // content using Nullified_Ranges = std::tuple<int, int, std::vector<Eigen::Vector3i>>;
 using Nullified_Ranges = std::tuple<int, int, std::vector<int>>;
 
+/// The faces of one voxel block in a scene: references to its vertices in each chunk it appeared in
+struct vb_parts {
+    std::vector<const data_format::vertex_array*> parts;
+    unsigned                                      vertex_count = 0;
+};
+
+/**
+ * @brief The voxel blocks of one scene, gathered chunk by chunk as the chunks arrive.
+ *
+ * The chunks are kept alive here and their vertices are only referenced; they are copied once, straight into the mesh,
+ * when the scene is placed. The block index is split into partitions, which are filled in parallel.
+ */
+class staged_scene {
+public:
+    static constexpr std::size_t partition_count = 16;
+
+    staged_scene();
+
+    void add_chunk(switchboard::ptr<const data_format::draco_type> chunk);
+
+    [[nodiscard]] std::size_t chunk_count() const {
+        return chunks_.size();
+    }
+
+    [[nodiscard]] const std::vector<voxel_block_map<vb_parts>>& partitions() const {
+        return partitions_;
+    }
+
+private:
+    static std::size_t partition_of(const VoxelBlockIndex& index);
+
+    std::vector<switchboard::ptr<const data_format::draco_type>> chunks_;
+    std::vector<voxel_block_map<vb_parts>>                       partitions_;
+
+    // the blocks of the chunk being added, by partition; kept to reuse their capacity
+    std::vector<std::vector<std::pair<VoxelBlockIndex, const data_format::vertex_array*>>> buckets_;
+};
+
 class spatial_hash {
 public:
     spatial_hash();
 
     [[maybe_unused]] void clean_mesh_vb_redesign_with_list(const std::set<std::tuple<int, int, int>>& vb_lists);
 
-    void deleted_ranges_processing();
-
-    // 91 changed to accept scene update mappings instead
-    void append_mesh_allocate(const std::unordered_map<unsigned, std::vector<NewVB>>& inputSceneUpdateMap);
-
-    unsigned        append_mesh_match_and_insert(bool merge);
-    static unsigned hash_vb(const VoxelBlockIndex& Index);
+    // places the VBs of a complete scene, packing them into deleted ranges first; returns the faces left unused there
+    unsigned append_mesh_match_and_insert(const staged_scene& scene, bool merge);
 
     void restore_deleted_faces();
 
@@ -36,16 +70,13 @@ public:
     [[maybe_unused]] void print_mesh_as_obj(unsigned frame_id, unsigned type, const std::string& tr);
 
     // 7/22
-    std::unordered_map<unsigned, std::vector<Vector_range>> map_VB_to_range_;
-    // this is tracking locally created vB sub-vectors?
-    std::unordered_map<unsigned, std::vector<NewVB>> allocate_new_VB_;
-    // changed to int since map_VB_to_range_ is int, int (needs to deal with deleted range)
-    // however deleted range should not be negative
-    std::vector<std::pair<int, int>> deleted_ranges_;
+    voxel_block_map<Face_range> map_VB_to_range_;
+    // free face ranges, from cleaned VBs; new VBs are packed into them before growing the mesh
+    range_allocator deleted_ranges_;
 
     // this is the internal data structure
-    std::vector<Eigen::Vector3d> vertices_;
-    // std::vector<Eigen::Vector3d> colors;
+    data_format::vertex_array vertices_;
+    // data_format::vertex_array colors;
     // std::vector<Eigen::Vector3i> faces;
     std::vector<int> faces_;
 
@@ -58,8 +89,9 @@ public:
     unsigned delete_counter_;
     unsigned VB_skipped_;
 
-    // 528 this is essentially creating a really large face so we can quickly generate the face vector
-    std::vector<int> faces_base_;
+private:
+    /// Writes the (trivial) vertex indices of faces [first_face, first_face + face_count) into faces_
+    void fill_face_indices(int first_face, int face_count);
 };
 
 [[maybe_unused]] void track_time(const std::string& message, const std::function<void()>& func);
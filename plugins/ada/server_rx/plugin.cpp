@@ -1,5 +1,7 @@
 #include "plugin.hpp"
 
+#include "../depth_planes.hpp"
+
 #include <spdlog/spdlog.h>
 
 using namespace ILLIXR;
@@ -61,14 +63,6 @@ namespace {
         spdlog::get("illixr")->error("[server_rx] Failed to open one or more log files.");
     }
 
-    /*const int width = 640;
-    const int height = 480;
-    msb_buf_.create(height, width, CV_8UC1);
-    lsb_buf_.create(height, width, CV_8UC1);
-    hi16_.create(height, width, CV_16U);
-    lo16_.create(height, width, CV_16U);
-    depth16_.create(height, width, CV_16U);*/
-
     cur_frame = 0;
 
     const char* env_var_name   = "FRAME_COUNT";
@@ -93,22 +87,18 @@ namespace {
 }
 
 void server_rx::_p_one_iteration() {
-    if (ada_reader_.size() > 0) {
-        auto                       buffer_ptr   = ada_reader_.dequeue();
-        std::string                buffer_str   = **buffer_ptr;
-        std::string::size_type     end_position = buffer_str.find(delimiter);
-        sr_input_proto::SRSendData sr_input;
-        bool                       success = sr_input.ParseFromString(buffer_str.substr(0, end_position));
-        if (!success) {
-            spdlog::get("illixr")->error("Error parsing the protobuf, vio input size = {}",
-                                         buffer_str.size() - delimiter.size());
-        } else {
-            spdlog::get("illixr")->debug("Pose of frame {}: {}, {}, {}; {}, {}, {}, {}", current_frame_no_,
-                                         sr_input.input_pose().p_x(), sr_input.input_pose().p_y(), sr_input.input_pose().p_z(),
-                                         sr_input.input_pose().o_w(), sr_input.input_pose().o_x(), sr_input.input_pose().o_y(),
-                                         sr_input.input_pose().o_z());
-            receive_sr_input(sr_input);
-        }
+    // Each event holds exactly one message (the backend frames them by length), so it is parsed in place
+    auto               buffer_ptr = ada_reader_.dequeue();
+    const std::string& buffer     = **buffer_ptr;
+    if (!sr_input_.ParseFromArray(buffer.data(), static_cast<int>(buffer.size()))) {
+        spdlog::get("illixr")->error("Error parsing the protobuf, vio input size = {}", buffer.size());
+    } else {
+        spdlog::get("illixr")->debug("Pose of frame {}: {}, {}, {}; {}, {}, {}, {}", current_frame_no_,
+                                     sr_input_.input_pose().p_x(), sr_input_.input_pose().p_y(),
+                                     sr_input_.input_pose().p_z(), sr_input_.input_pose().o_w(),
+                                     sr_input_.input_pose().o_x(), sr_input_.input_pose().o_y(),
+                                     sr_input_.input_pose().o_z());
+        receive_sr_input(sr_input_);
     }
 }
 
@@ -126,7 +116,7 @@ void server_rx::start() {
     threadloop::start();
 }
 
-void server_rx::receive_sr_input(const sr_input_proto::SRSendData& sr_input) {
+void server_rx::receive_sr_input(sr_input_proto::SRSendData& sr_input) {
 #ifndef NDEBUG
     spdlog::get("illixr")->debug("Received SR input frame {}/{}", current_frame_no_, frame_count_ - 1);
 #endif
@@ -145,9 +135,9 @@ void server_rx::receive_sr_input(const sr_input_proto::SRSendData& sr_input) {
 
     pose::head_pose_type pose = {time_point{}, incoming_position, incoming_orientation};
 
-    // Must do a deep copy of the received data (in the form of a string of bytes)
-    auto msb = const_cast<std::string&>(sr_input.depth_img_msb_data().img_data());
-    auto lsb = const_cast<std::string&>(sr_input.depth_img_lsb_data().img_data());
+    // The decoder copies the bitstreams into its own buffers, so they are handed over straight from the message
+    std::string& msb = *sr_input.mutable_depth_img_msb_data()->mutable_img_data();
+    std::string& lsb = *sr_input.mutable_depth_img_lsb_data()->mutable_img_data();
 
     receive_size << "MSB " << cur_frame << " " << sr_input.depth_img_msb_data().size() << "\n";
     receive_size << "LSB " << cur_frame << " " << sr_input.depth_img_lsb_data().size() << "\n";
@@ -159,9 +149,11 @@ void server_rx::receive_sr_input(const sr_input_proto::SRSendData& sr_input) {
         return img_ready_;
     });
 
-    img0_dst_.copyTo(msb_buf_);
-    img1_dst_.copyTo(lsb_buf_);
-    img_ready_ = false;
+    // These share the decoder's msb_owned_/lsb_owned_, which it overwrites on every frame. They are used without a copy
+    // only because the next frame is enqueued from this thread, after the merge below is done with them.
+    cv::Mat msb_plane = std::move(img0_dst_);
+    cv::Mat lsb_plane = std::move(img1_dst_);
+    img_ready_        = false;
     lock.unlock();
 
     auto depth_decoding_end = std::chrono::high_resolution_clock::now();
@@ -173,17 +165,16 @@ void server_rx::receive_sr_input(const sr_input_proto::SRSendData& sr_input) {
 
     auto combine_start = std::chrono::high_resolution_clock::now();
 
-    msb_buf_.convertTo(hi16_, CV_16U, 256.0);
-    lsb_buf_.convertTo(lo16_, CV_16U);
-
-    cv::bitwise_or(hi16_, lo16_, depth16_);
+    // Merged into a fresh image which is published as-is, rather than into a scratch buffer which must then be cloned
+    cv::Mat depth16;
+    merge_depth16(msb_plane, lsb_plane, depth16);
     auto   combine_end         = std::chrono::high_resolution_clock::now();
     auto   duration_combine    = std::chrono::duration_cast<std::chrono::microseconds>(combine_end - combine_start).count();
     double duration_combine_ms = static_cast<double>(duration_combine) / 1000.0;
     receive_time << "Combine " << cur_frame << " " << duration_combine_ms << "\n";
 
     cv::Mat rgb; // pyh dummy here
-    scannet_.put(scannet_.allocate<scene_recon_type>(scene_recon_type{time_point{}, pose, depth16_.clone(), rgb, false}));
+    scannet_.put(scannet_.allocate<scene_recon_type>(scene_recon_type{time_point{}, pose, depth16, rgb, false}));
 
     auto end         = std::chrono::high_resolution_clock::now();
     auto duration    = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
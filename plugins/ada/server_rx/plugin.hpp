@@ -16,7 +16,6 @@
 #include <filesystem>
 
 namespace ILLIXR {
-const std::string delimiter = "EEND!";
 
 class server_rx
     : public threadloop
@@ -25,7 +24,7 @@ public:
     [[maybe_unused]] server_rx(const std::string& name_, phonebook* pb_);
 
     skip_option _p_should_skip() override {
-        return skip_option::run;
+        return wait_for_data(ada_reader_);
     }
 
     void _p_one_iteration() override;
@@ -42,7 +41,7 @@ public:
     void start() override;
 
 private:
-    void receive_sr_input(const sr_input_proto::SRSendData& sr_input);
+    void receive_sr_input(sr_input_proto::SRSendData& sr_input);
 
     const std::shared_ptr<switchboard>                                    switchboard_;
     switchboard::writer<data_format::scene_recon_type>                    scannet_;
@@ -58,15 +57,8 @@ private:
     cv::Mat                            img0_dst_;
     cv::Mat                            img1_dst_;
 
-    // preallocated
-    cv::Mat msb_buf_; // CV_8UC1, 480x640
-    cv::Mat lsb_buf_; // CV_8UC1, 480x640
-    cv::Mat hi16_;    // CV_16U,  480x640
-    cv::Mat lo16_;    // CV_16U,  480x640
-    cv::Mat depth16_; // CV_16U,  480x640
-
-    std::vector<uint8_t> rx_buf_;
-    unsigned int         current_frame_no_ = 0;
+    sr_input_proto::SRSendData sr_input_; ///< Reused for every received frame
+    unsigned int               current_frame_no_ = 0;
 };
 
 } // namespace ILLIXR
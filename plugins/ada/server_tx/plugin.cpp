@@ -37,27 +37,26 @@ void server_tx::start() {
 }
 
 void server_tx::send_vb_list(switchboard::ptr<const vb_type> datum) {
-    auto start                 = std::chrono::high_resolution_clock::now();
-    server_outgoing_vb_payload = new sr_output_proto::CompressMeshData();
+    auto start = std::chrono::high_resolution_clock::now();
+    server_outgoing_vb_payload.Clear();
     spdlog::get("illixr")->debug("send vb");
     // 3 indicate vb_lists
-    server_outgoing_vb_payload->set_active(3);
-    server_outgoing_vb_payload->set_request_id(datum->scene_id);
+    server_outgoing_vb_payload.set_active(3);
+    server_outgoing_vb_payload.set_request_id(datum->scene_id);
     for (const auto& each_vb : datum->unique_VB_lists) {
         spdlog::get("illixr")->debug("Adding VB");
-        sr_output_proto::VB* new_vb = server_outgoing_vb_payload->add_vbs();
+        sr_output_proto::VB* new_vb = server_outgoing_vb_payload.add_vbs();
         new_vb->set_x(static_cast<int32_t>(std::get<0>(each_vb)));
         new_vb->set_y(static_cast<int32_t>(std::get<1>(each_vb)));
         new_vb->set_z(static_cast<int32_t>(std::get<2>(each_vb)));
     }
 
-    const size_t payload_size = server_outgoing_vb_payload->ByteSizeLong();
-
-    std::string buffer = server_outgoing_vb_payload->SerializeAsString() + delimiter;
-    spdlog::get("illixr")->debug("Sending vb {} {}", buffer.size(), buffer);
-    ada_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(buffer));
-
-    delete server_outgoing_vb_payload;
+    // The network backend frames every message with its length, so no delimiter is appended
+    std::string buffer;
+    server_outgoing_vb_payload.SerializeToString(&buffer);
+    const size_t payload_size = buffer.size();
+    spdlog::get("illixr")->debug("Sending vb {}", payload_size);
+    ada_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(buffer)));
 
     auto end         = std::chrono::high_resolution_clock::now();
     auto duration    = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
@@ -69,23 +68,23 @@ void server_tx::send_vb_list(switchboard::ptr<const vb_type> datum) {
 void server_tx::send_sr_output(switchboard::ptr<const mesh_type> datum) {
     auto start = std::chrono::high_resolution_clock::now();
     spdlog::get("illixr")->debug("send sr_out");
-    server_outgoing_payload = new sr_output_proto::CompressMeshData();
+    server_outgoing_payload.Clear();
 
-    auto* draco_owned = new std::string(reinterpret_cast<const char*>(datum->mesh.data()), datum->mesh.size());
-    server_outgoing_payload->set_allocated_draco_data(draco_owned);
+    // set_draco_data() reuses the capacity left over from the previous chunk
+    server_outgoing_payload.set_draco_data(reinterpret_cast<const char*>(datum->mesh.data()), datum->mesh.size());
 
-    server_outgoing_payload->set_active(2);
-    server_outgoing_payload->set_request_id(datum->id);
-    server_outgoing_payload->set_chunk_id(datum->chunk_id);
-    server_outgoing_payload->set_max_chunk(datum->max_chunk);
+    server_outgoing_payload.set_active(2);
+    server_outgoing_payload.set_request_id(datum->id);
+    server_outgoing_payload.set_chunk_id(datum->chunk_id);
+    server_outgoing_payload.set_max_chunk(datum->max_chunk);
     chunk_count++;
 
-    // Prepare data delivery
-    const size_t payload_size = server_outgoing_payload->ByteSizeLong();
-
-    std::string buffer = server_outgoing_payload->SerializeAsString() + delimiter;
-    spdlog::get("illixr")->debug("Sending sr {} {}", buffer.size(), buffer);
-    ada_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(buffer));
+    // Prepare data delivery; the network backend frames every message with its length, so no delimiter is appended
+    std::string buffer;
+    server_outgoing_payload.SerializeToString(&buffer);
+    const size_t payload_size = buffer.size();
+    spdlog::get("illixr")->debug("Sending sr {}", payload_size);
+    ada_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(buffer)));
 
     auto end         = std::chrono::high_resolution_clock::now();
     auto duration    = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
@@ -102,7 +101,6 @@ void server_tx::send_sr_output(switchboard::ptr<const mesh_type> datum) {
         sender_timestamp.flush();
     }
     sender_time.flush();
-    delete server_outgoing_payload;
 }
 
 PLUGIN_MAIN(server_tx)
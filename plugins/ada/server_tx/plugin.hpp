@@ -17,8 +17,6 @@
 
 using namespace ILLIXR;
 
-const std::string delimiter = "EEND!";
-
 class server_tx : public plugin {
 public:
     [[maybe_unused]] server_tx(const std::string& name_, phonebook* pb_);
@@ -30,9 +28,10 @@ public:
     void send_sr_output(switchboard::ptr<const data_format::mesh_type> datum);
 
 private:
+    // Each payload is only touched from its own topic's callback thread, and is reused (Clear()ed) between messages
     const std::shared_ptr<switchboard>                                   switchboard_;
-    sr_output_proto::CompressMeshData*                                   server_outgoing_payload;
-    sr_output_proto::CompressMeshData*                                   server_outgoing_vb_payload;
+    sr_output_proto::CompressMeshData                                    server_outgoing_payload;
+    sr_output_proto::CompressMeshData                                    server_outgoing_vb_payload;
     switchboard::network_writer<switchboard::event_wrapper<std::string>> ada_writer_;
 
     const std::string data_path = std::filesystem::current_path().string() + "/recorded_data";
@@ -8,17 +8,11 @@
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
 
-inline std::map<ullong, pose::head_pose_type> read_data(std::ifstream& gt_file, const std::string& file_name) {
+inline std::pair<ullong, pose::head_pose_type> parse_row(const data_row& row, const std::string& file_name) {
     (void) file_name;
-    std::map<ullong, pose::head_pose_type> data;
-
-    for (csv_iterator row{gt_file, 1}; row != csv_iterator{}; ++row) {
-        ullong             t = std::stoull(row[0]);
-        Eigen::Vector3f    av{std::stof(row[1]), std::stof(row[2]), std::stof(row[3])};
-        Eigen::Quaternionf la{std::stof(row[4]), std::stof(row[5]), std::stof(row[6]), std::stof(row[7])};
-        data[t] = {{}, av, la};
-    }
-    return data;
+    Eigen::Vector3f    av{std::stof(row[1]), std::stof(row[2]), std::stof(row[3])};
+    Eigen::Quaternionf la{std::stof(row[4]), std::stof(row[5]), std::stof(row[6]), std::stof(row[7])};
+    return {std::stoull(row[0]), {{}, av, la}};
 }
 
 [[maybe_unused]] ground_truth_slam::ground_truth_slam(const std::string& name, phonebook* pb)
@@ -26,8 +20,10 @@ inline std::map<ullong, pose::head_pose_type> read_data(std::ifstream& gt_file,
     , switchboard_{phonebook_->lookup_impl<switchboard>()}
     , true_pose_{switchboard_->get_writer<pose::head_pose_type>("true_pose")}
     , ground_truth_offset_{switchboard_->get_writer<switchboard::event_wrapper<Eigen::Vector3f>>("ground_truth_offset")}
-    , sensor_data_{load_data<pose::head_pose_type>("state_groundtruth_estimate0", "ground_truth_slam", &read_data,
-                                                   switchboard_)}
+    , sensor_data_{phonebook_->lookup_impl<dataset_loader>()->open<pose::head_pose_type>(
+          "ground_truth_slam/state_groundtruth_estimate0",
+          csv_dataset_source<pose::head_pose_type>(
+              dataset_path("state_groundtruth_estimate0", "ground_truth_slam", switchboard_), 1, &parse_row))}
     // The relative-clock timestamp of each IMU is the difference between its dataset time and the IMU dataset_first_time.
     // Therefore we need the IMU dataset_first_time to reproduce the real dataset time.
     // TODO: Change the hardcoded number to be read from some configuration variables in the yaml file.
@@ -45,8 +41,14 @@ void ground_truth_slam::start() {
 
 void ground_truth_slam::feed_ground_truth(const switchboard::ptr<const imu_type>& datum) {
     ullong rounded_time = datum->time.time_since_epoch().count() + dataset_first_time_;
-    auto   it           = sensor_data_.find(rounded_time);
-    if (it == sensor_data_.end()) {
+
+    // The IMU samples arrive in order, so the poses before this one are no longer needed
+    const dataset_stream<sensor_types>::row* it = sensor_data_->at(sensor_data_index_);
+    while (it != nullptr && it->first < rounded_time) {
+        it = sensor_data_->at(++sensor_data_index_);
+    }
+    sensor_data_->release_before(sensor_data_index_);
+    if (it == nullptr || it->first != rounded_time) {
 #ifndef NDEBUG
         spdlog::get(name_)->debug("True pose not found at timestamp: {}", rounded_time);
 #endif
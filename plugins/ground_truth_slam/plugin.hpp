@@ -29,7 +29,8 @@ private:
     switchboard::writer<data_format::pose::head_pose_type> true_pose_;
 
     switchboard::writer<switchboard::event_wrapper<Eigen::Vector3f>> ground_truth_offset_;
-    const std::map<ullong, sensor_types>                             sensor_data_;
+    const std::shared_ptr<dataset_stream<sensor_types>>              sensor_data_;
+    std::size_t                                                      sensor_data_index_ = 0;
     ullong                                                           dataset_first_time_;
     bool                                                             first_time_;
 };
@@ -3,47 +3,39 @@
 #include "illixr/data_loading.hpp"
 #include "illixr/iterators/csv_iterator.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <climits>
 #include <regex>
-#include <thread>
 
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
 
-// combine two maps into one
-std::map<ullong, sensor_types> make_map(const std::map<ullong, lazy_load_image>& cam0,
-                                        const std::map<ullong, lazy_load_image>& cam1) {
-    std::map<ullong, sensor_types> data;
-    for (auto& it : cam0) {
-        data[it.first].cam0 = it.second;
-    }
-    for (auto& it : cam1) {
-        data[it.first].cam1 = it.second;
-    }
-    return data;
+inline std::pair<ullong, lazy_load_image> parse_row(const data_row& row, const std::string& file_name) {
+    static const std::regex extension{"\\.csv"};
+    return {std::stoull(row[0]), lazy_load_image{std::regex_replace(file_name, extension, "/") + row[1]}};
 }
 
-inline std::map<ullong, lazy_load_image> read_data(std::ifstream& gt_file, const std::string& file_name) {
-    std::map<ullong, lazy_load_image> data;
-    auto                              name = std::regex_replace(file_name, std::regex("\\.csv"), "/");
-    for (csv_iterator row{gt_file, 1}; row != csv_iterator{}; ++row) {
-        ullong t = std::stoull(row[0]);
-        data[t]  = lazy_load_image{name + row[1]};
-    }
-    return data;
+std::shared_ptr<dataset_stream<lazy_load_image>> open_camera(const phonebook* pb, const std::shared_ptr<switchboard>& sb,
+                                                             const std::string& camera) {
+    return pb->lookup_impl<dataset_loader>()->open<lazy_load_image>(
+        "offline_cam/" + camera, csv_dataset_source<lazy_load_image>(dataset_path(camera, "offline_cam", sb), 1, &parse_row),
+        [](const lazy_load_image& image) {
+            return image.size_bytes();
+        });
 }
 
 [[maybe_unused]] offline_cam::offline_cam(const std::string& name, phonebook* pb)
     : threadloop{name, pb}
     , switchboard_{phonebook_->lookup_impl<switchboard>()}
     , cam_publisher_{switchboard_->get_writer<binocular_cam_type>("cam")}
-    , sensor_data_{make_map(load_data<lazy_load_image>("cam0", "offline_cam", &read_data, switchboard_),
-                            load_data<lazy_load_image>("cam1", "offline_cam", &read_data, switchboard_))}
-    , dataset_first_time_{sensor_data_.cbegin()->first}
+    , cam0_{open_camera(phonebook_, switchboard_, "cam0")}
+    , cam1_{open_camera(phonebook_, switchboard_, "cam1")}
+    , dataset_first_time_{0}
     , last_timestamp_{0}
-    , clock_{phonebook_->lookup_impl<relative_clock>()}
-    , next_row_{sensor_data_.cbegin()} {
+    , clock_{phonebook_->lookup_impl<relative_clock>()} {
     spdlogger(switchboard_->get_env_char("OFFLINE_CAM_LOG_LEVEL"));
+    clock_->add_time_source();
 }
 
 ILLIXR::threadloop::skip_option offline_cam::_p_should_skip() {
@@ -54,53 +46,75 @@ ILLIXR::threadloop::skip_option offline_cam::_p_should_skip() {
     }
 }
 
+std::optional<offline_cam::row> offline_cam::read_row() {
+    const auto* cam0 = cam0_->at(cam0_index_);
+    const auto* cam1 = cam1_->at(cam1_index_);
+    if (cam0 == nullptr && cam1 == nullptr) {
+        return std::nullopt;
+    }
+
+    const ullong time = std::min(cam0 != nullptr ? cam0->first : ULLONG_MAX, cam1 != nullptr ? cam1->first : ULLONG_MAX);
+    row          next{time, {}};
+    // Copy before releasing; the images are reference counted
+    if (cam0 != nullptr && cam0->first == time) {
+        next.second.cam0 = cam0->second;
+        cam0_->release_before(++cam0_index_);
+    }
+    if (cam1 != nullptr && cam1->first == time) {
+        next.second.cam1 = cam1->second;
+        cam1_->release_before(++cam1_index_);
+    }
+    return next;
+}
+
+void offline_cam::_p_thread_setup() {
+    current_row_ = read_row();
+    if (!current_row_) {
+        ILLIXR::abort("[offline_cam] The camera dataset is empty");
+    }
+    dataset_first_time_ = current_row_->first;
+    next_row_           = read_row();
+}
+
 void offline_cam::_p_one_iteration() {
     duration time_since_start = clock_->now().time_since_epoch();
-    // duration begin            = time_since_start;
-    ullong lookup_time = std::chrono::nanoseconds{time_since_start}.count() + dataset_first_time_;
-    std::map<ullong, sensor_types>::const_iterator nearest_row;
+    ullong   lookup_time      = std::chrono::nanoseconds{time_since_start}.count() + dataset_first_time_;
 
-    // "std::map::upper_bound" returns an iterator to the first pair whose key is GREATER than the argument.
-    auto after_nearest_row = sensor_data_.upper_bound(lookup_time);
+    // Most recent row at the lookup time; rows only ever move forward, so the ones before it can be dropped
+    while (next_row_ && next_row_->first <= lookup_time) {
+        current_row_ = std::move(next_row_);
+        next_row_    = read_row();
+    }
 
-    if (after_nearest_row == sensor_data_.cend()) {
+    if (!next_row_) {
 #ifndef NDEBUG
         spdlog::get(name_)->warn("Running out of the dataset! Time {} ({} + {}) after last datum {}", lookup_time,
-                                 clock_->now().time_since_epoch().count(), dataset_first_time_, sensor_data_.rbegin()->first);
+                                 clock_->now().time_since_epoch().count(), dataset_first_time_, current_row_->first);
 #endif
-        // Handling the last camera images. There's no more rows after the nearest_row, so we set after_nearest_row
-        // to be nearest_row to avoiding sleeping at the end.
-        nearest_row       = std::prev(after_nearest_row, 1);
-        after_nearest_row = nearest_row;
         // We are running out of the dataset and the loop will stop next time.
         internal_stop();
-    } else if (after_nearest_row == sensor_data_.cbegin()) {
-        // Should not happen because lookup_time is bigger than dataset_first_time_
-#ifndef NDEBUG
-        spdlog::get(name_)->warn("Time {} ({} + {}) before first datum {}", lookup_time,
-                                 clock_->now().time_since_epoch().count(), dataset_first_time_, sensor_data_.cbegin()->first);
-#endif
-    } else {
-        // Most recent
-        nearest_row = std::prev(after_nearest_row, 1);
     }
 
-    if (last_timestamp_ != nearest_row->first) {
-        last_timestamp_ = nearest_row->first;
+    if (last_timestamp_ != current_row_->first) {
+        last_timestamp_ = current_row_->first;
 
-        auto img0 = nearest_row->second.cam0.load();
-        auto img1 = nearest_row->second.cam1.load();
+        auto img0 = current_row_->second.cam0.load();
+        auto img1 = current_row_->second.cam1.load();
 
         time_point expected_real_time_given_dataset_time(
-            std::chrono::duration<long long, std::nano>{nearest_row->first - dataset_first_time_});
+            std::chrono::duration<long long, std::nano>{current_row_->first - dataset_first_time_});
         cam_publisher_.put(cam_publisher_.allocate<binocular_cam_type>(binocular_cam_type{
             expected_real_time_given_dataset_time,
             img0,
             img1,
         }));
     }
-    std::this_thread::sleep_for(std::chrono::nanoseconds(after_nearest_row->first - dataset_first_time_ -
-                                                         clock_->now().time_since_epoch().count() - 2));
+    if (!next_row_) {
+        clock_->remove_time_source();
+        return;
+    }
+    // Wait until the next row is due; the next lookup then lands exactly on it
+    clock_->advance_to(time_point{std::chrono::nanoseconds{next_row_->first - dataset_first_time_}});
 }
 
 PLUGIN_MAIN(offline_cam)
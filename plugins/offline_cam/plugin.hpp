@@ -7,6 +7,8 @@
 #include "illixr/threadloop.hpp"
 
 #include <opencv2/imgcodecs.hpp>
+#include <optional>
+#include <utility>
 
 namespace ILLIXR {
 
@@ -38,6 +40,11 @@ public:
         return mat_;
     }
 
+    /// Memory held by the image while it is loaded eagerly
+    [[nodiscard]] std::size_t size_bytes() const {
+        return mat_.total() * mat_.elemSize();
+    }
+
 private:
     std::string path_;
     cv::Mat     mat_;
@@ -52,15 +59,25 @@ class MY_EXPORT_API offline_cam : public threadloop {
 public:
     [[maybe_unused]] offline_cam(const std::string& name, phonebook* pb);
     skip_option _p_should_skip() override;
+    void        _p_thread_setup() override;
     void        _p_one_iteration() override;
 
 private:
+    using row = std::pair<ullong, sensor_types>;
+
+    // The next images of either camera, paired by timestamp
+    std::optional<row> read_row();
+
     const std::shared_ptr<switchboard>                   switchboard_;
     switchboard::writer<data_format::binocular_cam_type> cam_publisher_;
-    const std::map<ullong, sensor_types>                 sensor_data_;
+    std::shared_ptr<dataset_stream<lazy_load_image>>     cam0_;
+    std::shared_ptr<dataset_stream<lazy_load_image>>     cam1_;
+    std::size_t                                          cam0_index_ = 0;
+    std::size_t                                          cam1_index_ = 0;
     ullong                                               dataset_first_time_;
     ullong                                               last_timestamp_;
     std::shared_ptr<relative_clock>                      clock_;
-    std::map<ullong, sensor_types>::const_iterator       next_row_;
+    std::optional<row>                                   current_row_;
+    std::optional<row>                                   next_row_;
 };
 } // namespace ILLIXR
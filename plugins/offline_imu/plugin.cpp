@@ -8,53 +8,62 @@
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
 
-inline std::map<ullong, sensor_types> read_data(std::ifstream& gt_file, const std::string& file_name) {
+inline std::pair<ullong, sensor_types> parse_row(const data_row& row, const std::string& file_name) {
     (void) file_name;
-    std::map<ullong, sensor_types> data;
-
-    for (csv_iterator row{gt_file, 1}; row != csv_iterator{}; ++row) {
-        ullong          t = std::stoull(row[0]);
-        Eigen::Vector3d av{std::stod(row[1]), std::stod(row[2]), std::stod(row[3])};
-        Eigen::Vector3d la{std::stod(row[4]), std::stod(row[5]), std::stod(row[6])};
-        data[t].imu0 = {av, la};
-    }
-    return data;
+    Eigen::Vector3d av{std::stod(row[1]), std::stod(row[2]), std::stod(row[3])};
+    Eigen::Vector3d la{std::stod(row[4]), std::stod(row[5]), std::stod(row[6])};
+    return {std::stoull(row[0]), sensor_types{{av, la}}};
 }
 
 [[maybe_unused]] offline_imu::offline_imu(const std::string& name, phonebook* pb)
     : threadloop{name, pb}
     , switchboard_{phonebook_->lookup_impl<switchboard>()}
-    , sensor_data_{load_data<sensor_types>("imu0", "offline_imu", &read_data, switchboard_)}
-    , sensor_data_it_{sensor_data_.cbegin()}
+    , sensor_data_{phonebook_->lookup_impl<dataset_loader>()->open<sensor_types>(
+          "offline_imu/imu0",
+          csv_dataset_source<sensor_types>(dataset_path("imu0", "offline_imu", switchboard_), 1, &parse_row))}
     , imu_{switchboard_->get_writer<imu_type>("imu")}
-    , dataset_first_time_{sensor_data_it_->first}
+    , dataset_first_time_{0}
     , dataset_now_{0}
     , imu_cam_log_{record_logger_}
-    , clock_{phonebook_->lookup_impl<relative_clock>()} { }
+    , clock_{phonebook_->lookup_impl<relative_clock>()} {
+    clock_->add_time_source();
+}
+
+void offline_imu::_p_thread_setup() {
+    const auto* first = sensor_data_->at(0);
+    if (first == nullptr) {
+        ILLIXR::abort("[offline_imu] The IMU dataset is empty");
+    }
+    dataset_first_time_ = first->first;
+}
 
 ILLIXR::threadloop::skip_option offline_imu::_p_should_skip() {
-    if (sensor_data_it_ != sensor_data_.end()) {
-        assert(dataset_now_ < sensor_data_it_->first);
-        dataset_now_ = sensor_data_it_->first;
-        // Sleep for the difference between the current IMU vs 1st IMU and current UNIX time vs UNIX time the component was
-        // init
-        std::this_thread::sleep_for(std::chrono::nanoseconds{dataset_now_ - dataset_first_time_} -
-                                    clock_->now().time_since_epoch());
+    sensor_data_->release_before(sensor_data_index_);
+    current_row_ = sensor_data_->at(sensor_data_index_);
+    // Skip repeated timestamps, as the map the data used to be loaded into did
+    while (current_row_ != nullptr && current_row_->first <= dataset_now_ && sensor_data_index_ > 0) {
+        current_row_ = sensor_data_->at(++sensor_data_index_);
+    }
+    if (current_row_ != nullptr) {
+        dataset_now_ = current_row_->first;
+        // Wait until the clock reaches this IMU's offset from the 1st IMU
+        clock_->advance_to(time_point{std::chrono::nanoseconds{dataset_now_ - dataset_first_time_}});
 
         return skip_option::run;
 
     } else {
+        clock_->remove_time_source();
         return skip_option::stop;
     }
 }
 
 void offline_imu::_p_one_iteration() {
-    assert(sensor_data_it_ != sensor_data_.end());
+    assert(current_row_ != nullptr);
     time_point          real_now(std::chrono::duration<long long, std::nano>{dataset_now_ - dataset_first_time_});
-    const sensor_types& sensor_datum = sensor_data_it_->second;
+    const sensor_types& sensor_datum = current_row_->second;
 
     imu_.put(imu_.allocate<imu_type>(imu_type{real_now, (sensor_datum.imu0.angular_v), (sensor_datum.imu0.linear_a)}));
-    ++sensor_data_it_;
+    ++sensor_data_index_;
 }
 
 PLUGIN_MAIN(offline_imu)
@@ -2,13 +2,14 @@
 
 #include "illixr/data_format/imu.hpp"
 #include "illixr/data_format/misc.hpp"
+#include "illixr/dataset_loader.hpp"
 #include "illixr/managed_thread.hpp"
 #include "illixr/phonebook.hpp"
 #include "illixr/relative_clock.hpp"
 #include "illixr/switchboard.hpp"
 #include "illixr/threadloop.hpp"
 
-#include <map>
+#include <cstddef>
 
 namespace ILLIXR {
 
@@ -27,13 +28,15 @@ public:
 
 protected:
     skip_option _p_should_skip() override;
+    void        _p_thread_setup() override;
     void        _p_one_iteration() override;
 
 private:
-    const std::shared_ptr<switchboard>             switchboard_;
-    const std::map<ullong, sensor_types>           sensor_data_;
-    std::map<ullong, sensor_types>::const_iterator sensor_data_it_;
-    switchboard::writer<data_format::imu_type>     imu_;
+    const std::shared_ptr<switchboard>                  switchboard_;
+    const std::shared_ptr<dataset_stream<sensor_types>> sensor_data_;
+    std::size_t                                         sensor_data_index_ = 0;
+    const dataset_stream<sensor_types>::row*            current_row_       = nullptr;
+    switchboard::writer<data_format::imu_type>          imu_;
 
     // Timestamp of the first IMU value from the dataset
     ullong dataset_first_time_;
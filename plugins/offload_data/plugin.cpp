@@ -1,8 +1,10 @@
 #include "plugin.hpp"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
+#include <chrono>
+#include <cmath>
 #include <fstream>
-#include <numeric>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #pragma GCC diagnostic ignored "-Wsign-compare"
@@ -12,15 +14,37 @@
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
 
+namespace {
+// how long an idle writer waits for a frame before checking whether it should stop
+constexpr std::chrono::milliseconds idle_wait{100};
+} // namespace
+
 [[maybe_unused]] offload_data::offload_data(const std::string& name, phonebook* pb)
     : plugin{name, pb}
     , switchboard_{phonebook_->lookup_impl<switchboard>()}
-    , percent_{0}
     , img_idx_{0}
     , enable_offload_{switchboard_->get_env_bool("ILLIXR_OFFLOAD_ENABLE", "False")}
-    , is_success_{true} /// TODO: Set with #198
-    , obj_dir_{switchboard_->get_env_char("ILLIXR_OFFLOAD_PATH", "metrics/offloaded_data/")} {
+    , obj_dir_{switchboard_->get_env_char("ILLIXR_OFFLOAD_PATH", "metrics/offloaded_data/")}
+    , free_slots_{static_cast<ssize_t>(std::max(switchboard_->get_env_ulong("OFFLOAD_DATA_QUEUE_DEPTH", 16), 1ul))} {
     spdlogger(switchboard_->get_env_char("OFFLOAD_DATA_LOG_LEVEL"));
+    if (!enable_offload_) {
+        return;
+    }
+
+    boost::filesystem::path p(obj_dir_);
+    boost::filesystem::remove_all(p);
+    boost::filesystem::create_directories(p);
+
+    // Set before the writers start, as stb keeps it in a global
+    stbi_flip_vertically_on_write(true);
+    const unsigned      default_writers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    const unsigned long writer_count    = std::max(switchboard_->get_env_ulong("OFFLOAD_DATA_WRITERS", default_writers), 1ul);
+    for (unsigned long i = 0; i < writer_count; ++i) {
+        writers_.emplace_back([this] {
+            write_frames();
+        });
+    }
+
     switchboard_->schedule<pose::texture_pose>(id_, "texture_pose",
                                                [&](const switchboard::ptr<const pose::texture_pose>& datum, size_t) {
                                                    callback(datum);
@@ -29,37 +53,47 @@ using namespace ILLIXR::data_format;
 
 void offload_data::callback(const switchboard::ptr<const pose::texture_pose>& datum) {
 #ifndef NDEBUG
-    spdlog::get(name_)->debug("Image index: {}", img_idx_++);
+    spdlog::get(name_)->debug("Image index: {}", img_idx_);
 #endif
-    /// A texture pose is present. Store it back to our container.
-    offload_data_container_.push_back(datum);
+    // Collecting time for the frame, folded into the running statistics
+    const long time =
+        std::chrono::duration_cast<std::chrono::duration<long, std::milli>>(datum->offload_duration).count();
+    time_seq_.push_back(time);
+    const double delta = static_cast<double>(time) - time_mean_;
+    time_mean_ += delta / static_cast<double>(time_seq_.size());
+    time_m2_ += delta * (static_cast<double>(time) - time_mean_);
+
+    // Wait for room if the writers are behind, so that only a bounded number of frames is ever held
+    free_slots_.wait();
+    jobs_.enqueue({datum, img_idx_++});
 }
 
 offload_data::~offload_data() {
-    // Write offloaded data from memory to disk
-    if (enable_offload_) {
-        boost::filesystem::path p(obj_dir_);
-        boost::filesystem::remove_all(p);
-        boost::filesystem::create_directories(p);
+    if (!enable_offload_) {
+        return;
+    }
 
-        write_data_to_disk();
+    // Only the frames still queued are left to write
+    stop_.store(true);
+    for (auto& writer : writers_) {
+        writer.join();
     }
+    spdlog::get(name_)->info("Wrote {} offloaded images to {}", img_idx_, obj_dir_);
+    write_metadata();
 }
 
 void offload_data::write_metadata() {
-    double mean  = std::accumulate(time_seq_.begin(), time_seq_.end(), 0.0) / static_cast<double>(time_seq_.size());
-    double accum = 0.0;
-    std::for_each(std::begin(time_seq_), std::end(time_seq_), [&](const double d) {
-        accum += (d - mean) * (d - mean);
-    });
-    double stdev = sqrt(accum / static_cast<double>((time_seq_.size() - 1)));
+    if (time_seq_.empty()) {
+        return;
+    }
+    const double stdev = time_seq_.size() > 1 ? std::sqrt(time_m2_ / static_cast<double>(time_seq_.size() - 1)) : 0.0;
 
     auto max = std::max_element(time_seq_.begin(), time_seq_.end());
     auto min = std::min_element(time_seq_.begin(), time_seq_.end());
 
     std::ofstream meta_file(obj_dir_ + "metadata.out");
     if (meta_file.is_open()) {
-        meta_file << "mean: " << mean << std::endl;
+        meta_file << "mean: " << time_mean_ << std::endl;
         meta_file << "max: " << *max << std::endl;
         meta_file << "min: " << *min << std::endl;
         meta_file << "stdev: " << stdev << std::endl;
@@ -71,7 +105,7 @@ void offload_data::write_metadata() {
         meta_file << std::endl << std::endl << std::endl;
 
         meta_file << "ordered time: " << std::endl;
-        std::sort(time_seq_.begin(), time_seq_.end(), [](int x, int y) {
+        std::sort(time_seq_.begin(), time_seq_.end(), [](long x, long y) {
             return x > y;
         });
         for (long& it : time_seq_)
@@ -80,67 +114,68 @@ void offload_data::write_metadata() {
     meta_file.close();
 }
 
-void offload_data::write_data_to_disk() {
-    stbi_flip_vertically_on_write(true);
-
-    spdlog::get(name_)->info("Writing offloaded images to disk...");
-    img_idx_ = 0;
-    for (auto& container_it : offload_data_container_) {
-        // Get collecting time for each frame
-        time_seq_.push_back(
-            std::chrono::duration_cast<std::chrono::duration<long, std::milli>>(container_it->offload_duration).count());
-
-        std::string image_name = obj_dir_ + std::to_string(img_idx_) + ".png";
-        std::string pose_name  = obj_dir_ + std::to_string(img_idx_) + ".txt";
-
-        // Write image
-        is_success_ = stbi_write_png(image_name.c_str(), display_params::width_pixels, display_params::height_pixels, 3,
-                                     container_it->image, 0);
-        if (!is_success_) {
-            ILLIXR::abort("Image create failed !!! ");
+void offload_data::write_frames() {
+    frame_job job;
+    while (true) {
+        if (jobs_.wait_dequeue_timed(job, idle_wait)) {
+            write_frame(job);
+            job.datum = nullptr;
+            free_slots_.signal();
+            continue;
         }
-
-        // Write pose
-        std::ofstream pose_file(pose_name);
-        if (pose_file.is_open()) {
-            // Transfer timestamp to duration
-            auto duration = (container_it->pose_time).time_since_epoch().count();
-
-            // Write time data
-            pose_file << "strTime: " << duration << std::endl;
-
-            // Write position coordinates in x y z
-            int pose_size = static_cast<int>(container_it->position.size());
-            pose_file << "pos: ";
-            for (int pos_idx = 0; pos_idx < pose_size; pos_idx++)
-                pose_file << container_it->position(pos_idx) << " ";
-            pose_file << std::endl;
-
-            // Write quaternion in w x y z
-            pose_file << "latest_pose_orientation: ";
-            pose_file << container_it->latest_quaternion.w() << " ";
-            pose_file << container_it->latest_quaternion.x() << " ";
-            pose_file << container_it->latest_quaternion.y() << " ";
-            pose_file << container_it->latest_quaternion.z() << std::endl;
-
-            pose_file << "render_pose_orientation: ";
-            pose_file << container_it->render_quaternion.w() << " ";
-            pose_file << container_it->render_quaternion.x() << " ";
-            pose_file << container_it->render_quaternion.y() << " ";
-            pose_file << container_it->render_quaternion.z();
+        if (stop_.load()) {
+            while (jobs_.try_dequeue(job)) {
+                write_frame(job);
+                job.datum = nullptr;
+                free_slots_.signal();
+            }
+            return;
         }
-        pose_file.close();
-
-        // Print progress
-        percent_ = static_cast<int>(100 * (img_idx_ + 1) / offload_data_container_.size());
-        std::cout << "\r"
-                  << "[" << std::string(percent_ / 2, (char) 61u) << std::string(100 / 2 - percent_ / 2, ' ') << "] ";
-        std::cout << percent_ << "%"
-                  << " [Image " << img_idx_++ << " of " << offload_data_container_.size() << "]";
-        std::cout.flush();
     }
-    std::cout << std::endl;
-    write_metadata();
+}
+
+void offload_data::write_frame(const frame_job& job) {
+    const pose::texture_pose& frame      = *job.datum;
+    std::string               image_name = obj_dir_ + std::to_string(job.index) + ".png";
+    std::string               pose_name  = obj_dir_ + std::to_string(job.index) + ".txt";
+
+    // Write image
+    const int is_success = stbi_write_png(image_name.c_str(), display_params::width_pixels, display_params::height_pixels, 3,
+                                          frame.image.get(), 0);
+    if (!is_success) {
+        ILLIXR::abort("Image create failed !!! ");
+    }
+
+    // Write pose
+    std::ofstream pose_file(pose_name);
+    if (pose_file.is_open()) {
+        // Transfer timestamp to duration
+        auto duration = frame.pose_time.time_since_epoch().count();
+
+        // Write time data
+        pose_file << "strTime: " << duration << std::endl;
+
+        // Write position coordinates in x y z
+        int pose_size = static_cast<int>(frame.position.size());
+        pose_file << "pos: ";
+        for (int pos_idx = 0; pos_idx < pose_size; pos_idx++)
+            pose_file << frame.position(pos_idx) << " ";
+        pose_file << std::endl;
+
+        // Write quaternion in w x y z
+        pose_file << "latest_pose_orientation: ";
+        pose_file << frame.latest_quaternion.w() << " ";
+        pose_file << frame.latest_quaternion.x() << " ";
+        pose_file << frame.latest_quaternion.y() << " ";
+        pose_file << frame.latest_quaternion.z() << std::endl;
+
+        pose_file << "render_pose_orientation: ";
+        pose_file << frame.render_quaternion.w() << " ";
+        pose_file << frame.render_quaternion.x() << " ";
+        pose_file << frame.render_quaternion.y() << " ";
+        pose_file << frame.render_quaternion.z();
+    }
+    pose_file.close();
 }
 
 PLUGIN_MAIN(offload_data)
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "illixr/concurrentqueue/blockingconcurrentqueue.hpp"
+#include "illixr/concurrentqueue/lightweightsemaphore.hpp"
 #include "illixr/data_format/poses/head_pose.hpp"
 #include "illixr/error_util.hpp"
 #include "illixr/global_module_defs.hpp"
@@ -7,6 +9,10 @@
 #include "illixr/plugin.hpp"
 #include "illixr/switchboard.hpp"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 namespace ILLIXR {
 class offload_data : public plugin {
 public:
@@ -15,17 +21,29 @@ public:
     ~offload_data() override;
 
 private:
+    struct frame_job {
+        switchboard::ptr<const data_format::pose::texture_pose> datum;
+        int                                                     index = 0;
+    };
+
     void write_metadata();
-    void write_data_to_disk();
+    void write_frames();
+    void write_frame(const frame_job& job);
 
-    const std::shared_ptr<switchboard>                                   switchboard_;
-    std::vector<long>                                                    time_seq_;
-    std::vector<switchboard::ptr<const data_format::pose::texture_pose>> offload_data_container_;
+    const std::shared_ptr<switchboard> switchboard_;
+    std::vector<long>                  time_seq_;
+
+    // Collecting time statistics, updated as frames arrive
+    double time_mean_ = 0.0;
+    double time_m2_   = 0.0; ///< Sum of squared differences from the mean (Welford)
 
-    int         percent_;
     int         img_idx_;
     bool        enable_offload_;
-    bool        is_success_;
     std::string obj_dir_;
+
+    moodycamel::BlockingConcurrentQueue<frame_job> jobs_;
+    moodycamel::LightweightSemaphore               free_slots_; ///< Bounds the frames held in memory
+    std::atomic<bool>                              stop_{false};
+    std::vector<std::thread>                       writers_;
 };
 } // namespace ILLIXR
@@ -21,22 +21,17 @@ using namespace ILLIXR::data_format;
 }
 
 ILLIXR::threadloop::skip_option offload_reader::_p_should_skip() {
-    return skip_option::run;
+    return wait_for_data(vio_pose_reader_);
 }
 
 void offload_reader::_p_one_iteration() {
-    if (vio_pose_reader_.size() > 0) {
-        auto                   buffer_ptr   = vio_pose_reader_.dequeue();
-        std::string            buffer_str   = **buffer_ptr;
-        std::string::size_type end_position = buffer_str.find(delimiter);
-        // process the data
-        vio_output_proto::VIOOutput vio_output;
-        bool                        success = vio_output.ParseFromString(buffer_str.substr(0, end_position));
-        if (success) {
-            receive_vio_output(vio_output);
-        } else {
-            spdlog::get(name_)->error("[offload_vio.device_rx: Cannot parse VIO output!!");
-        }
+    // Each event holds exactly one message (the backend frames them by length), so it is parsed in place
+    auto               buffer_ptr = vio_pose_reader_.dequeue();
+    const std::string& buffer     = **buffer_ptr;
+    if (vio_output_.ParseFromArray(buffer.data(), static_cast<int>(buffer.size()))) {
+        receive_vio_output(vio_output_);
+    } else {
+        spdlog::get(name_)->error("[offload_vio.device_rx: Cannot parse VIO output!!");
     }
 }
 
@@ -29,9 +29,8 @@ private:
     switchboard::writer<data_format::pose::head_pose_type>                pose_;
     switchboard::writer<data_format::imu_integrator_input>                imu_integrator_input_;
 
-    network::TCPSocket socket_;
-    std::string        server_ip_;
-
-    std::string delimiter = "END!";
+    network::TCPSocket          socket_;
+    std::string                 server_ip_;
+    vio_output_proto::VIOOutput vio_output_; ///< Reused for every received message
 };
 } // namespace ILLIXR
@@ -27,20 +27,19 @@ using namespace ILLIXR::data_format;
 void offload_writer::start() {
     threadloop::start();
 
+    // Runs on the GStreamer thread. The maps are only valid for the duration of the call, so the bitstreams are copied
+    // into the oldest frame still waiting for them and later moved, not copied again, into the outgoing message.
     encoder_ = std::make_unique<vio_video_encoder>([this](const GstMapInfo& img0, const GstMapInfo& img1) {
-        queue_.consume_one([&](uint64_t& timestamp) {
-            (void) timestamp;
-            uint64_t curr =
-                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
-                    .count();
-        });
-        {
-            std::lock_guard<std::mutex> lock{mutex_};
-            this->img0_ = img0;
-            this->img1_ = img1;
-            img_ready_  = true;
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto& frame : frames_in_flight_) {
+            if (!frame.encoded) {
+                frame.img0.assign(reinterpret_cast<const char*>(img0.data), img0.size);
+                frame.img1.assign(reinterpret_cast<const char*>(img1.data), img1.size);
+                frame.encoded = true;
+                return;
+            }
         }
-        condition_var_.notify_one();
+        log_->warn("[offload_vio.device_tx] Encoder produced a frame with none in flight, dropping it");
     });
     encoder_->init();
 
@@ -55,23 +54,68 @@ void offload_writer::_p_one_iteration() {
     }
 }
 
-void offload_writer::send_imu_cam_data(std::optional<time_point>& cam_time) {
-    data_buffer_->set_real_timestamp(
+void offload_writer::send_imu_cam_data(const std::optional<time_point>& cam_time) {
+    data_buffer_.set_real_timestamp(
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-    data_buffer_->set_frame_id(frame_id_);
+    data_buffer_.set_frame_id(frame_id_);
 
-    std::string data_to_be_sent = data_buffer_->SerializeAsString();
-    std::string delimiter       = "EEND!";
+    // The network backend frames every message with its length, so no delimiter is appended
+    std::string data_to_be_sent;
+    data_buffer_.SerializeToString(&data_to_be_sent);
 
-    log_->info("{},{}", cam_time.value().time_since_epoch().count(),
-               (double) (clock_->now().time_since_epoch().count() - cam_time.value().time_since_epoch().count()) / 1e6);
-    // socket.write(data_to_be_sent + delimitter);
-    imu_cam_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(data_to_be_sent + delimiter));
+    if (cam_time) {
+        log_->info("{},{}", cam_time.value().time_since_epoch().count(),
+                   (double) (clock_->now().time_since_epoch().count() - cam_time.value().time_since_epoch().count()) /
+                       1e6);
+        frame_id_++;
+    }
+    imu_cam_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(data_to_be_sent)));
 
-    frame_id_++;
-    delete data_buffer_;
-    data_buffer_ = new vio_input_proto::IMUCamVec();
-    cam_time.reset();
+    // Clear() keeps the allocated sub-messages and image buffers, so the next frame fills them in place
+    data_buffer_.Clear();
+}
+
+void offload_writer::admit_cam_frames() {
+    while (cam_.size() != 0) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (frames_in_flight_.size() >= max_frames_in_flight_) {
+                return;
+            }
+        }
+
+        switchboard::ptr<const binocular_cam_type> cam = cam_.dequeue();
+
+        // Shallow headers: the encoder and the frame buffers copy the pixels out, so no clone() is needed
+        cv::Mat cam_img0 = cam->at(image::LEFT_EYE);
+        cv::Mat cam_img1 = cam->at(image::RIGHT_EYE);
+
+        pending_frame frame{cam->time, cam_img0.rows, cam_img0.cols};
+#ifndef USE_COMPRESSION
+        const auto cam_img0_size = static_cast<std::size_t>(cam_img0.rows * cam_img0.cols);
+        frame.img0.assign(reinterpret_cast<const char*>(cam_img0.data), cam_img0_size);
+        frame.img1.assign(reinterpret_cast<const char*>(cam_img1.data), cam_img0_size);
+        frame.encoded = true;
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            frames_in_flight_.push_back(std::move(frame));
+        }
+#ifdef USE_COMPRESSION
+        // Only pushes the images into the pipeline; the result arrives through the encoder callback
+        encoder_->enqueue(cam_img0, cam_img1);
+#endif
+    }
+}
+
+void offload_writer::attach_cam_data(pending_frame& frame) {
+    vio_input_proto::CamData* cam_data = data_buffer_.mutable_cam_data();
+    cam_data->set_timestamp(frame.time.time_since_epoch().count());
+    cam_data->set_rows(frame.rows);
+    cam_data->set_cols(frame.cols);
+    cam_data->set_img0_data(std::move(frame.img0));
+    cam_data->set_img1_data(std::move(frame.img1));
 }
 
 void offload_writer::prepare_imu_cam_data(switchboard::ptr<const imu_type> datum) {
@@ -85,82 +129,37 @@ void offload_writer::prepare_imu_cam_data(switchboard::ptr<const imu_type> datum
     assert(datum->time > latest_imu_time_);
     latest_imu_time_ = datum->time;
 
-    vio_input_proto::IMUData* imu_data = data_buffer_->add_imu_data();
+    vio_input_proto::IMUData* imu_data = data_buffer_.add_imu_data();
     imu_data->set_timestamp(datum->time.time_since_epoch().count());
 
-    auto* angular_vel = new vio_input_proto::Vec3();
+    vio_input_proto::Vec3* angular_vel = imu_data->mutable_angular_vel();
     angular_vel->set_x(datum->angular_v.x());
     angular_vel->set_y(datum->angular_v.y());
     angular_vel->set_z(datum->angular_v.z());
-    imu_data->set_allocated_angular_vel(angular_vel);
 
-    auto* linear_accel = new vio_input_proto::Vec3();
+    vio_input_proto::Vec3* linear_accel = imu_data->mutable_linear_accel();
     linear_accel->set_x(datum->linear_a.x());
     linear_accel->set_y(datum->linear_a.y());
     linear_accel->set_z(datum->linear_a.z());
-    imu_data->set_allocated_linear_accel(linear_accel);
-
-    if (latest_cam_time_ && latest_imu_time_ > latest_cam_time_) {
-        send_imu_cam_data(latest_cam_time_);
-    }
-
-    switchboard::ptr<const binocular_cam_type> cam;
-
-    if (cam_.size() != 0 && !latest_cam_time_) {
-        cam = cam_.dequeue();
-
-        cv::Mat cam_img0      = (cam->at(image::LEFT_EYE)).clone();
-        cv::Mat cam_img1      = (cam->at(image::RIGHT_EYE)).clone();
-        int     cam_img0_size = cam_img0.rows * cam_img0.cols;
 
-        auto* cam_data = new vio_input_proto::CamData();
-        cam_data->set_timestamp(cam->time.time_since_epoch().count());
-        cam_data->set_rows(cam_img0.rows);
-        cam_data->set_cols(cam_img0.cols);
-
-#ifdef USE_COMPRESSION
-        /** WITH COMPRESSION **/
-        uint64_t curr =
-            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-        queue_.push(curr);
-        std::unique_lock<std::mutex> lock{mutex_};
-        encoder_->enqueue(cam_img0, cam_img1);
-        condition_var_.wait(lock, [this]() {
-            return img_ready_;
-        });
-        img_ready_ = false;
-
-        sizes_.push_back((int) this->img0_.size);
-
-        // calculate average sizes
-        // if (sizes_.size() > 100) {
-        //    int32_t sum = 0;
-        //    for (auto& s : sizes_) {
-        //        sum += s;
-        //    }
-        // For debugging, prints out average image size after compression and compression ratio
-        // std::cout << "compression ratio: " << img0_size / (sum / sizes_.size()) << " average size after compression "
-        // << sum / sizes_.size() << std::endl;
-        //}
-
-        cam_data->set_img0_data((void*) this->img0_.data, this->img0_.size);
-        cam_data->set_img1_data((void*) this->img1_.data, this->img1_.size);
+    admit_cam_frames();
 
+    // A frame goes out with the first IMU sample past it, so that the server can integrate up to the frame. This
+    // callback never waits for the encoder: while the oldest frame is still being encoded, IMU samples past it are sent
+    // on their own rather than held back behind the video.
+    std::unique_lock<std::mutex> lock{mutex_};
+    if (frames_in_flight_.empty() || latest_imu_time_ <= frames_in_flight_.front().time) {
+        return;
+    }
+    if (frames_in_flight_.front().encoded) {
+        pending_frame frame = std::move(frames_in_flight_.front());
+        frames_in_flight_.pop_front();
         lock.unlock();
-        /** WITH COMPRESSION END **/
-#else
-        /** NO COMPRESSION **/
-        cam_data->set_img0_data((void*) cam_img0.data, cam_img0_size);
-        cam_data->set_img1_data((void*) cam_img1.data, cam_img0_size);
-        /** NO COMPRESSION END **/
-#endif
-        data_buffer_->set_allocated_cam_data(cam_data);
-        latest_cam_time_ = cam->time;
-        if (latest_imu_time_ <= latest_cam_time_) {
-            return;
-        } else {
-            send_imu_cam_data(latest_cam_time_);
-        }
+        attach_cam_data(frame);
+        send_imu_cam_data(frame.time);
+    } else {
+        lock.unlock();
+        send_imu_cam_data(std::nullopt);
     }
 }
 
@@ -16,14 +16,15 @@
     #include "../proto/input_stub.hpp"
 #endif
 
-#include <boost/lockfree/spsc_queue.hpp>
+#include <deque>
+#include <mutex>
 
 namespace ILLIXR {
 class offload_writer : public threadloop {
 public:
     [[maybe_unused]] offload_writer(const std::string& name, phonebook* pb);
     void start() override;
-    void send_imu_cam_data(std::optional<time_point>& cam_time);
+    void send_imu_cam_data(const std::optional<time_point>& cam_time);
     void prepare_imu_cam_data(switchboard::ptr<const data_format::imu_type> datum);
 
 protected:
@@ -32,19 +33,32 @@ protected:
     void _p_one_iteration() override;
 
 private:
-    boost::lockfree::spsc_queue<uint64_t> queue_{1000};
-    std::vector<int32_t>                  sizes_;
-    std::mutex                            mutex_;
-    std::condition_variable               condition_var_;
-    GstMapInfo                            img0_{};
-    GstMapInfo                            img1_{};
-    bool                                  img_ready_ = false;
+    /**
+     * A camera frame which has been taken off the `cam` topic but not sent yet. Under compression the bitstreams are
+     * filled in by the encoder callback, on the GStreamer thread.
+     */
+    struct pending_frame {
+        time_point  time;
+        int         rows = 0;
+        int         cols = 0;
+        std::string img0;
+        std::string img1;
+        bool        encoded = false;
+    };
+
+    void admit_cam_frames();
+    void attach_cam_data(pending_frame& frame);
+
+    // Frames handed to the encoder but not sent yet; more than this and new frames wait on the `cam` topic
+    static constexpr std::size_t max_frames_in_flight_ = 2;
+
+    std::mutex                mutex_; ///< Guards frames_in_flight_
+    std::deque<pending_frame> frames_in_flight_;
 
     std::unique_ptr<vio_video_encoder>                                   encoder_ = nullptr;
     std::optional<time_point>                                            latest_imu_time_;
-    std::optional<time_point>                                            latest_cam_time_;
-    int                                                                  frame_id_    = 0;
-    vio_input_proto::IMUCamVec*                                          data_buffer_ = new vio_input_proto::IMUCamVec();
+    int                                                                  frame_id_ = 0;
+    vio_input_proto::IMUCamVec                                           data_buffer_; ///< Reused (Clear()ed) every frame
     const std::shared_ptr<switchboard>                                   switchboard_;
     const std::shared_ptr<relative_clock>                                clock_;
     const std::shared_ptr<stoplight>                                     stoplight_;
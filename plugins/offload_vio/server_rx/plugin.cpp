@@ -20,22 +20,17 @@ using namespace ILLIXR::data_format;
 }
 
 ILLIXR::threadloop::skip_option server_reader::_p_should_skip() {
-    return skip_option::run;
+    return wait_for_data(imu_cam_reader_);
 }
 
 void server_reader::_p_one_iteration() {
-    if (imu_cam_reader_.size() > 0) {
-        auto                       buffer_ptr   = imu_cam_reader_.dequeue();
-        std::string                buffer_str   = **buffer_ptr;
-        std::string::size_type     end_position = buffer_str.find(delimiter_);
-        vio_input_proto::IMUCamVec vio_input;
-        bool                       success = vio_input.ParseFromString(buffer_str.substr(0, end_position));
-        if (!success) {
-            log_->error("[offload_vio.server_rx]Error parsing the protobuf, vio input size = {}",
-                        buffer_str.size() - delimiter_.size());
-        } else {
-            receive_vio_input(vio_input);
-        }
+    // Each event holds exactly one message (the backend frames them by length), so it is parsed in place
+    auto               buffer_ptr = imu_cam_reader_.dequeue();
+    const std::string& buffer     = **buffer_ptr;
+    if (!vio_input_.ParseFromArray(buffer.data(), static_cast<int>(buffer.size()))) {
+        log_->error("[offload_vio.server_rx]Error parsing the protobuf, vio input size = {}", buffer.size());
+    } else {
+        receive_vio_input(vio_input_);
     }
 }
 
@@ -51,9 +46,10 @@ void server_reader::start() {
             // std::cout << "=== latency: " << (curr - timestamp) / 1000000.0 << std::endl;
         });
         {
+            // The images wrap the decoder's mapped GStreamer buffers, which are released when this callback returns
             std::lock_guard<std::mutex> lock{mutex_};
-            this->img0_dst_ = std::forward<cv::Mat>(img0);
-            this->img1_dst_ = std::forward<cv::Mat>(img1);
+            this->img0_dst_ = img0.clone();
+            this->img1_dst_ = img1.clone();
             img_ready_      = true;
         }
         condition_variable_.notify_one();
@@ -61,28 +57,28 @@ void server_reader::start() {
     decoder_->init();
 }
 
-void server_reader::receive_vio_input(const vio_input_proto::IMUCamVec& vio_input) {
+void server_reader::receive_vio_input(vio_input_proto::IMUCamVec& vio_input) {
     // Logging the transmitting time
     unsigned long long curr_time =
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     double msec_to_trans = (curr_time - vio_input.real_timestamp()) / 1e6;
 
+    // The device sends IMU samples on their own while a camera frame is still being encoded
+    if (!vio_input.has_cam_data()) {
+        for (const vio_input_proto::IMUData& curr_data : vio_input.imu_data()) {
+            publish_imu(curr_data);
+        }
+        return;
+    }
+
     // Loop through and publish all IMU values first
     for (int i = 0; i < vio_input.imu_data_size() - 1; i++) {
-        vio_input_proto::IMUData curr_data = vio_input.imu_data(i);
-        imu_.put(imu_.allocate<imu_type>(imu_type{
-            time_point{std::chrono::nanoseconds{curr_data.timestamp()}},
-            Eigen::Vector3d{curr_data.angular_vel().x(), curr_data.angular_vel().y(), curr_data.angular_vel().z()},
-            Eigen::Vector3d{curr_data.linear_accel().x(), curr_data.linear_accel().y(), curr_data.linear_accel().z()}}));
+        publish_imu(vio_input.imu_data(i));
     }
     // Publish the Cam value then
-    vio_input_proto::CamData cam_data = vio_input.cam_data();
+    vio_input_proto::CamData& cam_data = *vio_input.mutable_cam_data();
     log_->info("{},{}", cam_data.timestamp(), msec_to_trans);
 
-    // Must do a deep copy of the received data (in the form of a string of bytes)
-    auto img0_copy = std::string(cam_data.img0_data());
-    auto img1_copy = std::string(cam_data.img1_data());
-
 #ifdef USE_COMPRESSION
     time_point start_decomp = clock_->now();
     // With compression
@@ -90,38 +86,46 @@ void server_reader::receive_vio_input(const vio_input_proto::IMUCamVec& vio_inpu
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     queue_.push(curr);
     std::unique_lock<std::mutex> lock{mutex_};
-    decoder_->enqueue(img0_copy, img1_copy);
+    // The decoder wraps the bitstreams without copying them, so vio_input_ must not change until the decode below is done
+    decoder_->enqueue(*cam_data.mutable_img0_data(), *cam_data.mutable_img1_data());
     condition_variable_.wait(lock, [this]() {
         return img_ready_;
     });
     img_ready_ = false;
 
-    cv::Mat img0(img0_dst_.clone());
-    cv::Mat img1(img1_dst_.clone());
+    // The callback copied the images out of the decoder's buffers, so they are owned here and published as they are
+    cv::Mat img0 = std::move(img0_dst_);
+    cv::Mat img1 = std::move(img1_dst_);
 
     lock.unlock();
     log_->warn("{},{}", cam_data.timestamp(), (clock_->now() - start_decomp).count() / 1e6);
     // With compression end
 #else
     // Without compression
-    cv::Mat img0(cam_data.rows(), cam_data.cols(), CV_8UC1, img0_copy.data());
-    cv::Mat img1(cam_data.rows(), cam_data.cols(), CV_8UC1, img1_copy.data());
+    // vio_input is reused for the next frame, so the pixels are copied out of it exactly once
+    cv::Mat img0 = cv::Mat(cam_data.rows(), cam_data.cols(), CV_8UC1, cam_data.mutable_img0_data()->data()).clone();
+    cv::Mat img1 = cv::Mat(cam_data.rows(), cam_data.cols(), CV_8UC1, cam_data.mutable_img1_data()->data()).clone();
     // Without compression end
 #endif
     cam_.put(cam_.allocate<binocular_cam_type>(binocular_cam_type{
         time_point{std::chrono::nanoseconds{cam_data.timestamp()}},
-        img0.clone(),
-        img1.clone(),
+        img0,
+        img1,
     }));
     // If we publish all IMU samples before the camera data, the camera data may not be captured in any of the IMU callbacks
     // in the tracking algorithm (e.g. OpenVINS), and has to wait for another camera frame time (until the next packet
     // arrives) to be consumed. Therefore, we publish one (or more) IMU samples after the camera data to make sure that the
     // camera data will be captured.
-    vio_input_proto::IMUData last_imu = vio_input.imu_data(vio_input.imu_data_size() - 1);
+    if (vio_input.imu_data_size() > 0) {
+        publish_imu(vio_input.imu_data(vio_input.imu_data_size() - 1));
+    }
+}
+
+void server_reader::publish_imu(const vio_input_proto::IMUData& imu_data) {
     imu_.put(imu_.allocate<imu_type>(
-        imu_type{time_point{std::chrono::nanoseconds{last_imu.timestamp()}},
-                 Eigen::Vector3d{last_imu.angular_vel().x(), last_imu.angular_vel().y(), last_imu.angular_vel().z()},
-                 Eigen::Vector3d{last_imu.linear_accel().x(), last_imu.linear_accel().y(), last_imu.linear_accel().z()}}));
+        imu_type{time_point{std::chrono::nanoseconds{imu_data.timestamp()}},
+                 Eigen::Vector3d{imu_data.angular_vel().x(), imu_data.angular_vel().y(), imu_data.angular_vel().z()},
+                 Eigen::Vector3d{imu_data.linear_accel().x(), imu_data.linear_accel().y(), imu_data.linear_accel().z()}}));
 }
 
 PLUGIN_MAIN(server_reader)
@@ -26,7 +26,8 @@ public:
     void        start() override;
 
 private:
-    void receive_vio_input(const vio_input_proto::IMUCamVec& vio_input);
+    void receive_vio_input(vio_input_proto::IMUCamVec& vio_input);
+    void publish_imu(const vio_input_proto::IMUData& imu_data);
 
     std::unique_ptr<vio_video_decoder> decoder_;
 
@@ -42,9 +43,7 @@ private:
     switchboard::writer<data_format::imu_type>                            imu_;
     switchboard::writer<data_format::binocular_cam_type>                  cam_;
     switchboard::buffered_reader<switchboard::event_wrapper<std::string>> imu_cam_reader_;
-    std::string                                                           buffer_str_;
+    vio_input_proto::IMUCamVec                                            vio_input_; ///< Reused for every received frame
     std::shared_ptr<spdlog::logger>                                       log_;
-
-    const std::string delimiter_ = "EEND!";
 };
 } // namespace ILLIXR
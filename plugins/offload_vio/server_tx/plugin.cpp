@@ -115,11 +115,11 @@ void server_writer::send_vio_output(const switchboard::ptr<const pose::head_pose
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     vio_output_params->set_end_server_timestamp(end_pose_time);
 
-    // Prepare data delivery
-    std::string       data_to_be_sent = vio_output_params->SerializeAsString();
-    const std::string delimiter       = "END!";
+    // Prepare data delivery; the network backend frames every message with its length, so no delimiter is appended
+    std::string data_to_be_sent;
+    vio_output_params->SerializeToString(&data_to_be_sent);
 
-    vio_pose_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(data_to_be_sent + delimiter));
+    vio_pose_writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(data_to_be_sent)));
 
     delete vio_output_params;
 }
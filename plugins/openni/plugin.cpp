@@ -34,7 +34,8 @@ threadloop::skip_option openni_plugin::_p_should_skip() {
         std::this_thread::sleep_for(std::chrono::milliseconds{time_sleep_});
         return skip_option::run;
     } else {
-        return skip_option::skip_and_yield;
+        // Still the millisecond of the last frame
+        return skip_until(std::chrono::steady_clock::time_point{std::chrono::milliseconds{last_timestamp_ + 1}});
     }
 }
 
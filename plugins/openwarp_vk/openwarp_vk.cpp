@@ -1,5 +1,6 @@
 #include "openwarp_vk.hpp"
 
+#include "illixr/distortion_mesh.hpp"
 #include "illixr/math_util.hpp"
 
 using namespace ILLIXR;
@@ -567,39 +568,12 @@ void openwarp_vk::create_index_buffers() {
 }
 
 void openwarp_vk::generate_distortion_data() {
-    // Calculate the number of vertices+ineye_tiles_high distortion mesh.
-    num_distortion_vertices_ = (hmd_info_.eye_tiles_high + 1) * (hmd_info_.eye_tiles_wide + 1);
-    num_distortion_indices_  = hmd_info_.eye_tiles_high * hmd_info_.eye_tiles_wide * 6;
-
-    // Allocate memory for the elements/indices array.
-    distortion_indices_.resize(num_distortion_indices_);
-
-    // This is just a simple grid/plane index array, nothing fancy.
-    // Same for both eye distortions, too!
-    for (int y = 0; y < hmd_info_.eye_tiles_high; y++) {
-        for (int x = 0; x < hmd_info_.eye_tiles_wide; x++) {
-            const int offset = (y * hmd_info_.eye_tiles_wide + x) * 6;
-
-            distortion_indices_[offset + 0] = ((y + 0) * (hmd_info_.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 1] = ((y + 1) * (hmd_info_.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 2] = ((y + 0) * (hmd_info_.eye_tiles_wide + 1) + (x + 1));
-
-            distortion_indices_[offset + 3] = ((y + 0) * (hmd_info_.eye_tiles_wide + 1) + (x + 1));
-            distortion_indices_[offset + 4] = ((y + 1) * (hmd_info_.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 5] = ((y + 1) * (hmd_info_.eye_tiles_wide + 1) + (x + 1));
-        }
-    }
+    distortion_mesh mesh = distortion_mesh::load(
+        hmd_info_, switchboard_->get_env("ILLIXR_DISTORTION_CACHE", distortion_mesh::default_cache_dir()));
 
-    // There are `num_distortion_vertices_` distortion coordinates for each color channel (3) of each eye (2).
-    // These are NOT the coordinates of the distorted vertices. They are *coefficients* that will be used to
-    // offset the UV coordinates of the distortion mesh.
-    std::array<std::array<std::vector<HMD::mesh_coord2d_t>, HMD::NUM_COLOR_CHANNELS>, HMD::NUM_EYES> distort_coords;
-    for (auto& eye_coords : distort_coords) {
-        for (auto& channel_coords : eye_coords) {
-            channel_coords.resize(num_distortion_vertices_);
-        }
-    }
-    HMD::build_distortion_meshes(distort_coords, hmd_info_);
+    num_distortion_vertices_ = mesh.vertices_per_eye;
+    num_distortion_indices_  = static_cast<uint32_t>(mesh.indices.size());
+    distortion_indices_      = std::move(mesh.indices);
 
     // Allocate memory for position and UV CPU buffers.
     const std::size_t num_elems_pos_uv = HMD::NUM_EYES * num_distortion_vertices_;
@@ -642,43 +616,36 @@ void openwarp_vk::generate_distortion_data() {
 
     for (int eye = 0; eye < HMD::NUM_EYES; eye++) {
         Eigen::Matrix4f distortion_matrix = calculate_distortion_transform(basic_projection_[eye]);
-        for (int y = 0; y <= hmd_info_.eye_tiles_high; y++) {
-            for (int x = 0; x <= hmd_info_.eye_tiles_wide; x++) {
-                const int index = y * (hmd_info_.eye_tiles_wide + 1) + x;
-
-                // Set the physical distortion mesh coordinates. These are rectangular/gridlike, not distorted.
-                // The distortion is handled by the UVs, not the actual mesh coordinates!
-                distortion_vertices_[eye * num_distortion_vertices_ + index].pos.x =
-                    (-1.0f + 2 * (static_cast<float>(x) / static_cast<float>(hmd_info_.eye_tiles_wide)));
-
-                distortion_vertices_[eye * num_distortion_vertices_ + index].pos.y = (input_texture_external_ ? 1.0f : -1.0f) *
-                    (-1.0f +
-                     2.0f * (static_cast<float>(hmd_info_.eye_tiles_high - y) / static_cast<float>(hmd_info_.eye_tiles_high)) *
-                         (static_cast<float>(hmd_info_.eye_tiles_high * hmd_info_.tile_pixels_high) /
-                          static_cast<float>(hmd_info_.display_pixels_high)));
-
-                distortion_vertices_[eye * num_distortion_vertices_ + index].pos.z = 0.0f;
-
-                // Use the previously-calculated distort_coords to set the UVs on the distortion mesh
-                Eigen::Vector4f vertex_uv0(distort_coords[eye][0][index].x, distort_coords[eye][0][index].y, -1, 1);
-                Eigen::Vector4f vertex_uv1(distort_coords[eye][1][index].x, distort_coords[eye][1][index].y, -1, 1);
-                Eigen::Vector4f vertex_uv2(distort_coords[eye][2][index].x, distort_coords[eye][2][index].y, -1, 1);
-
-                Eigen::Vector4f uv0 = distortion_matrix * vertex_uv0;
-                Eigen::Vector4f uv1 = distortion_matrix * vertex_uv1;
-                Eigen::Vector4f uv2 = distortion_matrix * vertex_uv2;
-
-                float factor0 = 1.0f / std::max(uv0.z(), 0.00001f);
-                float factor1 = 1.0f / std::max(uv1.z(), 0.00001f);
-                float factor2 = 1.0f / std::max(uv2.z(), 0.00001f);
-
-                distortion_vertices_[eye * num_distortion_vertices_ + index].uv0.x = uv0.x() * factor0;
-                distortion_vertices_[eye * num_distortion_vertices_ + index].uv0.y = uv0.y() * factor0;
-                distortion_vertices_[eye * num_distortion_vertices_ + index].uv1.x = uv1.x() * factor1;
-                distortion_vertices_[eye * num_distortion_vertices_ + index].uv1.y = uv1.y() * factor1;
-                distortion_vertices_[eye * num_distortion_vertices_ + index].uv2.x = uv2.x() * factor2;
-                distortion_vertices_[eye * num_distortion_vertices_ + index].uv2.y = uv2.y() * factor2;
-            }
+        for (uint32_t index = 0; index < num_distortion_vertices_; index++) {
+            const std::size_t           vertex   = eye * num_distortion_vertices_ + index;
+            const HMD::mesh_coord3d_t&  position = mesh.positions[vertex];
+            DistortionCorrectionVertex& out      = distortion_vertices_[vertex];
+
+            // Set the physical distortion mesh coordinates. These are rectangular/gridlike, not distorted.
+            // The distortion is handled by the UVs, not the actual mesh coordinates!
+            out.pos.x = position.x;
+            out.pos.y = (input_texture_external_ ? 1.0f : -1.0f) * position.y;
+            out.pos.z = position.z;
+
+            // Use the precomputed distortion coefficients to set the UVs on the distortion mesh
+            Eigen::Vector4f vertex_uv0(mesh.uv[0][vertex].u, mesh.uv[0][vertex].v, -1, 1);
+            Eigen::Vector4f vertex_uv1(mesh.uv[1][vertex].u, mesh.uv[1][vertex].v, -1, 1);
+            Eigen::Vector4f vertex_uv2(mesh.uv[2][vertex].u, mesh.uv[2][vertex].v, -1, 1);
+
+            Eigen::Vector4f uv0 = distortion_matrix * vertex_uv0;
+            Eigen::Vector4f uv1 = distortion_matrix * vertex_uv1;
+            Eigen::Vector4f uv2 = distortion_matrix * vertex_uv2;
+
+            float factor0 = 1.0f / std::max(uv0.z(), 0.00001f);
+            float factor1 = 1.0f / std::max(uv1.z(), 0.00001f);
+            float factor2 = 1.0f / std::max(uv2.z(), 0.00001f);
+
+            out.uv0.x = uv0.x() * factor0;
+            out.uv0.y = uv0.y() * factor0;
+            out.uv1.x = uv1.x() * factor1;
+            out.uv1.y = uv1.y() * factor1;
+            out.uv2.x = uv2.x() * factor2;
+            out.uv2.y = uv2.y() * factor2;
         }
     }
 }
@@ -26,7 +26,7 @@ threadloop::skip_option openwarp_vk_plugin::_p_should_skip() {
 
     // Only print every 1 second
     if (now - last_print_ < 1000) {
-        return skip_option::skip_and_yield;
+        return skip_for(std::chrono::milliseconds{1000 - (now - last_print_)});
     } else {
         last_print_ = now;
         return skip_option::run;
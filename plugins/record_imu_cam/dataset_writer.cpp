@@ -0,0 +1,152 @@
+#include "dataset_writer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <opencv2/imgcodecs.hpp>
+#include <spdlog/spdlog.h>
+
+using namespace ILLIXR;
+using namespace ILLIXR::data_format;
+
+namespace {
+// how long the writer and the encoders wait for work before checking whether they should stop
+constexpr std::chrono::milliseconds idle_wait{100};
+} // namespace
+
+dataset_writer::dataset_writer(const boost::filesystem::path& root, const options& opts)
+    : cam0_data_dir_{root / "cam0" / "data"}
+    , cam1_data_dir_{root / "cam1" / "data"}
+    , frames_in_flight_limit_{std::max<std::size_t>(opts.frames_in_flight, 1)}
+    , png_params_{cv::IMWRITE_PNG_COMPRESSION, opts.png_compression}
+    , samples_{std::max<std::size_t>(opts.queue_depth, 1)} {
+    // create imu0 directory
+    boost::filesystem::path imu_dir = root / "imu0";
+    boost::filesystem::create_directories(imu_dir);
+    imu_file_.open((imu_dir / "data.csv").string(), std::ofstream::out);
+    imu_file_ << "#timestamp [ns],w_x [rad s^-1],w_y [rad s^-1],w_z [rad s^-1],a_x [m s^-2],a_y [m s^-2],a_z [m s^-2]\n"
+              << std::setprecision(17);
+
+    // create cam0 and cam1 directories
+    boost::filesystem::create_directories(cam0_data_dir_);
+    cam0_file_.open((root / "cam0" / "data.csv").string(), std::ofstream::out);
+    cam0_file_ << "#timestamp [ns],filename\n";
+    boost::filesystem::create_directories(cam1_data_dir_);
+    cam1_file_.open((root / "cam1" / "data.csv").string(), std::ofstream::out);
+    cam1_file_ << "#timestamp [ns],filename\n";
+
+    writer_ = std::thread{[this] {
+        write_csv();
+    }};
+    for (unsigned i = 0; i < std::max(opts.encoder_count, 1u); ++i) {
+        encoders_.emplace_back([this] {
+            encode_png();
+        });
+    }
+}
+
+dataset_writer::~dataset_writer() {
+    // the writer queues the last encode jobs, so it is stopped first
+    stop_writer_.store(true);
+    writer_.join();
+    stop_encoders_.store(true);
+    for (auto& encoder : encoders_) {
+        encoder.join();
+    }
+
+    imu_file_.close();
+    cam0_file_.close();
+    cam1_file_.close();
+
+    spdlog::get("illixr")->info("[record_imu_cam] Wrote {} IMU samples and {} stereo frames", samples_written_,
+                                frames_written_);
+    if (samples_dropped_.load() > 0 || frames_dropped_.load() > 0) {
+        spdlog::get("illixr")->warn("[record_imu_cam] Dropped {} IMU samples and {} stereo frames: the writer fell behind",
+                                    samples_dropped_.load(), frames_dropped_.load());
+    }
+}
+
+void dataset_writer::push(long timestamp, const Eigen::Vector3d& angular_v, const Eigen::Vector3d& linear_a,
+                          switchboard::ptr<const binocular_cam_type> cam) {
+    sample s{timestamp, angular_v, linear_a, nullptr};
+    if (cam != nullptr) {
+        // both images of a frame count against the limit, so that a slow encoder bounds the memory held
+        if (images_in_flight_.load(std::memory_order_relaxed) + 2 > 2 * frames_in_flight_limit_) {
+            frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            images_in_flight_.fetch_add(2, std::memory_order_relaxed);
+            s.cam = std::move(cam);
+        }
+    }
+
+    const bool has_frame = s.cam != nullptr;
+    if (!samples_.try_enqueue(std::move(s))) {
+        samples_dropped_.fetch_add(1, std::memory_order_relaxed);
+        if (has_frame) {
+            frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+            images_in_flight_.fetch_sub(2, std::memory_order_relaxed);
+        }
+    }
+}
+
+void dataset_writer::write_csv() {
+    sample s;
+    while (true) {
+        if (samples_.wait_dequeue_timed(s, idle_wait)) {
+            write_sample(s);
+            s.cam = nullptr;
+            continue;
+        }
+
+        // idle: hand what has been written so far to the OS, rather than flushing every row
+        imu_file_.flush();
+        cam0_file_.flush();
+        cam1_file_.flush();
+        if (stop_writer_.load()) {
+            while (samples_.try_dequeue(s)) {
+                write_sample(s);
+            }
+            return;
+        }
+    }
+}
+
+void dataset_writer::write_sample(const sample& s) {
+    imu_file_ << s.timestamp << ',' << s.angular_v[0] << ',' << s.angular_v[1] << ',' << s.angular_v[2] << ','
+              << s.linear_a[0] << ',' << s.linear_a[1] << ',' << s.linear_a[2] << '\n';
+    ++samples_written_;
+
+    if (s.cam == nullptr) {
+        return;
+    }
+    const std::string file_name = std::to_string(s.timestamp) + ".png";
+    cam0_file_ << s.timestamp << ',' << file_name << '\n';
+    cam1_file_ << s.timestamp << ',' << file_name << '\n';
+    encode_jobs_.enqueue({s.cam, image::LEFT_EYE, (cam0_data_dir_ / file_name).string()});
+    encode_jobs_.enqueue({s.cam, image::RIGHT_EYE, (cam1_data_dir_ / file_name).string()});
+    ++frames_written_;
+}
+
+void dataset_writer::encode_png() {
+    auto encode = [this](encode_job& job) {
+        if (!cv::imwrite(job.path, job.frame->at(job.eye), png_params_)) {
+            spdlog::get("illixr")->error("[record_imu_cam] Failed to write {}", job.path);
+        }
+        job.frame = nullptr;
+        images_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    };
+
+    encode_job job;
+    while (true) {
+        if (encode_jobs_.wait_dequeue_timed(job, idle_wait)) {
+            encode(job);
+            continue;
+        }
+        if (stop_encoders_.load()) {
+            while (encode_jobs_.try_dequeue(job)) {
+                encode(job);
+            }
+            return;
+        }
+    }
+}
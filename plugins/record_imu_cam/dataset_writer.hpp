@@ -0,0 +1,92 @@
+#pragma once
+
+#include "illixr/concurrentqueue/blockingconcurrentqueue.hpp"
+#include "illixr/concurrentqueue/readwritequeue/readerwritercircularbuffer.h"
+#include "illixr/data_format/opencv_data_types.hpp"
+#include "illixr/switchboard.hpp"
+
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <eigen3/Eigen/Dense>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ILLIXR {
+
+/**
+ * @brief Writes a EuRoC-style dataset (imu0/, cam0/, cam1/) off the sensor callback threads.
+ *
+ * The producer (the IMU callback) hands each sample, and the stereo frame that came with it if any, to a bounded
+ * lock-free queue and never blocks. A writer thread appends the CSV rows through buffered streams, and a pool of
+ * encoder threads writes the PNGs. When the queue is full, or too many frames are waiting to be encoded, the sample or
+ * frame is dropped and counted instead; the counts are logged when the writer is destroyed, after everything queued has
+ * been written.
+ *
+ * push() must only ever be called from one thread.
+ */
+class dataset_writer {
+public:
+    struct options {
+        std::size_t queue_depth;      ///< IMU samples that may wait for the CSV writer
+        std::size_t frames_in_flight; ///< Stereo frames that may wait for, or be in, a PNG encoder
+        unsigned    encoder_count;    ///< PNG encoder threads
+        int         png_compression;  ///< 0 (none) to 9 (smallest, slowest)
+    };
+
+    dataset_writer(const boost::filesystem::path& root, const options& opts);
+    ~dataset_writer();
+
+    dataset_writer(const dataset_writer&)            = delete;
+    dataset_writer& operator=(const dataset_writer&) = delete;
+
+    /**
+     * @brief Queues an IMU sample, and optionally a stereo frame to be stored under the same timestamp.
+     */
+    void push(long timestamp, const Eigen::Vector3d& angular_v, const Eigen::Vector3d& linear_a,
+              switchboard::ptr<const data_format::binocular_cam_type> cam);
+
+private:
+    struct sample {
+        long                                                    timestamp = 0;
+        Eigen::Vector3d                                         angular_v;
+        Eigen::Vector3d                                         linear_a;
+        switchboard::ptr<const data_format::binocular_cam_type> cam;
+    };
+
+    struct encode_job {
+        switchboard::ptr<const data_format::binocular_cam_type> frame; // keeps the pixels alive
+        data_format::image::image_type                          eye = data_format::image::LEFT_EYE;
+        std::string                                             path;
+    };
+
+    void write_csv();
+    void write_sample(const sample& s);
+    void encode_png();
+
+    const boost::filesystem::path cam0_data_dir_;
+    const boost::filesystem::path cam1_data_dir_;
+    const std::size_t             frames_in_flight_limit_;
+    const std::vector<int>        png_params_;
+
+    std::ofstream imu_file_;
+    std::ofstream cam0_file_;
+    std::ofstream cam1_file_;
+
+    moodycamel::BlockingReaderWriterCircularBuffer<sample> samples_;
+    moodycamel::BlockingConcurrentQueue<encode_job>        encode_jobs_;
+    std::atomic<std::size_t>                               images_in_flight_{0};
+    std::atomic<bool>                                      stop_writer_{false};
+    std::atomic<bool>                                      stop_encoders_{false};
+
+    std::atomic<std::size_t> samples_dropped_{0};
+    std::atomic<std::size_t> frames_dropped_{0};
+    std::size_t              samples_written_ = 0;
+    std::size_t              frames_written_  = 0;
+
+    std::thread              writer_;
+    std::vector<std::thread> encoders_;
+};
+
+} // namespace ILLIXR
@@ -1,10 +1,9 @@
 #include "plugin.hpp"
 
-#include <eigen3/Eigen/Dense>
-#include <iomanip>
+#include <algorithm>
 #include <memory>
-#include <opencv2/imgcodecs.hpp>
 #include <string>
+#include <thread>
 
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
@@ -13,31 +12,16 @@ using namespace ILLIXR::data_format;
     : plugin{name, pb}
     , switchboard_{phonebook_->lookup_impl<switchboard>()}
     , cam_{switchboard_->get_buffered_reader<binocular_cam_type>("cam")}
-    , record_data_{get_record_data_path()}
-    , cam0_data_dir_{record_data_ / "cam0" / "data"}
-    , cam1_data_dir_{record_data_ / "cam1" / "data"} {
+    , record_data_{get_record_data_path()} {
     // check folder exist, if exist delete it
     boost::filesystem::remove_all(record_data_);
 
-    // create imu0 directory
-    boost::filesystem::path imu_dir = record_data_ / "imu0";
-    boost::filesystem::create_directories(imu_dir);
-    std::string imu_file = imu_dir.string() + "/data.csv";
-    imu_wt_file_.open(imu_file, std::ofstream::out);
-    imu_wt_file_ << "#timestamp [ns],w_x [rad s^-1],w_y [rad s^-1],w_z [rad s^-1],a_x [m s^-2],a_y [m s^-2],a_z [m s^-2]"
-                 << std::endl;
-
-    // create cam0 directory
-    boost::filesystem::create_directories(cam0_data_dir_);
-    std::string cam0_file = (record_data_ / "cam0" / "data.csv").string();
-    cam0_wt_file_.open(cam0_file, std::ofstream::out);
-    cam0_wt_file_ << "#timestamp [ns],filename" << std::endl;
-
-    // create cam1 directory
-    boost::filesystem::create_directories(cam1_data_dir_);
-    std::string cam1_file = (record_data_ / "cam1" / "data.csv").string();
-    cam1_wt_file_.open(cam1_file, std::ofstream::out);
-    cam1_wt_file_ << "#timestamp [ns],filename" << std::endl;
+    const unsigned          encoders = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    dataset_writer::options options{switchboard_->get_env_ulong("RECORD_IMU_CAM_QUEUE_DEPTH", 4096),
+                                    switchboard_->get_env_ulong("RECORD_IMU_CAM_FRAMES_IN_FLIGHT", 64),
+                                    static_cast<unsigned>(switchboard_->get_env_ulong("RECORD_IMU_CAM_ENCODERS", encoders)),
+                                    static_cast<int>(switchboard_->get_env_ulong("RECORD_IMU_CAM_PNG_COMPRESSION", 1))};
+    writer_ = std::make_unique<dataset_writer>(record_data_, options);
 
     switchboard_->schedule<imu_type>(id_, "imu", [this](const switchboard::ptr<const imu_type>& datum, const std::size_t&) {
         this->dump_data(datum);
@@ -45,31 +29,14 @@ using namespace ILLIXR::data_format;
 }
 
 void record_imu_cam::dump_data(const switchboard::ptr<const imu_type>& datum) {
-    long            timestamp = datum->time.time_since_epoch().count();
-    Eigen::Vector3d angular_v = datum->angular_v;
-    Eigen::Vector3d linear_a  = datum->linear_a;
-
-    // write imu0
-    imu_wt_file_ << timestamp << "," << std::setprecision(17) << angular_v[0] << "," << angular_v[1] << "," << angular_v[2]
-                 << "," << linear_a[0] << "," << linear_a[1] << "," << linear_a[2] << std::endl;
-
-    // write cam0 and cam1
-    switchboard::ptr<const binocular_cam_type> cam;
-    cam                  = cam_.size() == 0 ? nullptr : cam_.dequeue();
-    std::string cam0_img = cam0_data_dir_.string() + "/" + std::to_string(timestamp) + ".png";
-    std::string cam1_img = cam1_data_dir_.string() + "/" + std::to_string(timestamp) + ".png";
-    if (cam != nullptr) {
-        cam0_wt_file_ << timestamp << "," << timestamp << ".png " << std::endl;
-        cv::imwrite(cam0_img, cam->at(image::LEFT_EYE));
-        cam1_wt_file_ << timestamp << "," << timestamp << ".png " << std::endl;
-        cv::imwrite(cam1_img, cam->at(image::RIGHT_EYE));
-    }
+    // the camera frame, if one arrived since the last IMU sample, is stored under this sample's timestamp
+    switchboard::ptr<const binocular_cam_type> cam = cam_.size() == 0 ? nullptr : cam_.dequeue();
+    writer_->push(datum->time.time_since_epoch().count(), datum->angular_v, datum->linear_a, std::move(cam));
 }
 
 record_imu_cam::~record_imu_cam() {
-    imu_wt_file_.close();
-    cam0_wt_file_.close();
-    cam1_wt_file_.close();
+    // finishes writing whatever is still queued
+    writer_.reset();
 }
 
 // TODO: This should come from a yaml file
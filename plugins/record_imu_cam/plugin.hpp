@@ -1,5 +1,6 @@
 #pragma once
 
+#include "dataset_writer.hpp"
 #include "illixr/data_format/imu.hpp"
 #include "illixr/data_format/opencv_data_types.hpp"
 #include "illixr/phonebook.hpp"
@@ -7,7 +8,7 @@
 #include "illixr/switchboard.hpp"
 
 #include <boost/filesystem.hpp>
-#include <fstream>
+#include <memory>
 
 namespace ILLIXR {
 class record_imu_cam : public plugin {
@@ -19,16 +20,12 @@ public:
 private:
     static boost::filesystem::path get_record_data_path();
 
-    std::ofstream                      imu_wt_file_;
-    std::ofstream                      cam0_wt_file_;
-    std::ofstream                      cam1_wt_file_;
     const std::shared_ptr<switchboard> switchboard_;
 
     switchboard::buffered_reader<data_format::binocular_cam_type> cam_;
 
-    const boost::filesystem::path record_data_;
-    const boost::filesystem::path cam0_data_dir_;
-    const boost::filesystem::path cam1_data_dir_;
+    const boost::filesystem::path   record_data_;
+    std::unique_ptr<dataset_writer> writer_;
 };
 
 } // namespace ILLIXR
@@ -0,0 +1,121 @@
+#include "plugin.hpp"
+
+#include "illixr/error_util.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace ILLIXR;
+using namespace ILLIXR::data_format;
+
+// White noise densities of the EuRoC IMU, which ILLIXR's integrators and VIO are tuned for
+constexpr double gyroscope_noise_density     = 1.6968e-04; // rad/s/sqrt(Hz)
+constexpr double accelerometer_noise_density = 2.0000e-03; // m/s^2/sqrt(Hz)
+
+[[maybe_unused]] synthetic_sensors::synthetic_sensors(const std::string& name, phonebook* pb)
+    : threadloop{name, pb}
+    , switchboard_{phonebook_->lookup_impl<switchboard>()}
+    , clock_{phonebook_->lookup_impl<relative_clock>()}
+    , imu_{switchboard_->get_writer<imu_type>("imu")}
+    , cam_{switchboard_->get_writer<binocular_cam_type>("cam")}
+    , rgb_depth_{switchboard_->get_writer<rgb_depth_type>("rgb_depth")}
+    , true_pose_{switchboard_->get_writer<pose::head_pose_type>("true_pose")}
+    , ground_truth_offset_{switchboard_->get_writer<switchboard::event_wrapper<Eigen::Vector3f>>("ground_truth_offset")}
+    , seed_{switchboard_->get_env_ulong("ILLIXR_SYNTHETIC_SEED", 0)}
+    , duration_ns_{static_cast<std::uint64_t>(switchboard_->get_env_double("ILLIXR_SYNTHETIC_DURATION", 0.0) * 1e9)}
+    , cameras_{switchboard_->get_env("ILLIXR_SYNTHETIC_CAMERAS", "stereo")}
+    , stereo_{cameras_ == "stereo" || cameras_ == "both"}
+    , rgb_depth_enabled_{cameras_ == "rgb_depth" || cameras_ == "both"}
+    , trajectory_{seed_}
+    , imu_schedule_{switchboard_->get_env_double("ILLIXR_SYNTHETIC_IMU_RATE", 200.0)}
+    , cam_schedule_{stereo_ || rgb_depth_enabled_ ? switchboard_->get_env_double("ILLIXR_SYNTHETIC_CAM_RATE", 20.0) : 0.0}
+    , pose_schedule_{switchboard_->get_env_double("ILLIXR_SYNTHETIC_POSE_RATE", imu_schedule_.rate())}
+    , gyro_sigma_{gyroscope_noise_density * std::sqrt(std::max(imu_schedule_.rate(), 0.0)) *
+                  switchboard_->get_env_double("ILLIXR_SYNTHETIC_IMU_NOISE", 1.0)}
+    , accel_sigma_{gyro_sigma_ / gyroscope_noise_density * accelerometer_noise_density}
+    , noise_random_{seed_ + 1} {
+    spdlogger(switchboard_->get_env_char("SYNTHETIC_SENSORS_LOG_LEVEL"));
+
+    if (cameras_ != "stereo" && cameras_ != "rgb_depth" && cameras_ != "both" && cameras_ != "none") {
+        ILLIXR::abort("[synthetic_sensors] ILLIXR_SYNTHETIC_CAMERAS must be stereo, rgb_depth, both, or none, not " + cameras_);
+    }
+    if (!imu_schedule_.enabled() && !cam_schedule_.enabled() && !pose_schedule_.enabled()) {
+        ILLIXR::abort("[synthetic_sensors] Every stream has a rate of 0");
+    }
+
+    const auto width  = static_cast<int>(switchboard_->get_env_ulong("ILLIXR_SYNTHETIC_CAM_WIDTH", 752));
+    const auto height = static_cast<int>(switchboard_->get_env_ulong("ILLIXR_SYNTHETIC_CAM_HEIGHT", 480));
+    if (cam_schedule_.enabled()) {
+        camera_ = std::make_unique<synthetic_camera>(width, height, seed_);
+    }
+
+    spdlog::get(name_)->info("seed {}: IMU at {} Hz, {} cameras at {} Hz ({}x{}), ground truth at {} Hz", seed_,
+                             imu_schedule_.rate(), cameras_, cam_schedule_.rate(), width, height, pose_schedule_.rate());
+    clock_->add_time_source();
+}
+
+threadloop::skip_option synthetic_sensors::_p_should_skip() {
+    now_ns_ = std::min({imu_schedule_.next(), cam_schedule_.next(), pose_schedule_.next()});
+    if (duration_ns_ > 0 && now_ns_ > duration_ns_) {
+        spdlog::get(name_)->info("Done after {} IMU samples, {} camera frames, and {} ground truth poses",
+                                 imu_schedule_.count(), cam_schedule_.count(), pose_schedule_.count());
+        clock_->remove_time_source();
+        return skip_option::stop;
+    }
+    clock_->advance_to(time_point{std::chrono::nanoseconds{now_ns_}});
+    return skip_option::run;
+}
+
+void synthetic_sensors::_p_one_iteration() {
+    const trajectory_state state = trajectory_.at(static_cast<double>(now_ns_) * 1e-9);
+    const time_point       time{std::chrono::nanoseconds{now_ns_}};
+
+    // Streams due at the same time are published in the order a device delivers them
+    if (imu_schedule_.next() == now_ns_) {
+        publish_imu(state, time);
+        imu_schedule_.advance();
+    }
+    if (pose_schedule_.next() == now_ns_) {
+        publish_pose(state, time);
+        pose_schedule_.advance();
+    }
+    if (cam_schedule_.next() == now_ns_) {
+        publish_images(state, time);
+        cam_schedule_.advance();
+    }
+}
+
+void synthetic_sensors::publish_imu(const trajectory_state& state, time_point time) {
+    auto [angular_v, linear_a] = synthetic_trajectory::imu(state);
+    if (gyro_sigma_ > 0.0) {
+        angular_v += gyro_sigma_ * Eigen::Vector3d{noise_(noise_random_), noise_(noise_random_), noise_(noise_random_)};
+        linear_a += accel_sigma_ * Eigen::Vector3d{noise_(noise_random_), noise_(noise_random_), noise_(noise_random_)};
+    }
+    imu_.put(imu_.allocate<imu_type>(imu_type{time, angular_v, linear_a}));
+}
+
+void synthetic_sensors::publish_pose(const trajectory_state& state, time_point time) {
+    const Eigen::Vector3f position = state.position.cast<float>();
+    if (pose_schedule_.count() == 0) {
+        // As ground_truth_slam, the offset is the first ground truth position
+        ground_truth_offset_.put(ground_truth_offset_.allocate<switchboard::event_wrapper<Eigen::Vector3f>>(
+            switchboard::event_wrapper<Eigen::Vector3f>(position)));
+    }
+    // Velocities in the world frame, like the pose
+    true_pose_.put(true_pose_.allocate<pose::head_pose_type>(
+        pose::head_pose_type{time, position, state.orientation.cast<float>(), state.velocity.cast<float>(),
+                             (state.orientation * state.angular_velocity).cast<float>(), true, true}));
+}
+
+void synthetic_sensors::publish_images(const trajectory_state& state, time_point time) {
+    if (stereo_) {
+        auto [left, right] = camera_->stereo(state);
+        cam_.put(cam_.allocate<binocular_cam_type>(binocular_cam_type{time, left, right}));
+    }
+    if (rgb_depth_enabled_) {
+        auto [rgb, depth] = camera_->rgb_depth(state);
+        rgb_depth_.put(rgb_depth_.allocate<rgb_depth_type>(rgb_depth_type{time, rgb, depth}));
+    }
+}
+
+PLUGIN_MAIN(synthetic_sensors)
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "illixr/data_format/imu.hpp"
+#include "illixr/data_format/opencv_data_types.hpp"
+#include "illixr/data_format/poses/head_pose.hpp"
+#include "illixr/phonebook.hpp"
+#include "illixr/relative_clock.hpp"
+#include "illixr/switchboard.hpp"
+#include "illixr/threadloop.hpp"
+#include "synthetic_camera.hpp"
+#include "trajectory.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace ILLIXR {
+
+/// The sample times of one stream, at a fixed rate from time 0; a rate of 0 disables the stream
+class sample_schedule {
+public:
+    explicit sample_schedule(double rate)
+        : rate_{rate} { }
+
+    [[nodiscard]] bool enabled() const {
+        return rate_ > 0.0;
+    }
+
+    /// Time of the next sample in nanoseconds, computed from its index so that rounding errors do not add up
+    [[nodiscard]] std::uint64_t next() const {
+        return enabled() ? static_cast<std::uint64_t>(std::llround(static_cast<double>(count_) * 1e9 / rate_))
+                         : std::numeric_limits<std::uint64_t>::max();
+    }
+
+    void advance() {
+        ++count_;
+    }
+
+    [[nodiscard]] std::uint64_t count() const {
+        return count_;
+    }
+
+    [[nodiscard]] double rate() const {
+        return rate_;
+    }
+
+private:
+    double        rate_;
+    std::uint64_t count_ = 0;
+};
+
+/**
+ * @brief Publishes IMU samples, stereo and/or RGB-D images, and ground truth poses of a synthetic trajectory.
+ *
+ * Every stream is sampled from the same seeded synthetic_trajectory at its own rate, so the data is consistent across
+ * streams and identical from run to run with the same settings. Nothing is read from disk. Like offline_imu, the plugin
+ * is a time source of the relative_clock and timestamps each sample with its scheduled time.
+ */
+class MY_EXPORT_API synthetic_sensors : public threadloop {
+public:
+    [[maybe_unused]] synthetic_sensors(const std::string& name, phonebook* pb);
+
+protected:
+    skip_option _p_should_skip() override;
+    void        _p_one_iteration() override;
+
+private:
+    void publish_imu(const trajectory_state& state, time_point time);
+    void publish_pose(const trajectory_state& state, time_point time);
+    void publish_images(const trajectory_state& state, time_point time);
+
+    const std::shared_ptr<switchboard>    switchboard_;
+    const std::shared_ptr<relative_clock> clock_;
+
+    switchboard::writer<data_format::imu_type>                       imu_;
+    switchboard::writer<data_format::binocular_cam_type>             cam_;
+    switchboard::writer<data_format::rgb_depth_type>                 rgb_depth_;
+    switchboard::writer<data_format::pose::head_pose_type>           true_pose_;
+    switchboard::writer<switchboard::event_wrapper<Eigen::Vector3f>> ground_truth_offset_;
+
+    const std::uint64_t seed_;
+    const std::uint64_t duration_ns_;
+    const std::string   cameras_;
+    const bool          stereo_;
+    const bool          rgb_depth_enabled_;
+
+    const synthetic_trajectory        trajectory_;
+    std::unique_ptr<synthetic_camera> camera_;
+
+    sample_schedule imu_schedule_;
+    sample_schedule cam_schedule_;
+    sample_schedule pose_schedule_;
+    std::uint64_t   now_ns_ = 0;
+
+    // Standard deviations of the white noise added to each IMU sample
+    const double                     gyro_sigma_;
+    const double                     accel_sigma_;
+    std::mt19937_64                  noise_random_;
+    std::normal_distribution<double> noise_;
+};
+
+} // namespace ILLIXR
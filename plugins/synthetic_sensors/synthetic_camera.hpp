@@ -0,0 +1,166 @@
+#pragma once
+
+#include "trajectory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <opencv2/core/mat.hpp>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace ILLIXR {
+
+/**
+ * @brief Camera images that move consistently with a synthetic_trajectory, without rendering a scene.
+ *
+ * The cameras look along the body's x axis at a textured plane facing them, @p plane_distance in front of the origin.
+ * An image is a window into a seeded, tileable noise texture, shifted by the yaw and pitch of the body and by its
+ * position parallel to the plane, so that under small rotations the image motion matches what a pinhole camera with a
+ * 90 degree horizontal field of view would see. The right camera is @p baseline to the body's right, which shifts its
+ * window by the disparity of the plane. Roll and the motion towards the plane are not shown. Each image is a few row
+ * copies out of the texture, so frames are cheap at any size and rate.
+ */
+class synthetic_camera {
+public:
+    synthetic_camera(int width, int height, std::uint64_t seed, double plane_distance = 2.0, double baseline = 0.11)
+        : width_{width}
+        , height_{height}
+        , focal_{width / 2.0}
+        , plane_distance_{plane_distance}
+        , baseline_{baseline}
+        , size_{texture_size(width, height)} {
+        std::array<std::vector<std::uint8_t>, 3> channels;
+        for (std::size_t c = 0; c < channels.size(); ++c) {
+            channels[c] = noise(size_, seed * 3 + c);
+        }
+        gray_ = cv::Mat(size_, size_, CV_8UC1);
+        rgb_  = cv::Mat(size_, size_, CV_8UC3);
+        for (int y = 0; y < size_; ++y) {
+            auto* gray = gray_.ptr<std::uint8_t>(y);
+            auto* rgb  = rgb_.ptr<std::uint8_t>(y);
+            for (int x = 0; x < size_; ++x) {
+                const std::size_t i = static_cast<std::size_t>(y) * size_ + x;
+                gray[x]             = static_cast<std::uint8_t>((channels[0][i] + channels[1][i] + channels[2][i]) / 3);
+                for (int c = 0; c < 3; ++c) {
+                    rgb[3 * x + c] = channels[c][i];
+                }
+            }
+        }
+    }
+
+    /// The left and right grayscale (CV_8UC1) images seen from @p state
+    [[nodiscard]] std::pair<cv::Mat, cv::Mat> stereo(const trajectory_state& state) const {
+        const window left = view(state);
+        return {crop(gray_, left.x, left.y), crop(gray_, left.x + disparity(state), left.y)};
+    }
+
+    /// The color (CV_8UC3) and depth (CV_16UC1, in mm) images the left camera sees from @p state
+    [[nodiscard]] std::pair<cv::Mat, cv::Mat> rgb_depth(const trajectory_state& state) const {
+        const window left = view(state);
+        const double mm   = std::clamp(1000.0 * distance(state), 0.0, 65535.0);
+        return {crop(rgb_, left.x, left.y), cv::Mat(height_, width_, CV_16UC1, cv::Scalar(std::round(mm)))};
+    }
+
+private:
+    struct window {
+        int x;
+        int y;
+    };
+
+    static int texture_size(int width, int height) {
+        int size = 512;
+        while (size < std::max(width, height)) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    /// A tileable texture of @p size squared bytes: value noise at a few scales, so that it has both blobs and corners
+    static std::vector<std::uint8_t> noise(int size, std::uint64_t seed) {
+        std::mt19937_64                        random{seed};
+        std::uniform_real_distribution<double> value{0.0, 255.0};
+        std::vector<double>                    sum(static_cast<std::size_t>(size) * size, 0.0);
+        for (const auto& [cell, weight] : {std::pair{64, 0.5}, std::pair{16, 0.3}, std::pair{4, 0.2}}) {
+            const int           cells = size / cell;
+            std::vector<double> lattice(static_cast<std::size_t>(cells) * cells);
+            for (double& v : lattice) {
+                v = value(random);
+            }
+            for (int y = 0; y < size; ++y) {
+                const int    y0 = y / cell, y1 = (y0 + 1) % cells;
+                const double ty = smoothstep(static_cast<double>(y % cell) / cell);
+                for (int x = 0; x < size; ++x) {
+                    const int    x0  = x / cell, x1 = (x0 + 1) % cells;
+                    const double tx  = smoothstep(static_cast<double>(x % cell) / cell);
+                    const double top = lattice[y0 * cells + x0] + tx * (lattice[y0 * cells + x1] - lattice[y0 * cells + x0]);
+                    const double bottom =
+                        lattice[y1 * cells + x0] + tx * (lattice[y1 * cells + x1] - lattice[y1 * cells + x0]);
+                    sum[static_cast<std::size_t>(y) * size + x] += weight * (top + ty * (bottom - top));
+                }
+            }
+        }
+        std::vector<std::uint8_t> texture(sum.size());
+        std::transform(sum.cbegin(), sum.cend(), texture.begin(), [](double v) {
+            return static_cast<std::uint8_t>(std::clamp(v, 0.0, 255.0));
+        });
+        return texture;
+    }
+
+    static double smoothstep(double t) {
+        return t * t * (3.0 - 2.0 * t);
+    }
+
+    /// Distance from the body to the plane, along the viewing axis of an unrotated body
+    [[nodiscard]] double distance(const trajectory_state& state) const {
+        return std::max(plane_distance_ - state.position.x(), 0.1);
+    }
+
+    [[nodiscard]] int disparity(const trajectory_state& state) const {
+        return static_cast<int>(std::lround(focal_ * baseline_ / distance(state)));
+    }
+
+    /// Where the left image starts in the texture: image x is the world's -y on the plane, image y its -z
+    [[nodiscard]] window view(const trajectory_state& state) const {
+        const Eigen::Vector3d forward = state.orientation * Eigen::Vector3d::UnitX();
+        const double          yaw     = std::atan2(forward.y(), forward.x());
+        const double          pitch   = std::asin(std::clamp(-forward.z(), -1.0, 1.0));
+        const double          scale   = focal_ / distance(state);
+        return {static_cast<int>(std::lround(-focal_ * yaw - scale * state.position.y())),
+                static_cast<int>(std::lround(focal_ * pitch - scale * state.position.z()))};
+    }
+
+    /// The width_ x height_ window of @p texture at (@p x, @p y), wrapping around its edges
+    [[nodiscard]] cv::Mat crop(const cv::Mat& texture, int x, int y) const {
+        const int         mask      = size_ - 1;
+        const std::size_t pixel     = texture.elemSize();
+        cv::Mat           image     = cv::Mat(height_, width_, texture.type());
+        const int         first_col = x & mask;
+        for (int row = 0; row < height_; ++row) {
+            const std::uint8_t* source = texture.ptr<std::uint8_t>((y + row) & mask);
+            std::uint8_t*       target = image.ptr<std::uint8_t>(row);
+            for (int col = 0, from = first_col; col < width_;) {
+                const int run = std::min(width_ - col, size_ - from);
+                std::memcpy(target + col * pixel, source + from * pixel, run * pixel);
+                col += run;
+                from = 0;
+            }
+        }
+        return image;
+    }
+
+    const int    width_;
+    const int    height_;
+    const double focal_;
+    const double plane_distance_;
+    const double baseline_;
+    const int    size_;
+
+    cv::Mat gray_;
+    cv::Mat rgb_;
+};
+
+} // namespace ILLIXR
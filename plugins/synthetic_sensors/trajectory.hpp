@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <eigen3/Eigen/Dense>
+#include <eigen3/Eigen/Geometry>
+#include <random>
+#include <utility>
+
+namespace ILLIXR {
+
+/// The state of the body at one time; the world frame is z-up, as in the EuRoC datasets
+struct trajectory_state {
+    Eigen::Vector3d    position;
+    Eigen::Vector3d    velocity;         //!< World frame, m/s
+    Eigen::Vector3d    acceleration;     //!< World frame, m/s^2, without gravity
+    Eigen::Quaterniond orientation;      //!< Body to world
+    Eigen::Vector3d    angular_velocity; //!< Body frame, rad/s
+};
+
+/**
+ * @brief A smooth, bounded, deterministic head trajectory with analytic derivatives.
+ *
+ * Each position coordinate and each of yaw, pitch, and roll is a sum of a few sinusoids whose amplitudes, frequencies,
+ * and phases are drawn from the seed, so the same seed always gives the same trajectory and the motion never drifts
+ * away from the origin. Velocity, acceleration, and the body angular velocity are the exact derivatives, so the IMU
+ * samples derived from them integrate back to the poses.
+ */
+class synthetic_trajectory {
+public:
+    static constexpr double gravity = 9.81;
+    static constexpr double pi      = 3.14159265358979323846;
+
+    /**
+     * @param seed Selects the trajectory
+     * @param position_amplitude Largest distance of each coordinate from the origin, in m
+     * @param rotation_amplitude Largest yaw, pitch, and roll, in rad
+     * @param max_frequency Highest frequency of the motion, in Hz
+     */
+    explicit synthetic_trajectory(std::uint64_t seed, double position_amplitude = 0.5, double rotation_amplitude = 0.5,
+                                  double max_frequency = 0.5) {
+        std::mt19937_64                        random{seed};
+        std::uniform_real_distribution<double> fraction{0.0, 1.0};
+        const auto                             fill = [&](std::array<wave, waves>& sum, double amplitude) {
+            for (wave& w : sum) {
+                // The amplitudes of a sum add up to at most the requested one
+                w.amplitude = amplitude / waves * (0.5 + 0.5 * fraction(random));
+                w.frequency = 2.0 * pi * max_frequency * (0.1 + 0.9 * fraction(random));
+                w.phase     = 2.0 * pi * fraction(random);
+            }
+        };
+        for (auto& sum : position_) {
+            fill(sum, position_amplitude);
+        }
+        for (auto& sum : angles_) {
+            fill(sum, rotation_amplitude);
+        }
+    }
+
+    /// The state at @p t seconds from the start
+    [[nodiscard]] trajectory_state at(double t) const {
+        trajectory_state state;
+        for (int i = 0; i < 3; ++i) {
+            const derivatives p   = evaluate(position_[i], t);
+            state.position[i]     = p.value;
+            state.velocity[i]     = p.first;
+            state.acceleration[i] = p.second;
+        }
+
+        // R = Rz(yaw) * Ry(pitch) * Rx(roll)
+        const derivatives yaw   = evaluate(angles_[0], t);
+        const derivatives pitch = evaluate(angles_[1], t);
+        const derivatives roll  = evaluate(angles_[2], t);
+        state.orientation       = Eigen::AngleAxisd{yaw.value, Eigen::Vector3d::UnitZ()} *
+            Eigen::AngleAxisd{pitch.value, Eigen::Vector3d::UnitY()} * Eigen::AngleAxisd{roll.value, Eigen::Vector3d::UnitX()};
+
+        const double sin_pitch = std::sin(pitch.value), cos_pitch = std::cos(pitch.value);
+        const double sin_roll = std::sin(roll.value), cos_roll = std::cos(roll.value);
+        state.angular_velocity = {roll.first - yaw.first * sin_pitch,
+                                  pitch.first * cos_roll + yaw.first * cos_pitch * sin_roll,
+                                  -pitch.first * sin_roll + yaw.first * cos_pitch * cos_roll};
+        return state;
+    }
+
+    /// What an ideal IMU on the body measures: the body angular velocity and the specific force in the body frame
+    static std::pair<Eigen::Vector3d, Eigen::Vector3d> imu(const trajectory_state& state) {
+        return {state.angular_velocity,
+                state.orientation.conjugate() * (state.acceleration + Eigen::Vector3d{0.0, 0.0, gravity})};
+    }
+
+private:
+    static constexpr int waves = 3;
+
+    struct wave {
+        double amplitude;
+        double frequency; // rad/s
+        double phase;
+    };
+
+    struct derivatives {
+        double value  = 0.0;
+        double first  = 0.0;
+        double second = 0.0;
+    };
+
+    static derivatives evaluate(const std::array<wave, waves>& sum, double t) {
+        derivatives result;
+        for (const wave& w : sum) {
+            const double s = std::sin(w.frequency * t + w.phase);
+            const double c = std::cos(w.frequency * t + w.phase);
+            result.value += w.amplitude * s;
+            result.first += w.amplitude * w.frequency * c;
+            result.second -= w.amplitude * w.frequency * w.frequency * s;
+        }
+        return result;
+    }
+
+    std::array<std::array<wave, waves>, 3> position_{};
+    std::array<std::array<wave, waves>, 3> angles_{}; // yaw, pitch, roll
+};
+
+} // namespace ILLIXR
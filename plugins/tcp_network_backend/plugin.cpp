@@ -95,48 +95,52 @@ void tcp_network_backend::start_server() {
 }
 
 void tcp_network_backend::read_loop(network::TCPSocket* socket) {
-    std::string buffer;
     while (running_) {
-        // read from socket
         // packet are in the format
         // total_length:4bytes|topic_name_length:4bytes|topic_name|message
-        std::string packet = socket->read_data();
-        buffer += packet;
-
-        // check if we have a complete packet
-        while (buffer.size() >= 8) {
-            uint32_t total_length = *reinterpret_cast<uint32_t*>(buffer.data());
-            if (buffer.size() >= total_length) {
-                uint32_t          topic_name_length = *reinterpret_cast<uint32_t*>(buffer.data() + 4);
-                std::string       topic_name(buffer.data() + 8, topic_name_length);
-                std::vector<char> message(buffer.begin() + 8 + topic_name_length, buffer.begin() + total_length);
-                topic_receive(topic_name, message);
-                buffer.erase(buffer.begin(), buffer.begin() + total_length);
-            } else {
-                break;
+        // The header is read first so the message can be read straight into a buffer of its final size.
+        uint32_t header[2];
+        if (!socket->read_exact(reinterpret_cast<char*>(header), sizeof(header))) {
+            if (running_) {
+                spdlog::get("illixr")->warn("[tcp_network_backend] Connection to peer closed");
             }
+            break;
         }
+        const uint32_t total_length      = header[0];
+        const uint32_t topic_name_length = header[1];
+        if (total_length < 8 || topic_name_length > total_length - 8) {
+            spdlog::get("illixr")->error("[tcp_network_backend] Malformed packet header (total={} topic_name={})", total_length,
+                                         topic_name_length);
+            break;
+        }
+        if (total_length > MAX_PACKET_SIZE) {
+            spdlog::get("illixr")->error("[tcp_network_backend] Packet of {} bytes exceeds the {} byte limit", total_length,
+                                         MAX_PACKET_SIZE);
+            break;
+        }
+
+        std::string topic_name(topic_name_length, '\0');
+        std::string message(total_length - 8 - topic_name_length, '\0');
+        if (!socket->read_exact(topic_name.data(), topic_name.size()) || !socket->read_exact(message.data(), message.size())) {
+            break;
+        }
+        topic_receive(topic_name, std::move(message));
     }
 }
 
 void tcp_network_backend::topic_create(std::string topic_name, network::topic_config& config) {
     networked_topics_.push_back(topic_name);
     networked_topics_configs_[topic_name] = config;
-    std::string serializaiton;
-    if (config.serialization_method == network::topic_config::SerializationMethod::BOOST) {
-        serializaiton = "BOOST";
-    } else {
-        serializaiton = "PROTOBUF";
-    }
-    std::string message = "create_topic" + topic_name + delimiter_ + serializaiton;
-    send_to_peer("illixr_control", std::move(message));
+    std::string serialization = network::serialization_method_name(config.serialization_method);
+    std::string message       = "create_topic" + topic_name + delimiter_ + serialization;
+    send_to_peer("illixr_control", network::message{std::move(message)});
 }
 
 bool tcp_network_backend::is_topic_networked(std::string topic_name) {
     return std::find(networked_topics_.begin(), networked_topics_.end(), topic_name) != networked_topics_.end();
 }
 
-void tcp_network_backend::topic_send(std::string topic_name, std::string&& message) {
+void tcp_network_backend::topic_send(std::string topic_name, network::message&& message) {
     if (is_topic_networked(topic_name) == false) {
         std::cout << "Topic not networked" << std::endl;
         return;
@@ -146,9 +150,9 @@ void tcp_network_backend::topic_send(std::string topic_name, std::string&& messa
 }
 
 // Helper function to queue a received message into the corresponding topic
-void tcp_network_backend::topic_receive(const std::string& topic_name, std::vector<char>& message) {
+void tcp_network_backend::topic_receive(const std::string& topic_name, std::string&& message) {
     if (topic_name == "illixr_control") {
-        std::string message_str(message.begin(), message.end());
+        const std::string& message_str = message;
         // check if message starts with "create_topic"
         if (message_str.find("create_topic") == 0) {
             size_t d_pos = message_str.find(delimiter_);
@@ -157,11 +161,7 @@ void tcp_network_backend::topic_receive(const std::string& topic_name, std::vect
             std::string serialization = message_str.substr(d_pos + 1);
             networked_topics_.push_back(l_topic_name);
             network::topic_config config;
-            if (serialization == "BOOST") {
-                config.serialization_method = network::topic_config::SerializationMethod::BOOST;
-            } else {
-                config.serialization_method = network::topic_config::SerializationMethod::PROTOBUF;
-            }
+            config.serialization_method = network::serialization_method_from_name(serialization);
             networked_topics_configs_[l_topic_name] = config;
             std::cout << "Received create_topic for " << l_topic_name << std::endl;
         }
@@ -171,7 +171,7 @@ void tcp_network_backend::topic_receive(const std::string& topic_name, std::vect
     if (!switchboard_->topic_exists(topic_name)) {
         return;
     }
-    switchboard_->get_topic(topic_name).deserialize_and_put(message, networked_topics_configs_[topic_name]);
+    switchboard_->get_topic(topic_name).deserialize_and_put(std::move(message), networked_topics_configs_[topic_name]);
 }
 
 void tcp_network_backend::stop() {
@@ -179,17 +179,32 @@ void tcp_network_backend::stop() {
     delete peer_socket_;
 }
 
-void tcp_network_backend::send_to_peer(const std::string& topic_name, std::string&& message) {
+void tcp_network_backend::send_to_peer(const std::string& topic_name, network::message&& message) {
     // packet are in the format
     // total_length:4bytes|topic_name_length:4bytes|topic_name|message
-    uint32_t    total_length = 8 + topic_name.size() + message.size();
-    std::string packet;
-    packet.append(reinterpret_cast<char*>(&total_length), 4);
+    // Only the header is built here; the message segments are written after it in the same gathered write.
+    const std::size_t packet_size = 8 + topic_name.size() + message.size();
+    if (packet_size > MAX_PACKET_SIZE) {
+        // The peer would drop the connection on it
+        spdlog::get("illixr")->error("[tcp_network_backend] Not sending a {} byte packet on {}; the limit is {} bytes",
+                                     packet_size, topic_name, MAX_PACKET_SIZE);
+        return;
+    }
+    uint32_t    total_length = static_cast<uint32_t>(packet_size);
+    std::string header;
+    header.reserve(8 + topic_name.size());
+    header.append(reinterpret_cast<char*>(&total_length), 4);
     uint32_t topic_name_length = topic_name.size();
-    packet.append(reinterpret_cast<char*>(&topic_name_length), 4);
-    packet.append(topic_name);
-    packet.append(message.begin(), message.end());
-    peer_socket_->write_data(packet);
+    header.append(reinterpret_cast<char*>(&topic_name_length), 4);
+    header.append(topic_name);
+
+    network::message packet{std::move(header)};
+    for (const auto& seg : message.segments()) {
+        packet.append(seg.owner, seg.data, seg.size);
+    }
+    // writers on different threads must not interleave their segments on the stream
+    std::lock_guard<std::mutex> lock{send_mutex_};
+    peer_socket_->write_segments(packet.segments());
 }
 
 extern "C" MY_EXPORT_API plugin* this_plugin_factory(phonebook* pb) {
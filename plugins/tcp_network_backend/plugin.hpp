@@ -18,8 +18,8 @@ public:
     void read_loop(network::TCPSocket* socket);
     void topic_create(std::string topic_name, network::topic_config& config) override;
     bool is_topic_networked(std::string topic_name) override;
-    void topic_send(std::string topic_name, std::string&& message) override;
-    void topic_receive(const std::string& topic_name, std::vector<char>& message);
+    void topic_send(std::string topic_name, network::message&& message) override;
+    void topic_receive(const std::string& topic_name, std::string&& message);
     void stop() override;
 
     network::topic_config::TransportMethod transport_method() const override {
@@ -29,12 +29,17 @@ public:
     bool client;
 
 private:
-    void send_to_peer(const std::string& topic_name, std::string&& message);
+    void send_to_peer(const std::string& topic_name, network::message&& message);
+
+    // Largest packet, header included, that is sent or accepted; a larger length in a received header means the stream
+    // is corrupt or the peer is not an ILLIXR backend
+    static constexpr uint32_t MAX_PACKET_SIZE = 256u << 20;
 
     std::shared_ptr<switchboard> switchboard_;
     std::atomic<bool>            running_     = true;
     std::atomic<bool>            ready_       = false;
     network::TCPSocket*          peer_socket_ = nullptr;
+    std::mutex                   send_mutex_;
 
     std::string server_ip_;
     int         server_port_;
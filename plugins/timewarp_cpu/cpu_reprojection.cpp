@@ -0,0 +1,593 @@
+#include "cpu_reprojection.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+using namespace ILLIXR;
+using namespace ILLIXR::data_format;
+
+/**
+ * A fixed set of threads that work through [0, count) in chunks, together with the thread that calls run(). Every worker
+ * acknowledges every job, so no worker can still be reading a job after run() has returned.
+ */
+class cpu_reprojection::row_pool {
+public:
+    explicit row_pool(unsigned thread_count) {
+        for (unsigned i = 1; i < thread_count; ++i) {
+            workers_.emplace_back([this] {
+                work();
+            });
+        }
+    }
+
+    ~row_pool() {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    [[nodiscard]] unsigned size() const {
+        return static_cast<unsigned>(workers_.size()) + 1;
+    }
+
+    void run(int count, int grain, const std::function<void(int, int)>& job) {
+        if (workers_.empty() || count <= grain) {
+            job(0, count);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            job_     = &job;
+            count_   = count;
+            grain_   = grain;
+            pending_ = static_cast<int>(workers_.size());
+            next_.store(0, std::memory_order_relaxed);
+            ++generation_;
+        }
+        start_.notify_all();
+        drain(job, count, grain);
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        done_.wait(lock, [this] {
+            return pending_ == 0;
+        });
+        job_ = nullptr;
+    }
+
+private:
+    void drain(const std::function<void(int, int)>& job, int count, int grain) {
+        for (int first = next_.fetch_add(grain, std::memory_order_relaxed); first < count;
+             first     = next_.fetch_add(grain, std::memory_order_relaxed)) {
+            job(first, std::min(first + grain, count));
+        }
+    }
+
+    void work() {
+        std::uint64_t                seen = 0;
+        std::unique_lock<std::mutex> lock{mutex_};
+        while (true) {
+            start_.wait(lock, [&] {
+                return stop_ || generation_ != seen;
+            });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+
+            const std::function<void(int, int)>& job   = *job_;
+            const int                            count = count_;
+            const int                            grain = grain_;
+            lock.unlock();
+            drain(job, count, grain);
+            lock.lock();
+
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::mutex                           mutex_;
+    std::condition_variable              start_;
+    std::condition_variable              done_;
+    const std::function<void(int, int)>* job_        = nullptr;
+    int                                  count_      = 0;
+    int                                  grain_      = 1;
+    int                                  pending_    = 0;
+    std::uint64_t                        generation_ = 0;
+    bool                                 stop_       = false;
+    std::atomic<int>                     next_{0};
+    std::vector<std::thread>             workers_;
+};
+
+namespace {
+
+// Rows handed to a thread at a time
+constexpr int row_grain = 8;
+
+// Texture coordinates that sample only the black border, for pixels nothing was rasterized to
+constexpr float outside = -8.0f;
+
+// Bilinear fetch of one depth value, black (0) outside the image like the openwarp_vk sampler
+float sample_depth(const cpu_eye_image& src, float u, float v) {
+    const float x  = std::min(src.width + 1.0f, std::max(-2.0f, u * src.width - 0.5f));
+    const float y  = std::min(src.height + 1.0f, std::max(-2.0f, v * src.height - 0.5f));
+    const int   x0 = static_cast<int>(x + 2.0f) - 2;
+    const int   y0 = static_cast<int>(y + 2.0f) - 2;
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+
+    auto texel = [&](int tx, int ty) {
+        return static_cast<unsigned>(tx) < static_cast<unsigned>(src.width) &&
+                static_cast<unsigned>(ty) < static_cast<unsigned>(src.height)
+            ? src.depth[static_cast<std::size_t>(ty) * src.width + tx]
+            : 0.0f;
+    };
+
+    const float top    = texel(x0, y0) + fx * (texel(x0 + 1, y0) - texel(x0, y0));
+    const float bottom = texel(x0, y0 + 1) + fx * (texel(x0 + 1, y0 + 1) - texel(x0, y0 + 1));
+    return top + fy * (bottom - top);
+}
+
+// openwarp_mesh.vert: the depth at uv, pushed to the nearer side of any depth edge within the bleed radius
+float dilated_depth(const cpu_eye_image& src, float u, float v, bool reverse_z) {
+    constexpr float bleed_radius   = 0.002f;
+    constexpr float edge_tolerance = 0.01f;
+    constexpr float diagonal       = bleed_radius * 0.70710678f;
+
+    const float z          = sample_depth(src, u, v);
+    const float samples[8] = {sample_depth(src, u - bleed_radius, v), sample_depth(src, u + bleed_radius, v),
+                              sample_depth(src, u, v - bleed_radius), sample_depth(src, u, v + bleed_radius),
+                              sample_depth(src, u + diagonal, v + diagonal), sample_depth(src, u - diagonal, v - diagonal),
+                              sample_depth(src, u - diagonal, v + diagonal), sample_depth(src, u + diagonal, v - diagonal)};
+    if (reverse_z) {
+        const float outlier = *std::max_element(std::begin(samples), std::end(samples));
+        return std::max(0.01f, outlier - z > edge_tolerance ? outlier : z);
+    }
+    const float outlier = *std::min_element(std::begin(samples), std::end(samples));
+    return std::min(0.99f, z - outlier > edge_tolerance ? outlier : z);
+}
+
+} // namespace
+
+void cpu_reprojection_detail::sample_channel_scalar(const cpu_eye_image& src, const float* u, const float* v, int channel,
+                                                    std::uint8_t* out, int count) {
+    const int           width  = src.width;
+    const int           height = src.height;
+    const std::uint8_t* pixels = src.rgba.data() + channel;
+
+    auto texel = [&](int tx, int ty) {
+        return static_cast<unsigned>(tx) < static_cast<unsigned>(width) &&
+                static_cast<unsigned>(ty) < static_cast<unsigned>(height)
+            ? static_cast<float>(pixels[(static_cast<std::size_t>(ty) * width + tx) * 4])
+            : 0.0f;
+    };
+
+    for (int i = 0; i < count; ++i) {
+        // Clamped so the conversions below cannot overflow; NaN clamps to the border too. Truncating the (positive)
+        // shifted coordinate is a floor that, unlike std::floor, does not need SSE4.1 to be inlined.
+        const float x  = std::min(width + 1.0f, std::max(-2.0f, u[i] * static_cast<float>(width) - 0.5f));
+        const float y  = std::min(height + 1.0f, std::max(-2.0f, v[i] * static_cast<float>(height) - 0.5f));
+        const int   x0 = static_cast<int>(x + 2.0f) - 2;
+        const int   y0 = static_cast<int>(y + 2.0f) - 2;
+        const float fx = x - static_cast<float>(x0);
+        const float fy = y - static_cast<float>(y0);
+
+        float t00, t10, t01, t11;
+        if (x0 >= 0 && y0 >= 0 && x0 + 1 < width && y0 + 1 < height) {
+            // All four texels inside, by far the common case
+            const std::uint8_t* texels = pixels + (static_cast<std::size_t>(y0) * width + x0) * 4;
+            t00                        = static_cast<float>(texels[0]);
+            t10                        = static_cast<float>(texels[4]);
+            t01                        = static_cast<float>(texels[static_cast<std::size_t>(width) * 4]);
+            t11                        = static_cast<float>(texels[static_cast<std::size_t>(width) * 4 + 4]);
+        } else {
+            t00 = texel(x0, y0);
+            t10 = texel(x0 + 1, y0);
+            t01 = texel(x0, y0 + 1);
+            t11 = texel(x0 + 1, y0 + 1);
+        }
+
+        const float top    = t00 + fx * (t10 - t00);
+        const float bottom = t01 + fx * (t11 - t01);
+        out[i * 4]         = static_cast<std::uint8_t>(top + fy * (bottom - top) + 0.5f);
+    }
+}
+
+void cpu_reprojection_detail::sample_channel(const cpu_eye_image& src, const float* u, const float* v, int channel,
+                                             std::uint8_t* out, int count) {
+    int i = 0;
+#if defined(__AVX2__)
+    // Same arithmetic as the scalar loop, eight pixels at a time. The four texels are gathered as whole RGBA words
+    // (so the last pixel of the image never reads past the end) with out-of-image lanes masked to zero.
+    const int*    pixels   = reinterpret_cast<const int*>(src.rgba.data());
+    const __m256  width    = _mm256_set1_ps(static_cast<float>(src.width));
+    const __m256  height   = _mm256_set1_ps(static_cast<float>(src.height));
+    const __m256  max_x    = _mm256_set1_ps(src.width + 1.0f);
+    const __m256  max_y    = _mm256_set1_ps(src.height + 1.0f);
+    const __m256  min_xy   = _mm256_set1_ps(-2.0f);
+    const __m256  half     = _mm256_set1_ps(0.5f);
+    const __m256  two      = _mm256_set1_ps(2.0f);
+    const __m256i two_i    = _mm256_set1_epi32(2);
+    const __m256i width_i  = _mm256_set1_epi32(src.width);
+    const __m256i height_i = _mm256_set1_epi32(src.height);
+    const __m256i minus_1  = _mm256_set1_epi32(-1);
+    const __m256i one      = _mm256_set1_epi32(1);
+    const __m256i byte     = _mm256_set1_epi32(0xFF);
+    const __m128i shift    = _mm_cvtsi32_si128(channel * 8);
+
+    auto fetch = [&](__m256i index, __m256i in_x, __m256i in_y) {
+        const __m256i mask  = _mm256_and_si256(in_x, in_y);
+        const __m256i words = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), pixels, index, mask, 4);
+        return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(words, shift), byte));
+    };
+
+    alignas(32) std::int32_t values[8];
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(u + i), width), half);
+        __m256 y = _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(v + i), height), half);
+        // max_ps returns its second operand for NaN, matching std::max(-2.0f, x)
+        x = _mm256_min_ps(_mm256_max_ps(x, min_xy), max_x);
+        y = _mm256_min_ps(_mm256_max_ps(y, min_xy), max_y);
+
+        const __m256i x0 = _mm256_sub_epi32(_mm256_cvttps_epi32(_mm256_add_ps(x, two)), two_i);
+        const __m256i y0 = _mm256_sub_epi32(_mm256_cvttps_epi32(_mm256_add_ps(y, two)), two_i);
+        const __m256  fx = _mm256_sub_ps(x, _mm256_cvtepi32_ps(x0));
+        const __m256  fy = _mm256_sub_ps(y, _mm256_cvtepi32_ps(y0));
+        const __m256i x1 = _mm256_add_epi32(x0, one);
+        const __m256i y1 = _mm256_add_epi32(y0, one);
+
+        const __m256i in_x0 = _mm256_and_si256(_mm256_cmpgt_epi32(x0, minus_1), _mm256_cmpgt_epi32(width_i, x0));
+        const __m256i in_x1 = _mm256_and_si256(_mm256_cmpgt_epi32(x1, minus_1), _mm256_cmpgt_epi32(width_i, x1));
+        const __m256i in_y0 = _mm256_and_si256(_mm256_cmpgt_epi32(y0, minus_1), _mm256_cmpgt_epi32(height_i, y0));
+        const __m256i in_y1 = _mm256_and_si256(_mm256_cmpgt_epi32(y1, minus_1), _mm256_cmpgt_epi32(height_i, y1));
+
+        const __m256i row0 = _mm256_add_epi32(_mm256_mullo_epi32(y0, width_i), x0);
+        const __m256i row1 = _mm256_add_epi32(row0, width_i);
+
+        const __m256 t00 = fetch(row0, in_x0, in_y0);
+        const __m256 t10 = fetch(_mm256_add_epi32(row0, one), in_x1, in_y0);
+        const __m256 t01 = fetch(row1, in_x0, in_y1);
+        const __m256 t11 = fetch(_mm256_add_epi32(row1, one), in_x1, in_y1);
+
+        const __m256 top    = _mm256_add_ps(t00, _mm256_mul_ps(fx, _mm256_sub_ps(t10, t00)));
+        const __m256 bottom = _mm256_add_ps(t01, _mm256_mul_ps(fx, _mm256_sub_ps(t11, t01)));
+        const __m256 value  = _mm256_add_ps(_mm256_add_ps(top, _mm256_mul_ps(fy, _mm256_sub_ps(bottom, top))), half);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values), _mm256_cvttps_epi32(value));
+        for (int k = 0; k < 8; ++k) {
+            out[(i + k) * 4] = static_cast<std::uint8_t>(values[k]);
+        }
+    }
+#endif
+    sample_channel_scalar(src, u + i, v + i, channel, out + i * 4, count - i);
+}
+
+cpu_reprojection::cpu_reprojection(const HMD::hmd_info_t& hmd_info, const distortion_mesh& mesh, unsigned thread_count)
+    : tiles_wide_{hmd_info.eye_tiles_wide}
+    , tiles_high_{hmd_info.eye_tiles_high}
+    , mesh_top_{-1.0f +
+                2.0f * static_cast<float>(hmd_info.eye_tiles_high * hmd_info.tile_pixels_high) /
+                    static_cast<float>(hmd_info.display_pixels_high)}
+    , positions_{mesh.positions}
+    , coefficients_{mesh.uv}
+    , pool_{std::make_unique<row_pool>(thread_count == 0 ? std::max(std::thread::hardware_concurrency(), 1u)
+                                                         : thread_count)} {
+    for (int channel = 0; channel < HMD::NUM_COLOR_CHANNELS; ++channel) {
+        vertex_u_[channel].resize(mesh.vertices_per_eye);
+        vertex_v_[channel].resize(mesh.vertices_per_eye);
+    }
+}
+
+cpu_reprojection::~cpu_reprojection() = default;
+
+unsigned cpu_reprojection::thread_count() const {
+    return pool_->size();
+}
+
+void cpu_reprojection::set_openwarp_grid(int width, int height) {
+    grid_wide_ = width;
+    grid_high_ = height;
+    grid_.clear();
+}
+
+Eigen::Matrix4f cpu_reprojection::timewarp_transform(const Eigen::Matrix4f& render_projection,
+                                                     const Eigen::Matrix4f& render_view, const Eigen::Matrix4f& new_view) {
+    Eigen::Matrix4f tex_coord_projection;
+    tex_coord_projection << 0.5f * render_projection(0, 0), 0.0f, 0.5f * render_projection(0, 2) - 0.5f, 0.0f, 0.0f,
+        -0.5f * render_projection(1, 1), 0.5f * render_projection(1, 2) - 0.5f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f;
+
+    // Only the rotation between the two views is corrected
+    Eigen::Matrix4f delta_view = render_view.inverse() * new_view;
+    delta_view(0, 3)           = 0.0f;
+    delta_view(1, 3)           = 0.0f;
+    delta_view(2, 3)           = 0.0f;
+    return tex_coord_projection * delta_view;
+}
+
+Eigen::Matrix4f cpu_reprojection::distortion_transform(const Eigen::Matrix4f& projection) {
+    Eigen::Matrix4f tex_coord_projection;
+    tex_coord_projection << 0.5f * projection(0, 0), 0.0f, 0.5f * projection(0, 2) - 0.5f, 0.0f, 0.0f,
+        -0.5f * projection(1, 1), 0.5f * projection(1, 2) - 0.5f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f;
+    return tex_coord_projection;
+}
+
+void cpu_reprojection::timewarp(int eye, const cpu_eye_image& src, const Eigen::Matrix4f& start_transform,
+                                const Eigen::Matrix4f& end_transform, cpu_eye_image& dst) {
+    distort(eye, src, start_transform, end_transform, dst);
+}
+
+void cpu_reprojection::distort(int eye, const cpu_eye_image& src, const Eigen::Matrix4f& start_transform,
+                               const Eigen::Matrix4f& end_transform, cpu_eye_image& dst) {
+    // The vertex shader: both transforms applied to (u, v, -1, 1), blended across the display, then the divide
+    const int                  vertices  = static_cast<int>(vertex_u_[0].size());
+    const HMD::mesh_coord3d_t* positions = positions_.data() + static_cast<std::size_t>(eye) * vertices;
+    for (int channel = 0; channel < HMD::NUM_COLOR_CHANNELS; ++channel) {
+        const HMD::uv_coord_t* coefficients = coefficients_[channel].data() + static_cast<std::size_t>(eye) * vertices;
+        float*                 out_u        = vertex_u_[channel].data();
+        float*                 out_v        = vertex_v_[channel].data();
+        for (int i = 0; i < vertices; ++i) {
+            const Eigen::Vector4f coefficient{coefficients[i].u, coefficients[i].v, -1.0f, 1.0f};
+            const float           display_fraction = positions[i].x * 0.5f + 0.5f;
+            const Eigen::Vector4f start            = start_transform * coefficient;
+            const Eigen::Vector4f end              = end_transform * coefficient;
+            const Eigen::Vector4f blended          = start + display_fraction * (end - start);
+            const float           factor           = 1.0f / std::max(blended.z(), 0.00001f);
+
+            out_u[i] = blended.x() * factor;
+            out_v[i] = blended.y() * factor;
+        }
+    }
+
+    if (static_cast<int>(tile_first_x_.size()) != tiles_wide_ + 1 || tile_first_x_.back() != dst.width) {
+        const float x_scale = static_cast<float>(tiles_wide_) / static_cast<float>(dst.width);
+        // The output columns each column of quads covers, found the same way the rasterizer would: by pixel centre
+        tile_first_x_.assign(tiles_wide_ + 1, dst.width);
+        for (int x = dst.width - 1; x >= 0; --x) {
+            const float mesh_x = (static_cast<float>(x) + 0.5f) * x_scale;
+            tile_first_x_[std::min(static_cast<int>(mesh_x), tiles_wide_ - 1)] = x;
+        }
+        for (int tile_x = tiles_wide_ - 1; tile_x >= 0; --tile_x) {
+            tile_first_x_[tile_x] = std::min(tile_first_x_[tile_x], tile_first_x_[tile_x + 1]);
+        }
+    }
+
+    pool_->run(dst.height, row_grain, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            distort_row(y, src, dst);
+        }
+    });
+}
+
+void cpu_reprojection::distort_row(int y, const cpu_eye_image& src, cpu_eye_image& dst) const {
+    std::uint8_t* out = dst.rgba.data() + static_cast<std::size_t>(y) * dst.width * 4;
+
+    // Which row of mesh quads this pixel row crosses, and how far down it. The mesh covers NDC y from mesh_top_ at its
+    // first row down to -1 at its last.
+    const float ndc_y  = 1.0f - 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(dst.height);
+    const float mesh_y = (mesh_top_ - ndc_y) / (mesh_top_ + 1.0f) * static_cast<float>(tiles_high_);
+    if (!(mesh_y >= 0.0f && mesh_y <= static_cast<float>(tiles_high_))) {
+        std::fill(out, out + static_cast<std::size_t>(dst.width) * 4, std::uint8_t{0});
+        for (int x = 0; x < dst.width; ++x) {
+            out[x * 4 + 3] = 255;
+        }
+        return;
+    }
+    const int   tile_y = std::min(static_cast<int>(mesh_y), tiles_high_ - 1);
+    const float fy     = mesh_y - static_cast<float>(tile_y);
+
+    thread_local std::vector<float> row_u[HMD::NUM_COLOR_CHANNELS];
+    thread_local std::vector<float> row_v[HMD::NUM_COLOR_CHANNELS];
+
+    // Interpolate the vertex UVs over the two triangles of each quad, split along the diagonal the index list uses.
+    // Along a row both triangles are linear in x, so each quad's pixels are a straight, vectorizable loop.
+    const int   stride  = tiles_wide_ + 1;
+    const float x_scale = static_cast<float>(tiles_wide_) / static_cast<float>(dst.width);
+    const float split   = 1.0f - fy; // the diagonal
+    for (int channel = 0; channel < HMD::NUM_COLOR_CHANNELS; ++channel) {
+        row_u[channel].resize(dst.width);
+        row_v[channel].resize(dst.width);
+
+        const float* vertex_u = vertex_u_[channel].data() + tile_y * stride;
+        const float* vertex_v = vertex_v_[channel].data() + tile_y * stride;
+        float*       out_u    = row_u[channel].data();
+        float*       out_v    = row_v[channel].data();
+        for (int tile_x = 0; tile_x < tiles_wide_; ++tile_x) {
+            // value = base + fx * slope, on either side of the diagonal
+            const int   left          = tile_x;
+            const int   right         = tile_x + 1;
+            const float upper_slope_u = vertex_u[right] - vertex_u[left];
+            const float upper_slope_v = vertex_v[right] - vertex_v[left];
+            const float upper_base_u  = vertex_u[left] + fy * (vertex_u[left + stride] - vertex_u[left]);
+            const float upper_base_v  = vertex_v[left] + fy * (vertex_v[left + stride] - vertex_v[left]);
+            const float lower_slope_u = vertex_u[right + stride] - vertex_u[left + stride];
+            const float lower_slope_v = vertex_v[right + stride] - vertex_v[left + stride];
+            const float lower_base_u  = vertex_u[left + stride] + split * (vertex_u[right] - vertex_u[right + stride]);
+            const float lower_base_v  = vertex_v[left + stride] + split * (vertex_v[right] - vertex_v[right + stride]);
+            const float tile_start    = static_cast<float>(tile_x);
+
+            // The pixels left of the diagonal come first; either formula is right on it
+            const int   x_begin = tile_first_x_[tile_x];
+            const int   x_end   = tile_first_x_[tile_x + 1];
+            const float x_last  = (tile_start + split) / x_scale - 0.5f;
+            const int   x_split =
+                std::min(x_end, x_last < static_cast<float>(x_begin) ? x_begin : static_cast<int>(x_last) + 1);
+            for (int x = x_begin; x < x_split; ++x) {
+                const float fx = (static_cast<float>(x) + 0.5f) * x_scale - tile_start;
+                out_u[x]       = upper_base_u + fx * upper_slope_u;
+                out_v[x]       = upper_base_v + fx * upper_slope_v;
+            }
+            for (int x = x_split; x < x_end; ++x) {
+                const float fx = (static_cast<float>(x) + 0.5f) * x_scale - tile_start;
+                out_u[x]       = lower_base_u + fx * lower_slope_u;
+                out_v[x]       = lower_base_v + fx * lower_slope_v;
+            }
+        }
+        cpu_reprojection_detail::sample_channel(src, row_u[channel].data(), row_v[channel].data(), channel, out + channel,
+                                                dst.width);
+    }
+    for (int x = 0; x < dst.width; ++x) {
+        out[x * 4 + 3] = 255;
+    }
+}
+
+void cpu_reprojection::openwarp(int eye, const cpu_eye_image& src, const openwarp_matrices& matrices,
+                                const Eigen::Matrix4f& distortion, bool reverse_z, cpu_eye_image& dst) {
+    const int stride = grid_wide_ + 1;
+    grid_.resize(static_cast<std::size_t>(stride) * (grid_high_ + 1));
+    grid_row_min_y_.resize(grid_high_);
+    grid_row_max_y_.resize(grid_high_);
+    if (offscreen_.width != dst.width || offscreen_.height != dst.height) {
+        offscreen_ = cpu_eye_image{dst.width, dst.height};
+        offscreen_depth_.resize(offscreen_.rgba.size() / 4);
+        offscreen_u_.resize(offscreen_depth_.size());
+        offscreen_v_.resize(offscreen_depth_.size());
+    }
+
+    // openwarp_mesh.vert for every grid vertex. The outermost vertices are pushed half an image past the edges, as in
+    // openwarp_vk, so that the border is stretched over any area the reprojection uncovers.
+    const Eigen::Matrix4f render_to_warp = matrices.warp_view_projection * matrices.render_camera;
+    pool_->run(grid_high_ + 1, 1, [&](int first, int last) {
+        for (int gy = first; gy < last; ++gy) {
+            const float v = gy == 0 ? -0.5f
+                : gy == grid_high_  ? 1.5f
+                                    : static_cast<float>(gy) / static_cast<float>(grid_high_);
+            for (int gx = 0; gx <= grid_wide_; ++gx) {
+                const float u = gx == 0 ? -0.5f
+                    : gx == grid_wide_  ? 1.5f
+                                        : static_cast<float>(gx) / static_cast<float>(grid_wide_);
+
+                const float           z    = dilated_depth(src, u, v, reverse_z);
+                const Eigen::Vector4f ndc{u * 2.0f - 1.0f, 1.0f - v * 2.0f, z, 1.0f};
+                Eigen::Vector4f       view = matrices.render_inverse_projection * ndc;
+                view /= view.w();
+                const Eigen::Vector4f clip = render_to_warp * view;
+
+                // Culled unless in front of the camera and inside the [0, 1] depth range
+                warped_vertex& out = grid_[static_cast<std::size_t>(gy) * stride + gx];
+                const float    w   = std::fabs(clip.w());
+                out.valid          = clip.w() > 0.0f && clip.z() >= 0.0f && clip.z() <= w;
+                out.x              = (clip.x() / w * 0.5f + 0.5f) * static_cast<float>(dst.width);
+                out.y              = (0.5f - clip.y() / w * 0.5f) * static_cast<float>(dst.height);
+                out.z              = clip.z() / w;
+                out.u              = u;
+                out.v              = v;
+            }
+        }
+    });
+    for (int gy = 0; gy < grid_high_; ++gy) {
+        float low  = HUGE_VALF;
+        float high = -HUGE_VALF;
+        for (int i = gy * stride; i < (gy + 2) * stride; ++i) {
+            if (grid_[i].valid) {
+                low  = std::min(low, grid_[i].y);
+                high = std::max(high, grid_[i].y);
+            }
+        }
+        grid_row_min_y_[gy] = low;
+        grid_row_max_y_[gy] = high;
+    }
+
+    // Rasterize into horizontal bands, one thread per band at a time, so no two threads touch the same pixel
+    const int band = std::max(row_grain, dst.height / static_cast<int>(pool_->size() * 4));
+    pool_->run((dst.height + band - 1) / band, 1, [&](int first, int last) {
+        for (int b = first; b < last; ++b) {
+            rasterize_band(b * band, std::min((b + 1) * band, dst.height), reverse_z);
+        }
+    });
+
+    // The offscreen image the distortion pass samples
+    pool_->run(dst.height, row_grain, [&](int first, int last) {
+        for (int y = first; y < last; ++y) {
+            const std::size_t row = static_cast<std::size_t>(y) * dst.width;
+            std::uint8_t*     out = offscreen_.rgba.data() + row * 4;
+            for (int channel = 0; channel < 3; ++channel) {
+                cpu_reprojection_detail::sample_channel(src, offscreen_u_.data() + row, offscreen_v_.data() + row, channel,
+                                                        out + channel, dst.width);
+            }
+            for (int x = 0; x < dst.width; ++x) {
+                out[x * 4 + 3] = 255;
+            }
+        }
+    });
+
+    distort(eye, offscreen_, distortion, distortion, dst);
+}
+
+void cpu_reprojection::rasterize_band(int first_row, int last_row, bool reverse_z) {
+    const int   width  = offscreen_.width;
+    const int   stride = grid_wide_ + 1;
+    const float clear  = reverse_z ? 0.0f : 1.0f;
+    for (int y = first_row; y < last_row; ++y) {
+        const std::size_t row = static_cast<std::size_t>(y) * width;
+        std::fill_n(offscreen_depth_.data() + row, width, clear);
+        std::fill_n(offscreen_u_.data() + row, width, outside);
+        std::fill_n(offscreen_v_.data() + row, width, outside);
+    }
+
+    auto draw = [&](const warped_vertex& a, const warped_vertex& b, const warped_vertex& c) {
+        if (!(a.valid && b.valid && c.valid)) {
+            return;
+        }
+        const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (!(std::fabs(area) > 1e-12f)) {
+            return;
+        }
+        const float inverse_area = 1.0f / area;
+
+        // Pixel centres inside the bounding box and the band
+        const int x_begin = std::max(0, static_cast<int>(std::ceil(std::min({a.x, b.x, c.x}) - 0.5f)));
+        const int x_end   = std::min(width, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}) - 0.5f)));
+        const int y_begin = std::max(first_row, static_cast<int>(std::ceil(std::min({a.y, b.y, c.y}) - 0.5f)));
+        const int y_end   = std::min(last_row, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}) - 0.5f)));
+
+        for (int y = y_begin; y < y_end; ++y) {
+            const float       py  = static_cast<float>(y) + 0.5f;
+            const std::size_t row = static_cast<std::size_t>(y) * width;
+            for (int x = x_begin; x < x_end; ++x) {
+                const float px = static_cast<float>(x) + 0.5f;
+                // Barycentric weights of b and c; both triangle windings are drawn
+                const float wb = ((px - a.x) * (c.y - a.y) - (py - a.y) * (c.x - a.x)) * inverse_area;
+                const float wc = ((b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x)) * inverse_area;
+                const float wa = 1.0f - wb - wc;
+                if (wa < 0.0f || wb < 0.0f || wc < 0.0f) {
+                    continue;
+                }
+
+                const float z     = wa * a.z + wb * b.z + wc * c.z;
+                float&      depth = offscreen_depth_[row + x];
+                if (reverse_z ? z >= depth : z <= depth) {
+                    depth                 = z;
+                    offscreen_u_[row + x] = wa * a.u + wb * b.u + wc * c.u;
+                    offscreen_v_[row + x] = wa * a.v + wb * b.v + wc * c.v;
+                }
+            }
+        }
+    };
+
+    for (int gy = 0; gy < grid_high_; ++gy) {
+        if (grid_row_max_y_[gy] < static_cast<float>(first_row) || grid_row_min_y_[gy] > static_cast<float>(last_row)) {
+            continue;
+        }
+        const warped_vertex* top    = grid_.data() + static_cast<std::size_t>(gy) * stride;
+        const warped_vertex* bottom = top + stride;
+        for (int gx = 0; gx < grid_wide_; ++gx) {
+            draw(top[gx], bottom[gx], top[gx + 1]);
+            draw(top[gx + 1], bottom[gx], bottom[gx + 1]);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "illixr/data_format/cpu_frame.hpp"
+#include "illixr/distortion_mesh.hpp"
+
+#include <cstdint>
+#include <eigen3/Eigen/Core>
+#include <memory>
+#include <vector>
+
+namespace ILLIXR {
+
+/**
+ * @brief Reprojection of CPU eye buffers: the rotational timewarp of timewarp_gl/timewarp_vk and the depth-based
+ * openwarp of openwarp_vk, both followed by the lens distortion and chromatic aberration correction.
+ *
+ * The GPU plugins rasterize the distortion mesh and let the sampler do the rest. Here every output row is walked across
+ * the same mesh: the per-vertex texture coordinates are interpolated over the mesh's triangles exactly as the
+ * rasterizer would, then each colour channel is fetched with a bilinear filter at its own coordinate (clamp-to-border,
+ * black). The fetch is done eight pixels at a time with AVX2 gathers when the build targets AVX2, and with a scalar
+ * loop otherwise; the rest of the row is straight-line float loops the compiler vectorizes. Rows are spread over a
+ * fixed set of worker threads.
+ *
+ * Openwarp is done the way openwarp_vk does it: a grid over the eye buffer is unprojected with the (dilated) depth and
+ * reprojected to the latest pose, the grid's triangles are rasterized with a depth test into an offscreen image, and
+ * that image is distortion-corrected. Triangles with a vertex behind the camera or outside the depth range are culled
+ * rather than clipped.
+ *
+ * Images use the conventions of data_format::cpu_eye_image: top row first, texture coordinate (0, 0) at the top left.
+ * Output images must be sized by the caller; every pixel of them is written.
+ */
+class cpu_reprojection {
+public:
+    /// The openwarp_vk uniforms for one eye
+    struct openwarp_matrices {
+        Eigen::Matrix4f render_inverse_projection; ///< Inverse of the projection the eye buffer was rendered with
+        Eigen::Matrix4f render_camera;             ///< Camera-to-world transform of the render pose
+        Eigen::Matrix4f warp_view_projection;      ///< Display projection times the view matrix of the latest pose
+    };
+
+    /**
+     * @param thread_count Threads to spread rows over, including the calling one; 0 means one per core
+     */
+    cpu_reprojection(const HMD::hmd_info_t& hmd_info, const distortion_mesh& mesh, unsigned thread_count = 0);
+    ~cpu_reprojection();
+
+    cpu_reprojection(const cpu_reprojection&)            = delete;
+    cpu_reprojection& operator=(const cpu_reprojection&) = delete;
+
+    /**
+     * @brief Rotational timewarp of one eye, interpolating from @p start_transform at the left edge of the display to
+     * @p end_transform at the right edge (see timewarp_transform()).
+     */
+    void timewarp(int eye, const data_format::cpu_eye_image& src, const Eigen::Matrix4f& start_transform,
+                  const Eigen::Matrix4f& end_transform, data_format::cpu_eye_image& dst);
+
+    /**
+     * @brief Depth-based reprojection of one eye; @p src must carry depth. @p distortion is distortion_transform() of
+     * the display projection.
+     */
+    void openwarp(int eye, const data_format::cpu_eye_image& src, const openwarp_matrices& matrices,
+                  const Eigen::Matrix4f& distortion, bool reverse_z, data_format::cpu_eye_image& dst);
+
+    /**
+     * @brief Sets the resolution, in quads, of the grid openwarp reprojects (ILLIXR_OPENWARP_WIDTH/HEIGHT in
+     * openwarp_vk). The default is 512 x 512.
+     */
+    void set_openwarp_grid(int width, int height);
+
+    [[nodiscard]] unsigned thread_count() const;
+
+    /**
+     * @brief timewarp_vk's transform from tangent-angle distortion coordinates to texture coordinates of the eye buffer
+     * rendered at @p render_view, as seen from @p new_view (rotation only).
+     */
+    static Eigen::Matrix4f timewarp_transform(const Eigen::Matrix4f& render_projection, const Eigen::Matrix4f& render_view,
+                                              const Eigen::Matrix4f& new_view);
+
+    /**
+     * @brief openwarp_vk's transform from tangent-angle distortion coordinates to texture coordinates, without warping.
+     */
+    static Eigen::Matrix4f distortion_transform(const Eigen::Matrix4f& projection);
+
+private:
+    class row_pool;
+
+    struct warped_vertex {
+        float x, y, z; ///< Output pixel coordinates and device depth
+        float u, v;    ///< Texture coordinates in the eye buffer
+        bool  valid;
+    };
+
+    void distort(int eye, const data_format::cpu_eye_image& src, const Eigen::Matrix4f& start_transform,
+                 const Eigen::Matrix4f& end_transform, data_format::cpu_eye_image& dst);
+    void distort_row(int y, const data_format::cpu_eye_image& src, data_format::cpu_eye_image& dst) const;
+    void rasterize_band(int first_row, int last_row, bool reverse_z);
+
+    const int   tiles_wide_;
+    const int   tiles_high_;
+    const float mesh_top_; ///< NDC y of the top row of the mesh; the bottom row is at -1
+
+    std::vector<HMD::mesh_coord3d_t>                                  positions_;
+    std::array<std::vector<HMD::uv_coord_t>, HMD::NUM_COLOR_CHANNELS> coefficients_;
+
+    // Texture coordinates of the current frame's mesh vertices, per channel, and the first output column of each column
+    // of quads followed by the output width
+    std::array<std::vector<float>, HMD::NUM_COLOR_CHANNELS> vertex_u_;
+    std::array<std::vector<float>, HMD::NUM_COLOR_CHANNELS> vertex_v_;
+    std::vector<int>                                        tile_first_x_;
+
+    // Openwarp grid and offscreen target
+    int                        grid_wide_ = 512;
+    int                        grid_high_ = 512;
+    std::vector<warped_vertex> grid_;
+    std::vector<float>         grid_row_min_y_; ///< Per row of quads, the output rows they can touch
+    std::vector<float>         grid_row_max_y_;
+    std::vector<float>         offscreen_depth_;
+    std::vector<float>         offscreen_u_;
+    std::vector<float>         offscreen_v_;
+    data_format::cpu_eye_image offscreen_;
+
+    std::unique_ptr<row_pool> pool_;
+};
+
+namespace cpu_reprojection_detail {
+
+/**
+ * @brief Bilinearly samples one channel of @p src at @p count texture coordinates, writing every fourth byte of @p out.
+ * Texels outside the image read as 0.
+ */
+void sample_channel(const data_format::cpu_eye_image& src, const float* u, const float* v, int channel, std::uint8_t* out,
+                    int count);
+
+/// The scalar form of sample_channel(), also used for the tail of each row
+void sample_channel_scalar(const data_format::cpu_eye_image& src, const float* u, const float* v, int channel,
+                           std::uint8_t* out, int count);
+
+} // namespace cpu_reprojection_detail
+
+} // namespace ILLIXR
@@ -0,0 +1,157 @@
+#include "plugin.hpp"
+
+#include "illixr/global_module_defs.hpp"
+#include "illixr/math_util.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ILLIXR;
+using namespace ILLIXR::data_format;
+
+[[maybe_unused]] timewarp_cpu::timewarp_cpu(const std::string& name, phonebook* pb)
+    : threadloop{name, pb}
+    , switchboard_{phonebook_->lookup_impl<switchboard>()}
+    , pose_prediction_{phonebook_->lookup_impl<pose_prediction>()}
+    , clock_{phonebook_->lookup_impl<relative_clock>()}
+    , eyebuffer_{switchboard_->get_reader<cpu_rendered_frame>("cpu_eyebuffer")}
+    , warped_frame_{switchboard_->get_writer<cpu_rendered_frame>("cpu_warped_frame")}
+    , vsync_estimate_{switchboard_->get_writer<switchboard::event_wrapper<time_point>>("vsync_estimate")}
+    , disable_warp_{switchboard_->get_env_bool("ILLIXR_TIMEWARP_DISABLE", "False")}
+    , use_openwarp_{switchboard_->get_env("ILLIXR_TIMEWARP_CPU_MODE", "timewarp") == "openwarp"}
+    , eye_width_{static_cast<int>(display_params::width_pixels / 2)}
+    , eye_height_{static_cast<int>(display_params::height_pixels)} {
+    spdlogger(switchboard_->get_env_char("TIMEWARP_CPU_LOG_LEVEL"));
+
+    HMD::get_default_hmd_info(display_params::width_pixels, display_params::height_pixels, display_params::width_meters,
+                              display_params::height_meters, display_params::lens_separation,
+                              display_params::meters_per_tan_angle, display_params::aberration, hmd_info_);
+    const distortion_mesh mesh = distortion_mesh::load(
+        hmd_info_, switchboard_->get_env("ILLIXR_DISTORTION_CACHE", distortion_mesh::default_cache_dir()));
+    reprojection_ = std::make_unique<cpu_reprojection>(
+        hmd_info_, mesh, static_cast<unsigned>(switchboard_->get_env_ulong("ILLIXR_TIMEWARP_CPU_THREADS", 0)));
+
+    // The same projection the Vulkan warp plugins use for locally rendered frames
+    for (int eye = 0; eye < 2; eye++) {
+        math_util::unreal_projection(&projection_[eye], index_params::fov_left[eye], index_params::fov_right[eye],
+                                     index_params::fov_up[eye], index_params::fov_down[eye]);
+        inverse_projection_[eye] = projection_[eye].inverse();
+    }
+
+    spdlog::get(name_)->info("{} on {} thread(s), {}x{} per eye", use_openwarp_ ? "openwarp" : "timewarp",
+                             reprojection_->thread_count(), eye_width_, eye_height_);
+}
+
+threadloop::skip_option timewarp_cpu::_p_should_skip() {
+    // One frame per display period; there is no display to wait on. The relative_clock is slept on rather than the
+    // steady clock, so that in virtual time the frames are a virtual display period apart.
+    const time_point now = clock_->now();
+    if (now < next_vsync_) {
+        clock_->sleep_until(next_vsync_);
+        return skip_option::skip_and_spin;
+    }
+    // Catch up to the present instead of bursting after a slow frame
+    next_vsync_ += display_params::period;
+    if (next_vsync_ < now) {
+        next_vsync_ = now;
+    }
+    return skip_option::run;
+}
+
+void timewarp_cpu::_p_one_iteration() {
+    const switchboard::ptr<const cpu_rendered_frame> frame = eyebuffer_.get_ro_nullable();
+    if (frame != nullptr) {
+        warp(*frame);
+        return;
+    }
+    if (test_frame_ == nullptr) {
+        test_frame_ = std::make_unique<cpu_rendered_frame>(make_test_frame());
+    }
+    warp(*test_frame_);
+}
+
+void timewarp_cpu::warp(const cpu_rendered_frame& frame) {
+    const auto                 start       = std::chrono::steady_clock::now();
+    const pose::head_pose_type latest_pose = disable_warp_ ? frame.render_pose.pose : pose_prediction_->get_fast_pose().pose;
+
+    std::array<cpu_eye_image, 2> eyes{cpu_eye_image{eye_width_, eye_height_}, cpu_eye_image{eye_width_, eye_height_}};
+    for (int eye = 0; eye < 2; eye++) {
+        if (use_openwarp_) {
+            const cpu_reprojection::openwarp_matrices matrices{
+                inverse_projection_[eye], create_camera_matrix(frame.render_pose.pose, eye),
+                projection_[eye] * create_camera_matrix(latest_pose, eye).inverse()};
+            reprojection_->openwarp(eye, frame.eyes[eye], matrices, cpu_reprojection::distortion_transform(projection_[eye]),
+                                    rendering_params::reverse_z, eyes[eye]);
+        } else {
+            // Rotation only, as in timewarp_vk
+            Eigen::Matrix4f render_view   = Eigen::Matrix4f::Identity();
+            Eigen::Matrix4f latest_view   = Eigen::Matrix4f::Identity();
+            render_view.block(0, 0, 3, 3) = frame.render_pose.pose.orientation.toRotationMatrix();
+            latest_view.block(0, 0, 3, 3) = latest_pose.orientation.toRotationMatrix();
+
+            const Eigen::Matrix4f transform = cpu_reprojection::timewarp_transform(projection_[eye], render_view, latest_view);
+            reprojection_->timewarp(eye, frame.eyes[eye], transform, transform, eyes[eye]);
+        }
+    }
+
+    const std::chrono::duration<double, std::milli> cost = std::chrono::steady_clock::now() - start;
+    recent_costs_ms_[frames_ % RECENT_COSTS] = cost.count();
+    ++frames_;
+    total_cost_ms_ += cost.count();
+    max_cost_ms_ = std::max(max_cost_ms_, cost.count());
+    spdlog::get(name_)->trace("Frame cost: {:.3f} ms", cost.count());
+
+    const time_point now = clock_->now();
+    warped_frame_.put(warped_frame_.allocate<cpu_rendered_frame>(
+        cpu_rendered_frame{std::move(eyes), pose::fast_head_pose_type{latest_pose, now, now}, frame.render_time}));
+    vsync_estimate_.put(vsync_estimate_.allocate<switchboard::event_wrapper<time_point>>(
+        switchboard::event_wrapper<time_point>(next_vsync_)));
+}
+
+void timewarp_cpu::stop() {
+    threadloop::stop();
+    if (frames_ == 0) {
+        return;
+    }
+    std::vector<double> recent(recent_costs_ms_.begin(), recent_costs_ms_.begin() + std::min(frames_, RECENT_COSTS));
+    auto                p99 = recent.begin() + static_cast<std::ptrdiff_t>(recent.size() * 99 / 100);
+    std::nth_element(recent.begin(), p99, recent.end());
+    spdlog::get(name_)->info("{} frames, {:.3f} ms mean, {:.3f} ms max per frame; {:.3f} ms p99 over the last {}", frames_,
+                             total_cost_ms_ / static_cast<double>(frames_), max_cost_ms_, *p99, recent.size());
+}
+
+cpu_rendered_frame timewarp_cpu::make_test_frame() const {
+    // A checkerboard with a cross at the centre of each eye, at a constant 2 m
+    constexpr int square = 64;
+    const float   depth  = rendering_params::reverse_z ? 0.1f / 2.0f : 1.0f - 0.1f / 2.0f;
+
+    std::array<cpu_eye_image, 2> eyes{cpu_eye_image{eye_width_, eye_height_, true},
+                                      cpu_eye_image{eye_width_, eye_height_, true}};
+    for (int eye = 0; eye < 2; eye++) {
+        cpu_eye_image& image = eyes[eye];
+        for (int y = 0; y < image.height; y++) {
+            for (int x = 0; x < image.width; x++) {
+                const bool    light = ((x / square) + (y / square)) % 2 == 0;
+                const bool    cross = std::abs(x - image.width / 2) < 4 || std::abs(y - image.height / 2) < 4;
+                std::uint8_t* pixel = &image.rgba[(static_cast<std::size_t>(y) * image.width + x) * 4];
+                pixel[0]            = cross ? 255 : light ? 200 : 40;
+                pixel[1]            = cross ? 0 : light ? 200 : 40;
+                pixel[2]            = cross ? 0 : light ? (eye == 0 ? 255 : 120) : 40;
+                pixel[3]            = 255;
+            }
+        }
+        std::fill(image.depth.begin(), image.depth.end(), depth);
+    }
+    return cpu_rendered_frame{std::move(eyes), pose_prediction_->get_fast_pose(), clock_->now()};
+}
+
+/* Compute a view matrix with rotation and position */
+Eigen::Matrix4f timewarp_cpu::create_camera_matrix(const pose::head_pose_type& pose, int eye) {
+    Eigen::Matrix4f camera_matrix   = Eigen::Matrix4f::Identity();
+    auto            ipd             = display_params::ipd / 2.0f;
+    camera_matrix.block<3, 1>(0, 3) = pose.position + pose.orientation * Eigen::Vector3f(eye == 0 ? -ipd : ipd, 0, 0);
+    camera_matrix.block<3, 3>(0, 0) = pose.orientation.toRotationMatrix();
+    return camera_matrix;
+}
+
+PLUGIN_MAIN(timewarp_cpu)
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cpu_reprojection.hpp"
+#include "illixr/data_format/cpu_frame.hpp"
+#include "illixr/data_format/pose_prediction.hpp"
+#include "illixr/phonebook.hpp"
+#include "illixr/relative_clock.hpp"
+#include "illixr/switchboard.hpp"
+#include "illixr/threadloop.hpp"
+
+#include <array>
+#include <memory>
+
+namespace ILLIXR {
+
+/**
+ * @brief Timewarp or openwarp on the CPU, without a GPU or a display.
+ *
+ * Reprojects the newest frame on "cpu_eyebuffer" (or, until one arrives, a built-in test pattern) to the latest
+ * predicted pose once per display period of the relative_clock (so also in virtual time), publishes the result on
+ * "cpu_warped_frame", and reports the per-frame cost when it stops. Meant for headless benchmarking and as a reference
+ * for the GPU warp plugins.
+ */
+class timewarp_cpu : public threadloop {
+public:
+    [[maybe_unused]] timewarp_cpu(const std::string& name, phonebook* pb);
+    void stop() override;
+
+protected:
+    skip_option _p_should_skip() override;
+    void        _p_one_iteration() override;
+
+private:
+    void                            warp(const data_format::cpu_rendered_frame& frame);
+    data_format::cpu_rendered_frame make_test_frame() const;
+    static Eigen::Matrix4f          create_camera_matrix(const data_format::pose::head_pose_type& pose, int eye);
+
+    const std::shared_ptr<switchboard>                  switchboard_;
+    const std::shared_ptr<data_format::pose_prediction> pose_prediction_;
+    const std::shared_ptr<relative_clock>               clock_;
+
+    switchboard::reader<data_format::cpu_rendered_frame>        eyebuffer_;
+    switchboard::writer<data_format::cpu_rendered_frame>        warped_frame_;
+    switchboard::writer<switchboard::event_wrapper<time_point>> vsync_estimate_;
+
+    const bool disable_warp_;
+    const bool use_openwarp_;
+    const int  eye_width_;
+    const int  eye_height_;
+
+    HMD::hmd_info_t                   hmd_info_{};
+    std::unique_ptr<cpu_reprojection> reprojection_;
+    std::array<Eigen::Matrix4f, 2>    projection_;
+    std::array<Eigen::Matrix4f, 2>    inverse_projection_;
+
+    // Used until the first frame arrives on cpu_eyebuffer
+    std::unique_ptr<data_format::cpu_rendered_frame> test_frame_;
+
+    time_point next_vsync_{};
+
+    // Frame cost over the whole run, and the most recent costs for the 99th percentile
+    static constexpr std::size_t     RECENT_COSTS   = 1024;
+    std::size_t                      frames_        = 0;
+    double                           total_cost_ms_ = 0.0;
+    double                           max_cost_ms_   = 0.0;
+    std::array<double, RECENT_COSTS> recent_costs_ms_{};
+};
+
+} // namespace ILLIXR
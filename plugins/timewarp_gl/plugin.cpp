@@ -9,6 +9,7 @@
 #endif
 // clang-format on
 
+#include "illixr/distortion_mesh.hpp"
 #include "illixr/error_util.hpp"
 #include "illixr/global_module_defs.hpp"
 #include "illixr/math_util.hpp"
@@ -19,9 +20,9 @@
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <memory>
-#include <thread>
 #include <vulkan/vulkan.h>
 
 using namespace ILLIXR;
@@ -58,6 +59,7 @@ timewarp_gl::timewarp_gl(const std::string& name, phonebook* pb)
 #ifndef ENABLE_MONADO
     , eyebuffer_{switchboard_->get_reader<rendered_frame>("eyebuffer")}
     , vsync_estimate_{switchboard_->get_writer<switchboard::event_wrapper<time_point>>("vsync_estimate")}
+    , pacer_{display_params::period, std::stod(switchboard_->get_env("ILLIXR_TIMEWARP_TARGET_MISS_RATE", "0.01"))}
     , offload_data_{switchboard_->get_writer<pose::texture_pose>("texture_pose")}
     , mtp_logger_{record_logger_}
     // TODO: Use #198 to configure this.
@@ -67,6 +69,7 @@ timewarp_gl::timewarp_gl(const std::string& name, phonebook* pb)
     // In production systems, this is certainly a good thing, but it makes the system harder to analyze.
     , disable_warp_{switchboard_->get_env_bool("ILLIXR_TIMEWARP_DISABLE", "False")}
     , enable_offload_{switchboard_->get_env_bool("ILLIXR_OFFLOAD_ENABLE", "False")}
+    , finish_before_swap_{switchboard_->get_env_bool("ILLIXR_TIMEWARP_GL_FINISH", "True")}
 #else
     , signal_quad_{switchboard_->get_writer<signal_to_quad>("signal_quad")}
 #endif
@@ -171,30 +174,166 @@ timewarp_gl::timewarp_gl(const std::string& name, phonebook* pb)
 #endif
 }
 
-GLubyte* timewarp_gl::read_texture_image() {
-    const unsigned mem_size = display_params::width_pixels * display_params::height_pixels * 3;
-    auto*          pixels   = new GLubyte[mem_size];
+void timewarp_gl::begin_gpu_timer() {
+    gpu_timer_slot& slot = gpu_timer_slots_[next_gpu_timer_slot_];
 
-    // Start timer
-    time_point start_get_tex_time = clock_->now();
+    // The ring is full: the oldest result has to be collected before its query can be reused
+    if (slot.pending) {
+        collect_gpu_timers(true);
+    }
+    if (slot.query == 0) {
+        glGenQueries(1, &slot.query);
+    }
+    slot.iteration       = iteration_no;
+    slot.wall_time_start = clock_->now();
+    glBeginQuery(GL_TIME_ELAPSED, slot.query);
+}
 
-    // Read the contents of the default framebuffer to the PBO
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBO_buffer_);
-    glReadPixels(0, 0, display_params::width_pixels, display_params::height_pixels, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+void timewarp_gl::end_gpu_timer() {
+    glEndQuery(GL_TIME_ELAPSED);
+    gpu_timer_slots_[next_gpu_timer_slot_].pending = true;
+    next_gpu_timer_slot_                           = (next_gpu_timer_slot_ + 1) % GPU_TIMER_SLOTS;
+}
 
+void timewarp_gl::collect_gpu_timers(bool wait) {
+    // Oldest first, so that the records stay in iteration order; without @p wait, stops at the first unfinished query
+    for (std::size_t i = 0; i < GPU_TIMER_SLOTS; ++i) {
+        gpu_timer_slot& slot = gpu_timer_slots_[(next_gpu_timer_slot_ + i) % GPU_TIMER_SLOTS];
+        if (!slot.pending) {
+            continue;
+        }
+        if (!wait) {
+            GLint available = 0;
+            glGetQueryObjectiv(slot.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                return;
+            }
+        }
+
+        // Blocks only when waiting on a query that is not done yet
+        GLuint64 elapsed_time = 0;
+        glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &elapsed_time);
+        slot.pending = false;
+
+        // The CPU no longer waits for the GPU, so the stop time is the start plus the GPU time
+        const std::chrono::nanoseconds gpu_time{elapsed_time};
+        timewarp_gpu_logger_.log(record{timewarp_gpu_record,
+                                        {
+                                            {slot.iteration},
+                                            {slot.wall_time_start},
+                                            {slot.wall_time_start + gpu_time},
+                                            {gpu_time},
+                                        }});
+        if (wait) {
+            return;
+        }
+    }
+}
+
+#ifndef ENABLE_MONADO
+std::size_t timewarp_gl::queue_readback() {
+    const time_point  start = clock_->now();
+    const std::size_t index = next_readback_slot_;
+    readback_slot&    slot  = readback_slots_[index];
+    next_readback_slot_     = (next_readback_slot_ + 1) % READBACK_SLOTS;
+
+    // The ring is full: the oldest copy has to be collected before its PBO can be reused
+    if (slot.fence != nullptr) {
+        publish_readback(slot, true);
+    }
+
+    // Copy the back buffer into the PBO; this only queues the copy, it does not wait for the GPU
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glReadPixels(0, 0, display_params::width_pixels, display_params::height_pixels, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
-    // Record the image collection time
-    offload_duration_ = clock_->now() - start_get_tex_time;
+    slot.queue_duration = clock_->now() - start;
+    return index;
+}
 
-#ifndef NDEBUG
-    double time = duration_to_double<std::milli>(offload_duration_);
+void timewarp_gl::publish_readbacks(std::size_t newest) {
+    // Oldest first, so that frames are published in order; stops at the first copy the GPU has not finished
+    for (std::size_t i = 0; i < READBACK_SLOTS; ++i) {
+        const std::size_t index = (next_readback_slot_ + i) % READBACK_SLOTS;
+        readback_slot&    slot  = readback_slots_[index];
+        if (slot.fence == nullptr) {
+            continue;
+        }
+        if (index == newest) {
+            return;
+        }
+        const GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        publish_readback(slot, false);
+    }
+}
+
+void timewarp_gl::publish_readback(readback_slot& slot, bool wait) {
+    const time_point start = clock_->now();
+    if (wait) {
+        constexpr GLuint64 timeout_ns = 1000000000;
+        glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    const std::size_t          size  = display_params::width_pixels * display_params::height_pixels * 3;
+    std::shared_ptr<GLubyte[]> image = acquire_readback_buffer();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+    if (pixels != nullptr) {
+        std::memcpy(image.get(), pixels, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (pixels == nullptr) {
+        spdlog::get(name_)->warn("Failed to map the readback buffer; frame not offloaded");
+        return;
+    }
+
+    // The image collection time: queueing the copy plus collecting it, without the frames in between
+    const duration offload_duration = slot.queue_duration + (clock_->now() - start);
+    #ifndef NDEBUG
+    double time = duration_to_double<std::milli>(offload_duration);
     spdlog::get(name_)->debug("Texture image collecting time: {} ms", time);
-#endif
+    #endif
 
-    return pixels;
+    offload_data_.put(offload_data_.allocate<pose::texture_pose>(pose::texture_pose{
+        offload_duration, std::move(image), slot.pose_time, slot.position, slot.latest_quaternion, slot.render_quaternion}));
 }
 
+std::shared_ptr<GLubyte[]> timewarp_gl::acquire_readback_buffer() {
+    std::unique_ptr<GLubyte[]> buffer;
+    {
+        const std::lock_guard<std::mutex> lock{readback_pool_->mutex};
+        if (!readback_pool_->free.empty()) {
+            buffer = std::move(readback_pool_->free.back());
+            readback_pool_->free.pop_back();
+        }
+    }
+    if (buffer == nullptr) {
+        buffer.reset(new GLubyte[display_params::width_pixels * display_params::height_pixels * 3]);
+    }
+
+    // The deleter runs once the last consumer has let go of the image, on that consumer's thread, so every access to it
+    // is done by then. It returns the buffer to the pool, or frees it if this plugin is gone.
+    return {buffer.release(), [pool = std::weak_ptr<readback_pool>{readback_pool_}](GLubyte* released) {
+                if (const std::shared_ptr<readback_pool> alive = pool.lock()) {
+                    const std::lock_guard<std::mutex> lock{alive->mutex};
+                    alive->free.emplace_back(released);
+                } else {
+                    delete[] released;
+                }
+            }};
+}
+#endif
+
 GLuint timewarp_gl::convert_vk_format_to_GL(int64_t vk_format) {
     switch (vk_format) {
     case VK_FORMAT_R8G8B8A8_UNORM:
@@ -264,76 +403,16 @@ void timewarp_gl::import_vulkan_image(const vk_image_handle& vk_handle, swapchai
 }
 
 void timewarp_gl::build_timewarp(HMD::hmd_info_t& hmd_info) {
-    // Calculate the number of vertices+indices in the distortion mesh.
-    num_distortion_vertices_ = (hmd_info.eye_tiles_high + 1) * (hmd_info.eye_tiles_wide + 1);
-    num_distortion_indices_  = hmd_info.eye_tiles_high * hmd_info.eye_tiles_wide * 6;
-
-    // Allocate memory for the elements/indices array.
-    distortion_indices_.resize(num_distortion_indices_);
-
-    // This is just a simple grid/plane index array, nothing fancy.
-    // Same for both eye distortions, too!
-    for (int y = 0; y < hmd_info.eye_tiles_high; y++) {
-        for (int x = 0; x < hmd_info.eye_tiles_wide; x++) {
-            const int offset = (y * hmd_info.eye_tiles_wide + x) * 6;
-
-            // How are the indices figured out?
-            distortion_indices_[offset + 0] = (GLuint) ((y + 0) * (hmd_info.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 1] = (GLuint) ((y + 1) * (hmd_info.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 2] = (GLuint) ((y + 0) * (hmd_info.eye_tiles_wide + 1) + (x + 1));
-
-            distortion_indices_[offset + 3] = (GLuint) ((y + 0) * (hmd_info.eye_tiles_wide + 1) + (x + 1));
-            distortion_indices_[offset + 4] = (GLuint) ((y + 1) * (hmd_info.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 5] = (GLuint) ((y + 1) * (hmd_info.eye_tiles_wide + 1) + (x + 1));
-        }
-    }
-
-    // There are `num_distortion_vertices_` distortion coordinates for each color channel (3) of each eye (2).
-    // These are NOT the coordinates of the distorted vertices. They are *coefficients* that will be used to
-    // offset the UV coordinates of the distortion mesh.
-    std::array<std::array<std::vector<HMD::mesh_coord2d_t>, HMD::NUM_COLOR_CHANNELS>, HMD::NUM_EYES> distort_coords;
-    for (auto& eye_coords : distort_coords) {
-        for (auto& channel_coords : eye_coords) {
-            channel_coords.resize(num_distortion_vertices_);
-        }
-    }
-    HMD::build_distortion_meshes(distort_coords, hmd_info);
-
-    // Allocate memory for position and UV CPU buffers.
-    const std::size_t num_elems_pos_uv = HMD::NUM_EYES * num_distortion_vertices_;
-    distortion_positions_.resize(num_elems_pos_uv);
-    distortion_uv0_.resize(num_elems_pos_uv);
-    distortion_uv1_.resize(num_elems_pos_uv);
-    distortion_uv2_.resize(num_elems_pos_uv);
+    distortion_mesh mesh = distortion_mesh::load(
+        hmd_info, switchboard_->get_env("ILLIXR_DISTORTION_CACHE", distortion_mesh::default_cache_dir()));
 
-    for (int eye = 0; eye < HMD::NUM_EYES; eye++) {
-        for (int y = 0; y <= hmd_info.eye_tiles_high; y++) {
-            for (int x = 0; x <= hmd_info.eye_tiles_wide; x++) {
-                const int index = y * (hmd_info.eye_tiles_wide + 1) + x;
-
-                // Set the physical distortion mesh coordinates. These are rectangular/grid-like, not distorted.
-                // The distortion is handled by the UVs, not the actual mesh coordinates!
-                distortion_positions_[eye * num_distortion_vertices_ + index].x =
-                    (-1.0f + 2.0f * (static_cast<float>(x) / static_cast<float>(hmd_info.eye_tiles_wide)));
-                distortion_positions_[eye * num_distortion_vertices_ + index].y =
-                    (-1.0f +
-                     2.0f *
-                         ((static_cast<float>(hmd_info.eye_tiles_high) - static_cast<float>(y)) /
-                          static_cast<float>(hmd_info.eye_tiles_high)) *
-                         (static_cast<float>(hmd_info.eye_tiles_high * hmd_info.tile_pixels_high) /
-                          static_cast<float>(hmd_info.display_pixels_high)));
-                distortion_positions_[eye * num_distortion_vertices_ + index].z = 0.0f;
-
-                // Use the previously-calculated distort_coords to set the UVs on the distortion mesh
-                distortion_uv0_[eye * num_distortion_vertices_ + index].u = distort_coords[eye][0][index].x;
-                distortion_uv0_[eye * num_distortion_vertices_ + index].v = distort_coords[eye][0][index].y;
-                distortion_uv1_[eye * num_distortion_vertices_ + index].u = distort_coords[eye][1][index].x;
-                distortion_uv1_[eye * num_distortion_vertices_ + index].v = distort_coords[eye][1][index].y;
-                distortion_uv2_[eye * num_distortion_vertices_ + index].u = distort_coords[eye][2][index].x;
-                distortion_uv2_[eye * num_distortion_vertices_ + index].v = distort_coords[eye][2][index].y;
-            }
-        }
-    }
+    num_distortion_vertices_ = mesh.vertices_per_eye;
+    num_distortion_indices_  = static_cast<GLuint>(mesh.indices.size());
+    distortion_indices_.assign(mesh.indices.begin(), mesh.indices.end());
+    distortion_positions_ = std::move(mesh.positions);
+    distortion_uv0_       = std::move(mesh.uv[0]);
+    distortion_uv1_       = std::move(mesh.uv[1]);
+    distortion_uv2_       = std::move(mesh.uv[2]);
 
     // Construct perspective projection matrix
     math_util::projection_fov(&basic_projection_, display_params::fov_x / 2.0f, display_params::fov_x / 2.0f,
@@ -367,20 +446,6 @@ void timewarp_gl::calculate_time_warp_transform(Eigen::Matrix4f& transform, cons
     transform = tex_coord_projection * delta_view_matrix;
 }
 
-#ifndef ENABLE_MONADO
-// Get the estimated time of the next swap/next Vsync.
-// This is an estimate, used to wait until *just* before vsync.
-[[nodiscard]] time_point timewarp_gl::get_next_swap_time_estimate() const {
-    return time_last_swap_ + display_params::period;
-}
-
-// Get the estimated amount of time to put the CPU thread to sleep,
-// given a specified percentage of the total Vsync period to delay.
-[[maybe_unused]] [[nodiscard]] duration timewarp_gl::estimate_time_to_sleep(const double frame_percentage) const {
-    return std::chrono::duration_cast<duration>((get_next_swap_time_estimate() - clock_->now()) * frame_percentage);
-}
-#endif
-
 void timewarp_gl::_setup() {
     // Generate reference HMD and physical body dimensions
     HMD::get_default_hmd_info(display_params::width_pixels, display_params::height_pixels, display_params::width_meters,
@@ -506,11 +571,14 @@ void timewarp_gl::_setup() {
                  distortion_indices_data, GL_STATIC_DRAW);
 
     if (enable_offload_) {
-        // Config PBO for texture image collection
-        glGenBuffers(1, &PBO_buffer_);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, PBO_buffer_);
-        glBufferData(GL_PIXEL_PACK_BUFFER, display_params::width_pixels * display_params::height_pixels * 3, nullptr,
-                     GL_STREAM_DRAW);
+        // Config PBOs for texture image collection
+        for (auto& slot : readback_slots_) {
+            glGenBuffers(1, &slot.pbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, display_params::width_pixels * display_params::height_pixels * 3, nullptr,
+                         GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
 #if defined(_WIN32) || defined(_WIN64)
     [[maybe_unused]] const bool gl_result_1 = static_cast<bool>(wglMakeCurrent(nullptr, nullptr));
@@ -627,12 +695,7 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
 
     glBindVertexArray(tw_vao);
 
-    auto     gpu_start_wall_time = clock_->now();
-    GLuint   query               = 0;
-    GLuint64 elapsed_time        = 0;
-
-    glGenQueries(1, &query);
-    glBeginQuery(GL_TIME_ELAPSED, query);
+    begin_gpu_timer();
 
     // Loop over each eye
     for (int eye = 0; eye < HMD::NUM_EYES; eye++) {
@@ -685,8 +748,17 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
         glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(num_distortion_indices_), GL_UNSIGNED_INT, (void*) nullptr);
     }
 
+    end_gpu_timer();
+
+    // Monado composites the eye outputs from its own context, so they have to be complete before they are signalled. In
+    // native mode the swap orders the GPU work by itself, and waiting here only keeps the warp thread awake.
+#ifdef ENABLE_MONADO
     glFinish();
-    glEndQuery(GL_TIME_ELAPSED);
+#else
+    if (finish_before_swap_) {
+        glFinish();
+    }
+#endif
 
 #ifdef ENABLE_MONADO
     // signal quad layer in Monado
@@ -708,9 +780,18 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
                       display_params::width_pixels * 0.5, 0, display_params::width_pixels, display_params::height_pixels,
                       GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
+    // For now, it only makes sense to enable offloading in native mode
+    // because running timewarp with Monado will not produce a single texture.
+    // The back buffer is undefined after the swap, so its copy is queued now and collected once the GPU has made it.
+    std::size_t readback_index = 0;
+    if (enable_offload_) {
+        readback_index = queue_readback();
+    }
+
     // Call swap buffers; when vsync is enabled, this will return to the
     // CPU thread once the buffers have been successfully swapped.
     [[maybe_unused]] time_point time_before_swap = clock_->now();
+    pacer_.record_work_done(time_before_swap);
     #if defined(_WIN32) || defined(_WIN64)
     SwapBuffers(hdc_);
     #else
@@ -721,9 +802,11 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
     time_last_swap_                             = clock_->now();
     [[maybe_unused]] time_point time_after_swap = time_last_swap_;
 
-    // Now that we have the most recent swap time, we can publish the new estimate.
+    // Now that we have the most recent swap time, we can publish the new estimate: the vsync after the one just shown
+    pacer_.record_swap(time_last_swap_);
+    const time_point time_next_swap = pacer_.next_vsync(time_last_swap_ + pacer_.period() / 2);
     vsync_estimate_.put(vsync_estimate_.allocate<switchboard::event_wrapper<time_point>>(
-        switchboard::event_wrapper<time_point>(get_next_swap_time_estimate())));
+        switchboard::event_wrapper<time_point>(time_next_swap)));
 
     std::chrono::nanoseconds imu_to_display     = time_last_swap_ - latest_pose.pose.sensor_time;
     std::chrono::nanoseconds predict_to_display = time_last_swap_ - latest_pose.predict_computed_time;
@@ -745,7 +828,6 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
         const double     latency_mtd       = duration_to_double<std::milli>(imu_to_display);
         const double     latency_ptd       = duration_to_double<std::milli>(predict_to_display);
         const double     latency_rtd       = duration_to_double<std::milli>(render_to_display);
-        const time_point time_next_swap    = get_next_swap_time_estimate();
         const double     timewarp_estimate = duration_to_double<std::milli>(time_next_swap - time_last_swap_);
 
         spdlog::get(name_)->debug("Swap time: {} ms", time_swap);
@@ -753,42 +835,26 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
         spdlog::get(name_)->debug("Prediction-to-display latency: {} ms", latency_ptd);
         spdlog::get(name_)->debug("Render-to-display latency: {} ms", latency_rtd);
         spdlog::get(name_)->debug("Next swap in: {} ms in the future", timewarp_estimate);
+        spdlog::get(name_)->debug("Vsync period: {} ms, jitter: {} ms, wakeup lead: {} ms, {} of {} frames late",
+                                  duration_to_double<std::milli>(pacer_.period()),
+                                  duration_to_double<std::milli>(pacer_.jitter()),
+                                  duration_to_double<std::milli>(pacer_.lead()), pacer_.missed_frames(), pacer_.frames());
     }
     #endif
 
-    // For now, it only makes sense to enable offloading in native mode
-    // because running timewarp with Monado will not produce a single texture.
     if (enable_offload_) {
-        // Read texture image from texture buffer
-        GLubyte* image = read_texture_image();
-
-        // Publish image and pose
-        offload_data_.put(offload_data_.allocate<pose::texture_pose>(
-            pose::texture_pose{offload_duration_, image, time_last_swap_, latest_pose.pose.position,
-                               latest_pose.pose.orientation, most_recent_frame->render_pose.pose.orientation}));
+        // Record the pose for this frame's image, then publish the earlier frames whose copies are done
+        readback_slot& slot    = readback_slots_[readback_index];
+        slot.pose_time         = time_last_swap_;
+        slot.position          = latest_pose.pose.position;
+        slot.latest_quaternion = latest_pose.pose.orientation;
+        slot.render_quaternion = most_recent_frame->render_pose.pose.orientation;
+        publish_readbacks(readback_index);
     }
 #endif
 
-    // retrieving the recorded elapsed time
-    // wait until the query result is available
-    int done = 0;
-    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &done);
-
-    while (!done) {
-        std::this_thread::yield();
-        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &done);
-    }
-
-    // get the query result
-    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_time);
-
-    timewarp_gpu_logger_.log(record{timewarp_gpu_record,
-                                    {
-                                        {iteration_no},
-                                        {gpu_start_wall_time},
-                                        {clock_->now()},
-                                        {std::chrono::nanoseconds(elapsed_time)},
-                                    }});
+    // Log the GPU times of this and earlier warps that are already known, without waiting for the rest
+    collect_gpu_timers(false);
 
 #ifdef ENABLE_MONADO
     // Manually increment the iteration number if timewarp is running as a plugin
@@ -809,18 +875,22 @@ void timewarp_gl::warp(const switchboard::ptr<const rendered_frame>& most_recent
 
 #ifndef ENABLE_MONADO
 threadloop::skip_option timewarp_gl::_p_should_skip() {
-    using namespace std::chrono_literals;
-    // Sleep for approximately 90% of the time until the next vsync.
-    // Scheduling granularity can't be assumed to be super accurate here,
-    // so don't push your luck (i.e. don't wait too long....) Tradeoff with
-    // MTP here. More you wait, closer to the display sync you sample the pose.
-    std::this_thread::sleep_for(estimate_time_to_sleep(DELAY_FRACTION));
+    // Sleep until the pacer's deadline for the next vsync it expects the warp to make: as late as the warp's recent
+    // wakeup latency and cost allow at the target miss rate. Tradeoff with MTP here. More you wait, closer to the
+    // display sync you sample the pose.
+    if (!waited_for_vsync_) {
+        waited_for_vsync_    = true;
+        const time_point now = clock_->now();
+        return skip_for(pacer_.plan_wakeup(now) - now);
+    }
+    waited_for_vsync_ = false;
+
     if (image_handles_ready_.load() && eyebuffer_.get_ro_nullable() != nullptr) {
         return skip_option::run;
     } else {
         // Null means system is nothing has been pushed yet
-        // because not all components are initialized yet
-        return skip_option::skip_and_yield;
+        // because not all components are initialized yet; the next call waits for the following vsync
+        return skip_option::skip_and_spin;
     }
 }
 
@@ -8,12 +8,17 @@
 #include "illixr/data_format/pose_prediction.hpp"
 #include "illixr/data_format/poses/pose_base.hpp"
 #include "illixr/extended_window.hpp"
+#include "illixr/frame_pacer.hpp"
 #include "illixr/hmd.hpp"
 #include "illixr/phonebook.hpp"
 #include "illixr/relative_clock.hpp"
 #include "illixr/switchboard.hpp"
 #include "illixr/threadloop.hpp"
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace ILLIXR {
 
 #ifdef ENABLE_MONADO
@@ -39,18 +44,48 @@ public:
 #endif
 
 private:
-    GLubyte*      read_texture_image();
+    // Asynchronous readback of the displayed frame, for offloading
+    struct readback_slot {
+        GLuint             pbo   = 0;
+        GLsync             fence = nullptr; ///< Signalled once the copy into the PBO is done; null when the slot is free
+        duration           queue_duration{};
+        time_point         pose_time{};
+        Eigen::Vector3f    position;
+        Eigen::Quaternionf latest_quaternion;
+        Eigen::Quaternionf render_quaternion;
+    };
+
+    // Images of collected readbacks that no consumer holds any more, ready to be reused
+    struct readback_pool {
+        std::mutex                              mutex;
+        std::vector<std::unique_ptr<GLubyte[]>> free;
+    };
+
+    // GPU time of one warp, collected a frame or more later so that the warp thread does not wait for the GPU
+    struct gpu_timer_slot {
+        GLuint      query   = 0;
+        bool        pending = false; ///< Ended, and its result not yet logged
+        std::size_t iteration{};
+        time_point  wall_time_start{};
+    };
+
+    void begin_gpu_timer();
+    void end_gpu_timer();
+    void collect_gpu_timers(bool wait);
+
+#ifndef ENABLE_MONADO
+    std::size_t                queue_readback();
+    void                       publish_readbacks(std::size_t newest);
+    void                       publish_readback(readback_slot& slot, bool wait);
+    std::shared_ptr<GLubyte[]> acquire_readback_buffer();
+#endif
+
     static GLuint convert_vk_format_to_GL(int64_t vk_format);
     void          import_vulkan_image(const data_format::vk_image_handle& vk_handle, data_format::swapchain_usage usage);
     void          build_timewarp(HMD::hmd_info_t& hmd_info);
     static void   calculate_time_warp_transform(Eigen::Matrix4f& transform, const Eigen::Matrix4f& render_projection_matrix,
                                                 const Eigen::Matrix4f& render_view_matrix,
                                                 const Eigen::Matrix4f& new_view_matrix);
-#ifndef ENABLE_MONADO
-    [[nodiscard]] time_point                get_next_swap_time_estimate() const;
-    [[maybe_unused]] [[nodiscard]] duration estimate_time_to_sleep(double frame_percentage) const;
-#endif
-
     const std::shared_ptr<switchboard>                  switchboard_;
     const std::shared_ptr<data_format::pose_prediction> pose_prediction_;
     const std::shared_ptr<const relative_clock>         clock_;
@@ -89,8 +124,8 @@ private:
     // When using Monado, timewarp is a plugin and not a threadloop, but we still keep track of the iteration number
     std::size_t iteration_no = 0;
 #else
-    // Note: 0.9 works fine without hologram, but we need a larger safety net with hologram enabled
-    static constexpr double DELAY_FRACTION = 0.9;
+    // Whether _p_should_skip() has already slept towards the coming vsync
+    bool waited_for_vsync_ = false;
 
     // Switchboard plug for application eye buffer.
     switchboard::reader<data_format::rendered_frame> eyebuffer_;
@@ -98,6 +133,9 @@ private:
     // Switchboard plug for publishing vsync estimates
     switchboard::writer<switchboard::event_wrapper<time_point>> vsync_estimate_;
 
+    // Estimates the vsyncs from the swap times and decides when to wake up for the next one
+    frame_pacer pacer_;
+
     // Switchboard plug for publishing offloaded data
     switchboard::writer<data_format::pose::texture_pose> offload_data_;
     // Timewarp only has vsync estimates with native-gl
@@ -158,14 +196,21 @@ private:
     bool disable_warp_;
 
     bool             enable_offload_;
+    bool             finish_before_swap_ = true;
     record_coalescer timewarp_gpu_logger_;
     // Switchboard plug for sending hologram calls
     switchboard::writer<data_format::hologram_input> hologram_;
 
-    // PBO buffer for reading texture image
-    GLuint PBO_buffer_{};
+    // Ring of PBOs the displayed frame is copied into, each collected a frame or more later, once the GPU is done with it
+    static constexpr std::size_t              READBACK_SLOTS = 3;
+    std::array<readback_slot, READBACK_SLOTS> readback_slots_{};
+    std::size_t                               next_readback_slot_ = 0;
+    std::shared_ptr<readback_pool>            readback_pool_ = std::make_shared<readback_pool>();
 
-    duration offload_duration_{};
+    // Ring of GL_TIME_ELAPSED queries; a slot is only waited on if it comes round again before its result is in
+    static constexpr std::size_t                GPU_TIMER_SLOTS = 4;
+    std::array<gpu_timer_slot, GPU_TIMER_SLOTS> gpu_timer_slots_{};
+    std::size_t                                 next_gpu_timer_slot_ = 0;
 
 #ifndef NDEBUG
     size_t log_count_  = 0;
@@ -1,5 +1,6 @@
 #include "timewarp_vk.hpp"
 
+#include "illixr/distortion_mesh.hpp"
 #include "illixr/global_module_defs.hpp"
 #include "illixr/math_util.hpp"
 #include "illixr/vk/vulkan_utils.hpp"
@@ -697,74 +698,25 @@ VkPipeline timewarp_vk::create_pipeline(VkRenderPass render_pass, [[maybe_unused
 }
 
 void timewarp_vk::build_timewarp(HMD::hmd_info_t& hmd_info) {
-    // Calculate the number of vertices+indices in the distortion mesh.
-    num_distortion_vertices_ = (hmd_info.eye_tiles_high + 1) * (hmd_info.eye_tiles_wide + 1);
-    num_distortion_indices_  = hmd_info.eye_tiles_high * hmd_info.eye_tiles_wide * 6;
-
-    // Allocate memory for the elements/indices array.
-    distortion_indices_.resize(num_distortion_indices_);
-
-    // This is just a simple grid/plane index array, nothing fancy.
-    // Same for both eye distortions, too!
-    for (int y = 0; y < hmd_info.eye_tiles_high; y++) {
-        for (int x = 0; x < hmd_info.eye_tiles_wide; x++) {
-            const int offset = (y * hmd_info.eye_tiles_wide + x) * 6;
-
-            distortion_indices_[offset + 0] = ((y + 0) * (hmd_info.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 1] = ((y + 1) * (hmd_info.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 2] = ((y + 0) * (hmd_info.eye_tiles_wide + 1) + (x + 1));
-
-            distortion_indices_[offset + 3] = ((y + 0) * (hmd_info.eye_tiles_wide + 1) + (x + 1));
-            distortion_indices_[offset + 4] = ((y + 1) * (hmd_info.eye_tiles_wide + 1) + (x + 0));
-            distortion_indices_[offset + 5] = ((y + 1) * (hmd_info.eye_tiles_wide + 1) + (x + 1));
+    distortion_mesh mesh = distortion_mesh::load(
+        hmd_info, switchboard_->get_env("ILLIXR_DISTORTION_CACHE", distortion_mesh::default_cache_dir()));
+
+    num_distortion_vertices_ = mesh.vertices_per_eye;
+    num_distortion_indices_  = static_cast<uint32_t>(mesh.indices.size());
+    distortion_indices_      = std::move(mesh.indices);
+    distortion_positions_    = std::move(mesh.positions);
+    distortion_uv0_          = std::move(mesh.uv[0]);
+    distortion_uv1_          = std::move(mesh.uv[1]);
+    distortion_uv2_          = std::move(mesh.uv[2]);
+
+    // External input textures are flipped vertically
+    if (input_texture_external_) {
+        for (auto& position : distortion_positions_) {
+            position.y = -position.y;
         }
     }
 
-    // There are `num_distortion_vertices_` distortion coordinates for each color channel (3) of each eye (2).
-    // These are NOT the coordinates of the distorted vertices. They are *coefficients* that will be used to
-    // offset the UV coordinates of the distortion mesh.
-    std::array<std::array<std::vector<HMD::mesh_coord2d_t>, HMD::NUM_COLOR_CHANNELS>, HMD::NUM_EYES> distort_coords;
-    for (auto& eye_coords : distort_coords) {
-        for (auto& channel_coords : eye_coords) {
-            channel_coords.resize(num_distortion_vertices_);
-        }
-    }
-    HMD::build_distortion_meshes(distort_coords, hmd_info);
-
-    // Allocate memory for position and UV CPU buffers.
-    const std::size_t num_elems_pos_uv = HMD::NUM_EYES * num_distortion_vertices_;
-    distortion_positions_.resize(num_elems_pos_uv);
-    distortion_uv0_.resize(num_elems_pos_uv);
-    distortion_uv1_.resize(num_elems_pos_uv);
-    distortion_uv2_.resize(num_elems_pos_uv);
-
     for (int eye = 0; eye < HMD::NUM_EYES; eye++) {
-        for (int y = 0; y <= hmd_info.eye_tiles_high; y++) {
-            for (int x = 0; x <= hmd_info.eye_tiles_wide; x++) {
-                const int index = y * (hmd_info.eye_tiles_wide + 1) + x;
-
-                // Set the physical distortion mesh coordinates. These are rectangular/grid-like, not distorted.
-                // The distortion is handled by the UVs, not the actual mesh coordinates!
-                distortion_positions_[eye * num_distortion_vertices_ + index].x =
-                    (-1.0f + 2 * (static_cast<float>(x) / static_cast<float>(hmd_info.eye_tiles_wide)));
-
-                distortion_positions_[eye * num_distortion_vertices_ + index].y = (input_texture_external_ ? -1.0f : 1.0f) *
-                    (-1.0f +
-                     2.0f * (static_cast<float>(hmd_info.eye_tiles_high - y) / static_cast<float>(hmd_info.eye_tiles_high)) *
-                         (static_cast<float>(hmd_info.eye_tiles_high * hmd_info.tile_pixels_high) /
-                          static_cast<float>(hmd_info.display_pixels_high)));
-                distortion_positions_[eye * num_distortion_vertices_ + index].z = 0.0f;
-
-                // Use the previously-calculated distort_coords to set the UVs on the distortion mesh
-                distortion_uv0_[eye * num_distortion_vertices_ + index].u = distort_coords[eye][0][index].x;
-                distortion_uv0_[eye * num_distortion_vertices_ + index].v = distort_coords[eye][0][index].y;
-                distortion_uv1_[eye * num_distortion_vertices_ + index].u = distort_coords[eye][1][index].x;
-                distortion_uv1_[eye * num_distortion_vertices_ + index].v = distort_coords[eye][1][index].y;
-                distortion_uv2_[eye * num_distortion_vertices_ + index].u = distort_coords[eye][2][index].x;
-                distortion_uv2_[eye * num_distortion_vertices_ + index].v = distort_coords[eye][2][index].y;
-            }
-        }
-
         // Construct perspective projection matrix according to Unreal -- different FOVs not supported here.
         math_util::unreal_projection(&basic_projection_[eye], index_params::fov_left[eye], index_params::fov_right[eye],
                                      index_params::fov_up[eye], index_params::fov_down[eye]);
@@ -136,10 +136,10 @@ void udp_network_backend::read_loop(network::UDPSocket* socket) {
             continue;
         }
 
-        std::string       topic_name(packet.data() + 8, topic_name_length);
-        std::vector<char> message(packet.begin() + 8 + topic_name_length, packet.begin() + total_length);
+        std::string topic_name(packet.data() + 8, topic_name_length);
+        std::string message(packet.data() + 8 + topic_name_length, total_length - 8 - topic_name_length);
 
-        topic_receive(topic_name, message);
+        topic_receive(topic_name, std::move(message));
     }
 }
 
@@ -151,8 +151,7 @@ void udp_network_backend::topic_create(std::string topic_name, network::topic_co
     // the TCP backend's illixr_control handshake.  Since UDP is unreliable we
     // send it a few times to reduce the chance of loss before data arrives.
     if (peer_socket_ != nullptr && peer_socket_->has_peer()) {
-        std::string serialization =
-            (config.serialization_method == network::topic_config::SerializationMethod::BOOST) ? "BOOST" : "PROTOBUF";
+        std::string serialization = network::serialization_method_name(config.serialization_method);
         std::string ctrl_message = "create_topic" + topic_name + delimiter_ + serialization;
 
         for (int i = 0; i < 3; ++i)
@@ -167,7 +166,7 @@ bool udp_network_backend::is_topic_networked(std::string topic_name) {
     return std::find(networked_topics_.begin(), networked_topics_.end(), topic_name) != networked_topics_.end();
 }
 
-void udp_network_backend::topic_send(std::string topic_name, std::string&& message) {
+void udp_network_backend::topic_send(std::string topic_name, network::message&& message) {
     if (!is_topic_networked(topic_name)) {
         spdlog::get("illixr")->warn("[udp_network_backend] topic_send: {} not networked", topic_name);
         return;
@@ -176,21 +175,26 @@ void udp_network_backend::topic_send(std::string topic_name, std::string&& messa
     auto     topic_name_length = static_cast<uint32_t>(topic_name.size());
     uint32_t total_length      = 8u + topic_name_length + static_cast<uint32_t>(message.size());
 
-    std::string packet;
-    packet.reserve(total_length);
-    packet.append(reinterpret_cast<const char*>(&total_length), 4);
-    packet.append(reinterpret_cast<const char*>(&topic_name_length), 4);
-    packet.append(topic_name);
-    packet.append(message);
+    std::string header;
+    header.reserve(8u + topic_name_length);
+    header.append(reinterpret_cast<const char*>(&total_length), 4);
+    header.append(reinterpret_cast<const char*>(&topic_name_length), 4);
+    header.append(topic_name);
 
-    if (!peer_socket_->write_data(packet))
+    // The header and the message segments go out as one datagram via a gathered send
+    network::message packet{std::move(header)};
+    for (const auto& seg : message.segments()) {
+        packet.append(seg.owner, seg.data, seg.size);
+    }
+
+    if (!peer_socket_->write_segments(packet.segments()))
         spdlog::get("illixr")->warn("[udp_network_backend] write_data failed for topic={}", topic_name);
 }
 
 // Helper function to queue a received message into the corresponding topic
-void udp_network_backend::topic_receive(const std::string& topic_name, std::vector<char>& message) {
+void udp_network_backend::topic_receive(const std::string& topic_name, std::string&& message) {
     if (topic_name == "illixr_control") {
-        std::string message_str(message.begin(), message.end());
+        const std::string& message_str = message;
         if (message_str.find("create_topic") == 0) {
             size_t d_pos = message_str.find(delimiter_);
             assert(d_pos != std::string::npos);
@@ -198,8 +202,7 @@ void udp_network_backend::topic_receive(const std::string& topic_name, std::vect
             std::string serialization = message_str.substr(d_pos + 1);
             networked_topics_.push_back(l_topic_name);
             network::topic_config cfg;
-            cfg.serialization_method = (serialization == "BOOST") ? network::topic_config::SerializationMethod::BOOST
-                                                                  : network::topic_config::SerializationMethod::PROTOBUF;
+            cfg.serialization_method = network::serialization_method_from_name(serialization);
             cfg.transport_method     = network::topic_config::TransportMethod::UDP;
             networked_topics_configs_[l_topic_name] = cfg;
             spdlog::get("illixr")->info("[udp_network_backend] Received create_topic for {}", l_topic_name);
@@ -209,7 +212,7 @@ void udp_network_backend::topic_receive(const std::string& topic_name, std::vect
     if (!switchboard_->topic_exists(topic_name)) {
         return;
     }
-    switchboard_->get_topic(topic_name).deserialize_and_put(message, networked_topics_configs_[topic_name]);
+    switchboard_->get_topic(topic_name).deserialize_and_put(std::move(message), networked_topics_configs_[topic_name]);
 }
 
 void udp_network_backend::stop() {
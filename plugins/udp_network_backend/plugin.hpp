@@ -19,8 +19,8 @@ public:
     void read_loop(network::UDPSocket* socket);
     void topic_create(std::string topic_name, network::topic_config& config) override;
     bool is_topic_networked(std::string topic_name) override;
-    void topic_send(std::string topic_name, std::string&& message) override;
-    void topic_receive(const std::string& topic_name, std::vector<char>& message);
+    void topic_send(std::string topic_name, network::message&& message) override;
+    void topic_receive(const std::string& topic_name, std::string&& message);
     void stop() override;
 
     network::topic_config::TransportMethod transport_method() const override {
@@ -82,7 +82,8 @@ threadloop::skip_option zed_imu_thread::_p_should_skip() {
         std::this_thread::sleep_for(std::chrono::milliseconds{2});
         return skip_option::run;
     } else {
-        return skip_option::skip_and_yield;
+        // No new sample yet; the IMU runs at 400 Hz
+        return skip_for(std::chrono::milliseconds{1});
     }
 }
 
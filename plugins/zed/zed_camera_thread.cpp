@@ -39,7 +39,8 @@ threadloop::skip_option zed_camera_thread::_p_should_skip() {
     if (zed_cam_->grab(runtime_parameters_) == sl::ERROR_CODE::SUCCESS) {
         return skip_option::run;
     } else {
-        return skip_option::skip_and_spin;
+        // grab() waits for the next frame itself, so a failure is not worth retrying immediately
+        return skip_for(std::chrono::milliseconds{1});
     }
 }
 
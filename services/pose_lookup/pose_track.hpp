@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <eigen3/Eigen/Dense>
+#include <eigen3/Eigen/Geometry>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ILLIXR {
+
+/// A pose of the track at a dataset time, in nanoseconds
+struct pose_sample {
+    std::uint64_t      time;
+    Eigen::Vector3f    position;
+    Eigen::Quaternionf orientation;
+};
+
+/**
+ * @brief A time-sorted, contiguous array of poses, interpolated at arbitrary times.
+ *
+ * Positions are interpolated linearly and orientations by SLERP; times outside the track are clamped to its ends. The
+ * search for the samples around a time starts from where the previous one ended, and walks from there, since callers
+ * ask for times that mostly move forward by less than a sample period. A far jump falls back to a binary search. The
+ * starting point is shared between threads through a relaxed atomic: it is only a hint, so a stale one costs a few
+ * steps but never gives a wrong answer, and concurrent lookups take no lock.
+ */
+class pose_track {
+public:
+    pose_track() = default;
+
+    /// Sorts @p samples by time, keeping the first of any with the same time
+    explicit pose_track(std::vector<pose_sample> samples)
+        : samples_{std::move(samples)} {
+        std::stable_sort(samples_.begin(), samples_.end(), [](const pose_sample& a, const pose_sample& b) {
+            return a.time < b.time;
+        });
+        samples_.erase(std::unique(samples_.begin(), samples_.end(),
+                                   [](const pose_sample& a, const pose_sample& b) {
+                                       return a.time == b.time;
+                                   }),
+                       samples_.end());
+    }
+
+    pose_track(const pose_track& other)
+        : samples_{other.samples_} { }
+
+    pose_track& operator=(const pose_track& other) {
+        samples_ = other.samples_;
+        cursor_.store(0, std::memory_order_relaxed);
+        return *this;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return samples_.empty();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return samples_.size();
+    }
+
+    [[nodiscard]] const pose_sample& front() const {
+        return samples_.front();
+    }
+
+    [[nodiscard]] const pose_sample& back() const {
+        return samples_.back();
+    }
+
+    /**
+     * @brief The pose at @p time, interpolated between the samples around it, or the first or last sample if @p time is
+     * outside the track; its time is @p time, clamped likewise. The track must not be empty.
+     */
+    [[nodiscard]] pose_sample at(std::uint64_t time) const {
+        if (time <= samples_.front().time) {
+            return samples_.front();
+        }
+        if (time >= samples_.back().time) {
+            return samples_.back();
+        }
+
+        const std::size_t  i      = bracket(time);
+        const pose_sample& before = samples_[i];
+        const pose_sample& after  = samples_[i + 1];
+        const double       span   = static_cast<double>(after.time - before.time);
+        const auto         t      = static_cast<float>(static_cast<double>(time - before.time) / span);
+        return {time, before.position + t * (after.position - before.position), before.orientation.slerp(t, after.orientation)};
+    }
+
+    /// Steps the search walks from the previous position before it switches to a binary search
+    static constexpr std::size_t max_walk = 8;
+
+private:
+    /// The i with samples_[i].time <= time < samples_[i + 1].time; time must be inside the track
+    std::size_t bracket(std::uint64_t time) const {
+        std::size_t i = std::min(cursor_.load(std::memory_order_relaxed), samples_.size() - 2);
+        for (std::size_t steps = 0;; ++steps) {
+            if (steps == max_walk) {
+                const auto after = std::upper_bound(samples_.cbegin(), samples_.cend(), time,
+                                                    [](std::uint64_t lookup, const pose_sample& sample) {
+                                                        return lookup < sample.time;
+                                                    });
+                i                = static_cast<std::size_t>(after - samples_.cbegin()) - 1;
+                break;
+            }
+            if (samples_[i].time > time) {
+                --i;
+            } else if (samples_[i + 1].time <= time) {
+                ++i;
+            } else {
+                break;
+            }
+        }
+        cursor_.store(i, std::memory_order_relaxed);
+        return i;
+    }
+
+    std::vector<pose_sample>         samples_;
+    mutable std::atomic<std::size_t> cursor_{0};
+};
+
+/**
+ * @brief A quaternion that many threads read without locking while another one occasionally replaces it.
+ *
+ * A sequence lock: the writer makes the version odd while it stores the coefficients, and a reader retries if the
+ * version was odd or changed while it loaded them. Writers are serialized by a mutex, which update() also holds across
+ * its read-modify-write.
+ */
+class quaternion_snapshot {
+public:
+    explicit quaternion_snapshot(const Eigen::Quaternionf& value = Eigen::Quaternionf::Identity()) {
+        store_locked(value);
+    }
+
+    [[nodiscard]] Eigen::Quaternionf load() const {
+        for (;;) {
+            const unsigned before = version_.load(std::memory_order_acquire);
+            if (before % 2 == 0) {
+                const Eigen::Quaternionf value{coefficients_[3].load(std::memory_order_relaxed),
+                                               coefficients_[0].load(std::memory_order_relaxed),
+                                               coefficients_[1].load(std::memory_order_relaxed),
+                                               coefficients_[2].load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (version_.load(std::memory_order_relaxed) == before) {
+                    return value;
+                }
+            }
+        }
+    }
+
+    void store(const Eigen::Quaternionf& value) {
+        const std::lock_guard<std::mutex> lock{write_mutex_};
+        store_locked(value);
+    }
+
+    /// Replaces the value with @p function(value), without another write in between
+    template<typename Function>
+    void update(Function&& function) {
+        const std::lock_guard<std::mutex> lock{write_mutex_};
+        store_locked(function(load()));
+    }
+
+private:
+    void store_locked(const Eigen::Quaternionf& value) {
+        const unsigned version = version_.load(std::memory_order_relaxed);
+        version_.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        coefficients_[0].store(value.x(), std::memory_order_relaxed);
+        coefficients_[1].store(value.y(), std::memory_order_relaxed);
+        coefficients_[2].store(value.z(), std::memory_order_relaxed);
+        coefficients_[3].store(value.w(), std::memory_order_relaxed);
+        version_.store(version + 2, std::memory_order_release);
+    }
+
+    std::atomic<unsigned>             version_{0};
+    std::array<std::atomic<float>, 4> coefficients_{};
+    std::mutex                        write_mutex_;
+};
+
+} // namespace ILLIXR
@@ -4,30 +4,27 @@
 #include "utils.hpp"
 
 #include <memory>
-#include <shared_mutex>
+#include <vector>
 
 using namespace ILLIXR;
 using namespace ILLIXR::data_format;
 
-inline std::map<ullong, pose::head_pose_type> read_data(std::ifstream& gt_file, const std::string& file_name) {
+inline std::pair<ullong, pose::head_pose_type> parse_row(const data_row& row, const std::string& file_name) {
     (void) file_name;
-    std::map<ullong, pose::head_pose_type> data;
-
-    for (csv_iterator row{gt_file, 1}; row != csv_iterator{}; ++row) {
-        ullong             t = std::stoull(row[0]);
-        Eigen::Vector3f    av{std::stof(row[1]), std::stof(row[2]), std::stof(row[3])};
-        Eigen::Quaternionf la{std::stof(row[4]), std::stof(row[5]), std::stof(row[6]), std::stof(row[7])};
-        data[t] = {{}, av, la};
-    }
-    return data;
+    Eigen::Vector3f    av{std::stof(row[1]), std::stof(row[2]), std::stof(row[3])};
+    Eigen::Quaternionf la{std::stof(row[4]), std::stof(row[5]), std::stof(row[6]), std::stof(row[7])};
+    return {std::stoull(row[0]), {{}, av, la}};
 }
 
 pose_lookup_impl::pose_lookup_impl(const phonebook* const pb)
     : switchboard_{pb->lookup_impl<switchboard>()}
     , clock_{pb->lookup_impl<relative_clock>()}
-    , sensor_data_{load_data<pose::head_pose_type>("state_groundtruth_estimate0", "pose_lookup", &read_data, switchboard_)}
-    , sensor_data_it_{sensor_data_.cbegin()}
-    , dataset_first_time_{sensor_data_it_->first}
+    // Looked up at random times, so the whole dataset is kept in memory
+    , sensor_stream_{pb->lookup_impl<dataset_loader>()->open<pose::head_pose_type>(
+          "pose_lookup/state_groundtruth_estimate0",
+          csv_dataset_source<pose::head_pose_type>(dataset_path("state_groundtruth_estimate0", "pose_lookup", switchboard_), 1,
+                                                   &parse_row),
+          nullptr, true)}
     , vsync_estimate_{switchboard_->get_reader<switchboard::event_wrapper<time_point>>("vsync_estimate")}
     /// TODO: Set with #198
     , enable_alignment_{switchboard_->get_env_bool("ILLIXR_ALIGNMENT_ENABLE", "False")}
@@ -40,11 +37,32 @@ pose_lookup_impl::pose_lookup_impl(const phonebook* const pb)
         std::string path_to_alignment(switchboard_->get_env("ILLIXR_ALIGNMENT_FILE", "./metrics/alignMatrix.txt"));
         load_align_parameters(path_to_alignment, align_rot_, align_trans_, align_quat_, align_scale_);
     }
-    // Read position data of the first frame
-    init_pos_offset_ = sensor_data_.cbegin()->second.position;
+}
 
-    auto newoffset = correct_pose(sensor_data_.begin()->second).orientation;
-    set_offset(newoffset);
+void pose_lookup_impl::load() const {
+    std::call_once(loaded_, [this] {
+        const auto& rows = sensor_stream_->all();
+        if (rows.empty()) {
+            ILLIXR::abort("[pose_lookup] The ground truth dataset is empty");
+        }
+
+        // Read position data of the first frame
+        init_pos_offset_ = rows.front().second.position;
+
+        // Everything but the offset is fixed, so it is applied once here rather than on every lookup
+        std::vector<pose_sample> samples;
+        samples.reserve(rows.size());
+        for (const auto& row : rows) {
+            const pose::head_pose_type aligned = align_pose(row.second);
+            samples.push_back({row.first, aligned.position, aligned.orientation});
+        }
+        track_              = pose_track{std::move(samples)};
+        dataset_first_time_ = track_.front().time;
+        sensor_stream_.reset();
+
+        // As set_offset(correct_pose(first pose).orientation) with the identity offset
+        offset_.store(track_.front().orientation.inverse());
+    });
 }
 
 pose::fast_head_pose_type pose_lookup_impl::get_fast_pose() const {
@@ -70,10 +88,18 @@ bool pose_lookup_impl::true_pose_reliable() const {
 }
 
 Eigen::Quaternionf pose_lookup_impl::get_offset() {
-    return offset_;
+    load();
+    return offset_.load();
 }
 
 pose::head_pose_type pose_lookup_impl::correct_pose(const pose::head_pose_type& pose) const {
+    load();
+    pose::head_pose_type corrected = align_pose(pose);
+    corrected.orientation          = apply_offset(corrected.orientation);
+    return corrected;
+}
+
+pose::head_pose_type pose_lookup_impl::align_pose(const pose::head_pose_type& pose) const {
     pose::head_pose_type swapped_pose;
 
     // Step 1: Compensate starting point to (0, 0, 0), pos only
@@ -114,51 +140,46 @@ pose::head_pose_type pose_lookup_impl::correct_pose(const pose::head_pose_type&
     Eigen::Quaternionf raw_o(input_pose.orientation.w(), -input_pose.orientation.y(), input_pose.orientation.z(),
                              -input_pose.orientation.x());
 
-    swapped_pose.orientation = apply_offset(raw_o);
+    swapped_pose.orientation = raw_o;
 
     return swapped_pose;
 }
 
 void pose_lookup_impl::set_offset(const Eigen::Quaternionf& raw_o_times_offset) {
-    std::unique_lock   lock{offset_mutex_};
-    Eigen::Quaternionf raw_o = raw_o_times_offset * offset_.inverse();
-    // std::cout << "pose_prediction: set_offset" << std::endl;
-    offset_ = raw_o.inverse();
+    load();
+    offset_.update([&](const Eigen::Quaternionf& offset) {
+        Eigen::Quaternionf raw_o = raw_o_times_offset * offset.inverse();
+        // std::cout << "pose_prediction: set_offset" << std::endl;
+        return Eigen::Quaternionf{raw_o.inverse()};
+    });
 }
 
 Eigen::Quaternionf pose_lookup_impl::apply_offset(const Eigen::Quaternionf& orientation) const {
-    std::shared_lock lock{offset_mutex_};
-    return orientation * offset_;
+    return orientation * offset_.load();
 }
 
 pose::fast_head_pose_type pose_lookup_impl::get_fast_pose(time_point time) const {
+    load();
     ullong lookup_time = time.time_since_epoch().count() + dataset_first_time_;
 
-    auto nearest_row = sensor_data_.upper_bound(lookup_time);
-
-    if (nearest_row == sensor_data_.cend()) {
 #ifndef NDEBUG
+    if (lookup_time > track_.back().time) {
         spdlog::get("illixr")->debug("[pose_lookup] Time {} ({} + {}) after last datum {}", lookup_time,
                                      std::chrono::nanoseconds(time.time_since_epoch()).count(), dataset_first_time_,
-                                     sensor_data_.rbegin()->first);
-#endif
-        nearest_row--;
-    } else if (nearest_row == sensor_data_.cbegin()) {
-#ifndef NDEBUG
+                                     track_.back().time);
+    } else if (lookup_time < track_.front().time) {
         spdlog::get("illixr")->debug("[pose_lookup] Time {} ({} + {}) before first datum {}", lookup_time,
                                      std::chrono::nanoseconds(time.time_since_epoch()).count(), dataset_first_time_,
-                                     sensor_data_.cbegin()->first);
-#endif
-    } else {
-        // "std::map::upper_bound" returns an iterator to the first pair whose key is GREATER than the argument.
-        // I already know we aren't at the begin()
-        // So I will decrement nearest_row here.
-        nearest_row--;
+                                     track_.front().time);
     }
+#endif
 
-    auto looked_up_pose        = nearest_row->second;
-    looked_up_pose.sensor_time = time_point{std::chrono::nanoseconds{nearest_row->first - dataset_first_time_}};
-    return pose::fast_head_pose_type{correct_pose(looked_up_pose), clock_->now(), time};
+    // Interpolated between the ground truth poses around the lookup time
+    const pose_sample looked_up = track_.at(lookup_time);
+    return pose::fast_head_pose_type{
+        pose::head_pose_type{time_point{std::chrono::nanoseconds{looked_up.time - dataset_first_time_}}, looked_up.position,
+                             apply_offset(looked_up.orientation)},
+        clock_->now(), time};
 }
 
 class pose_lookup_plugin : public plugin {
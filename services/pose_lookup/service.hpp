@@ -2,9 +2,13 @@
 
 #include "illixr/data_format/pose_prediction.hpp"
 #include "illixr/data_loading.hpp"
+#include "illixr/dataset_loader.hpp"
 #include "illixr/global_module_defs.hpp"
 #include "illixr/phonebook.hpp"
 #include "illixr/plugin.hpp"
+#include "pose_track.hpp"
+
+#include <mutex>
 
 namespace ILLIXR {
 
@@ -24,22 +28,27 @@ public:
     data_format::pose::fast_head_pose_type get_fast_pose(time_point time) const override;
 
 private:
+    // Waits for the dataset, the first time it is needed, and builds the track and the offsets from it
+    void load() const;
+    // correct_pose() up to the offset, which is the part that does not change
+    data_format::pose::head_pose_type align_pose(const data_format::pose::head_pose_type& pose) const;
+
     const std::shared_ptr<switchboard>          switchboard_;
     const std::shared_ptr<const relative_clock> clock_;
-    mutable Eigen::Quaternionf                  offset_{Eigen::Quaternionf::Identity()};
-    mutable std::shared_mutex                   offset_mutex_;
+    mutable quaternion_snapshot                 offset_;
 
-    const std::map<ullong, sensor_types>                        sensor_data_;
-    std::map<ullong, sensor_types>::const_iterator              sensor_data_it_;
-    ullong                                                      dataset_first_time_;
+    mutable std::shared_ptr<dataset_stream<sensor_types>>       sensor_stream_;
+    mutable std::once_flag                                      loaded_;
+    mutable pose_track                                          track_; ///< Aligned poses, by dataset time
+    mutable ullong                                              dataset_first_time_{0};
     switchboard::reader<switchboard::event_wrapper<time_point>> vsync_estimate_;
 
-    bool            enable_alignment_;
-    Eigen::Vector3f init_pos_offset_;
-    Eigen::Matrix3f align_rot_;
-    Eigen::Vector3f align_trans_;
-    Eigen::Vector4f align_quat_;
-    double          align_scale_;
+    bool                    enable_alignment_;
+    mutable Eigen::Vector3f init_pos_offset_;
+    Eigen::Matrix3f         align_rot_;
+    Eigen::Vector3f         align_trans_;
+    Eigen::Vector4f         align_quat_;
+    double                  align_scale_;
 };
 
 } // namespace ILLIXR
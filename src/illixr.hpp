@@ -60,6 +60,17 @@ public:
         return terminate_.load();
     }
 
+    /**
+     * Sleeps until @p done returns true, checking it every 100 ms.
+     */
+    template<typename Predicate>
+    bool sleep_until(Predicate done) {
+        while (!terminate_.load() && !done()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        }
+        return terminate_.load();
+    }
+
     void cancel() {
         terminate_.store(true);
     }
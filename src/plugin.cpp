@@ -156,6 +156,35 @@ void check_plugins(std::vector<std::string>& plugins, const std::vector<ILLIXR::
         plugins = ordered_plugins;
 }
 
+/**
+ * Flattens the profile's `scheduling` section into the ILLIXR_SCHEDULING format (see thread_scheduler). Each entry may
+ * be a map of settings or the settings string itself:
+ *
+ *     scheduling:
+ *       timewarp_gl: {cpus: 2-3, policy: fifo, priority: 80, isolate: true}
+ *       openvins: cpus=4-7 nice=5
+ */
+std::string scheduling_spec(const YAML::Node& scheduling) {
+    std::string spec;
+    for (const auto& entry : scheduling) {
+        std::string settings;
+        if (entry.second.IsMap()) {
+            for (const auto& setting : entry.second) {
+                const auto key = setting.first.as<std::string>();
+                if (key == "isolate") {
+                    settings += setting.second.as<bool>() ? " isolate" : "";
+                } else {
+                    settings += " " + key + "=" + setting.second.as<std::string>();
+                }
+            }
+        } else {
+            settings = " " + entry.second.as<std::string>();
+        }
+        spec += entry.first.as<std::string>() + ":" + settings + "; ";
+    }
+    return spec;
+}
+
 int ILLIXR::run(const cxxopts::ParseResult& options) {
     std::chrono::seconds     run_duration;
     std::vector<std::string> plugins;
@@ -257,6 +286,9 @@ int ILLIXR::run(const cxxopts::ParseResult& options) {
         GET_BOOL(enable_pre_sleep, ILLIXR_ENABLE_PRE_SLEEP)
         GET_BOOL(openxr, ILLIXR_OPENXR)
         GET_STRING(realsense_cam, REALSENSE_CAM)
+        if (config["scheduling"]) {
+            switchboard_->set_env("ILLIXR_SCHEDULING", scheduling_spec(config["scheduling"]));
+        }
 
         if (switchboard_->get_env_char("ILLIXR_DISPLAY_MODE") == nullptr) {
             spdlog::get("illixr")->info("[main] Display mode not selected, defaulting to GLFW.");
@@ -339,7 +371,15 @@ int ILLIXR::run(const cxxopts::ParseResult& options) {
 
         cancellable_sleep cs;
         std::thread       th{[&] {
-            cs.sleep(run_duration);
+            const std::shared_ptr<relative_clock> clock = runtime_->get_clock();
+            if (clock->is_virtual_time()) {
+                // The duration is in dataset time, and the run ends early once every dataset has been replayed
+                cs.sleep_until([&] {
+                    return clock->now() >= time_point{run_duration} || clock->time_sources_finished();
+                });
+            } else {
+                cs.sleep(run_duration);
+            }
             runtime_->stop();
         }};
 
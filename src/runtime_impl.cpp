@@ -1,5 +1,6 @@
 #include "illixr/runtime.hpp"
 
+#include "illixr/dataset_loader.hpp"
 #include "illixr/dynamic_lib.hpp"
 #include "illixr/error_util.hpp"
 // #include "illixr/extended_window.hpp"
@@ -9,6 +10,7 @@
 #include "illixr/record_logger.hpp"
 #include "illixr/stoplight.hpp"
 #include "illixr/switchboard.hpp"
+#include "illixr/thread_scheduler.hpp"
 #include "illixr/vk/vk_extension_request.hpp"
 // #include "sqlite_record_logger.hpp"
 // #include "stdout_record_logger.hpp"
@@ -16,11 +18,13 @@
 #include "vulkan_display.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -51,9 +55,12 @@ class MY_EXPORT_API runtime_impl : public runtime {
 public:
     explicit runtime_impl() {
         spdlogger("illixr", std::getenv("ILLIXR_LOG_LEVEL")); // can't use switchboard interface here
-        phonebook_.register_impl<relative_clock>(std::make_shared<relative_clock>());
+        clock_ = std::make_shared<relative_clock>();
+        phonebook_.register_impl<relative_clock>(clock_);
         phonebook_.register_impl<record_logger>(std::make_shared<no_op_record_logger>());
         phonebook_.register_impl<gen_guid>(std::make_shared<gen_guid>());
+        phonebook_.register_impl<thread_scheduler>(std::make_shared<thread_scheduler>());
+        phonebook_.register_impl<dataset_loader>(std::make_shared<dataset_loader>());
         phonebook_.register_impl<switchboard>(std::make_shared<switchboard>(&phonebook_));
         switchboard_ = phonebook_.lookup_impl<switchboard>();
         // phonebook_.register_impl<xlib_gl_extended_window>(
@@ -89,13 +96,54 @@ public:
 
         RAC_ERRNO_MSG("runtime_impl after generating plugin factories");
 
+        // Plugins pick the clock's mode up in their constructors
+        if (switchboard_->get_env_bool("ILLIXR_VIRTUAL_TIME")) {
+            spdlog::get("illixr")->info("[runtime] Virtual time: the clock advances whenever the pipeline is idle");
+            clock_->set_virtual_time(true);
+        }
+        // Threads apply this as they start, and the plugins start threads in their constructors
+        auto scheduler = phonebook_.lookup_impl<thread_scheduler>();
+        try {
+            scheduler->configure(switchboard_->get_env("ILLIXR_SCHEDULING"));
+        } catch (const std::invalid_argument& error) {
+            ILLIXR::abort(std::string{"ILLIXR_SCHEDULING: "} + error.what());
+        }
+        // Offline plugins open their datasets in their constructors, and they load in the background
+        auto datasets = phonebook_.lookup_impl<dataset_loader>();
+        unsigned long memory_budget_mib = 0;
+        try {
+            memory_budget_mib = switchboard_->get_env_ulong("ILLIXR_DATASET_MEMORY_BUDGET", 0);
+        } catch (const std::logic_error&) {
+            ILLIXR::abort("ILLIXR_DATASET_MEMORY_BUDGET: expected a size in MiB, got \"" +
+                          switchboard_->get_env("ILLIXR_DATASET_MEMORY_BUDGET") + "\"");
+        }
+        if (memory_budget_mib > (SIZE_MAX >> 20)) {
+            ILLIXR::abort("ILLIXR_DATASET_MEMORY_BUDGET: " + std::to_string(memory_budget_mib) +
+                          " MiB does not fit in a size_t");
+        }
+        datasets->set_memory_budget(static_cast<std::size_t>(memory_budget_mib) << 20);
+
         std::transform(plugin_factories.cbegin(), plugin_factories.cend(), std::back_inserter(plugins_),
                        [this](const auto& plugin_factory) {
                            RAC_ERRNO_MSG("runtime_impl before building the plugin");
                            return std::unique_ptr<plugin>{plugin_factory(&this->phonebook_)};
                        });
 
-        phonebook_.lookup_impl<relative_clock>()->start();
+        // Time sources register in their constructors; without one, virtual time would never move and every sleep hang
+        if (clock_->is_virtual_time() && !clock_->has_time_sources()) {
+            ILLIXR::abort("[runtime] ILLIXR_VIRTUAL_TIME is set, but no plugin drives the clock (e.g. offline_imu, "
+                          "offline_cam, or synthetic_sensors)");
+        }
+
+        // Dataset time starts with the clock, so every dataset has to be ready (if not complete) by then
+        datasets->wait_ready();
+        clock_->start();
+
+        std::vector<std::string> plugin_names;
+        std::transform(plugins_.cbegin(), plugins_.cend(), std::back_inserter(plugin_names), [](const auto& plugin) {
+            return plugin->get_name();
+        });
+        scheduler->report(plugin_names);
 
         if (!enable_monado_) {
             const std::string display_mode =
@@ -153,6 +201,9 @@ public:
         // After this point, threads may exit their main loops
         // They still have destructors and still have to be joined.
 
+        clock_->cancel_sleeps();
+        // After this point, no thread waits on virtual time.
+
         phonebook_.lookup_impl<switchboard>()->stop();
         // After this point, Switchboard's internal thread-workers which power synchronous callbacks are stopped and joined.
 
@@ -13,22 +13,19 @@ tcp_device_rx::tcp_device_rx(const std::string& name_, phonebook* pb_)
 }
 
 threadloop::skip_option tcp_device_rx::_p_should_skip() {
-    return skip_option::run;
+    return wait_for_data(msg_reader_);
 }
 
 void tcp_device_rx::_p_one_iteration() {
-    if (msg_reader_.size() > 0) {
-        auto                   buffer_ptr   = msg_reader_.dequeue();
-        std::string            buffer_str   = **buffer_ptr;
-        std::string::size_type end_position = buffer_str.find(delimiter_);
-
-        output_proto::Movement mvmt;
-        bool                   success = mvmt.ParseFromString(buffer_str.substr(0, end_position));
-        if (success) {
-            receive_message(mvmt);
-        } else {
-            spdlog::get("illixr")->error("Cound not parse string");
-        }
+    auto               buffer_ptr = msg_reader_.dequeue();
+    const std::string& buffer     = **buffer_ptr;
+
+    output_proto::Movement mvmt;
+    bool                   success = mvmt.ParseFromArray(buffer.data(), static_cast<int>(buffer.size()));
+    if (success) {
+        receive_message(mvmt);
+    } else {
+        spdlog::get("illixr")->error("Cound not parse string");
     }
 }
 
@@ -24,8 +24,6 @@ private:
     const std::shared_ptr<relative_clock>                                 clock_;
     switchboard::buffered_reader<switchboard::event_wrapper<std::string>> msg_reader_;
 
-    unsigned int      current_frame_ = 0;
-    std::string       buffer_;
-    const std::string delimiter_ = "EEND!";
+    unsigned int current_frame_ = 0;
 };
 } // namespace ILLIXR
\ No newline at end of file
@@ -44,9 +44,8 @@ void tcp_device_tx::send_data() {
     vec->set_z(distribution(generator_));
 
     message = vec->SerializeAsString();
-    message += delimiter_;
     spdlog::get("illixr")->info("Device Sending Message {} {} {} {}", frame_id_, vec->x(), vec->y(), vec->z());
-    writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(message));
+    writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(message)));
     delete vec;
     frame_id_++;
 }
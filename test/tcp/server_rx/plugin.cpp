@@ -13,22 +13,19 @@ using namespace ILLIXR;
 }
 
 threadloop::skip_option tcp_server_rx::_p_should_skip() {
-    return skip_option::run;
+    return wait_for_data(reader_);
 }
 
 void tcp_server_rx::_p_one_iteration() {
-    if (reader_.size() > 0) {
-        auto                   buffer_ptr   = reader_.dequeue();
-        std::string            buffer_str   = **buffer_ptr;
-        std::string::size_type end_position = buffer_str.find(delimiter_);
-
-        input_proto::Vec3 vec;
-        bool              success = vec.ParseFromString(buffer_str.substr(0, end_position));
-        if (success) {
-            receive_message(vec);
-        } else {
-            spdlog::get("illixr")->error("Cound not parse string");
-        }
+    auto               buffer_ptr = reader_.dequeue();
+    const std::string& buffer     = **buffer_ptr;
+
+    input_proto::Vec3 vec;
+    bool              success = vec.ParseFromArray(buffer.data(), static_cast<int>(buffer.size()));
+    if (success) {
+        receive_message(vec);
+    } else {
+        spdlog::get("illixr")->error("Cound not parse string");
     }
 }
 
@@ -55,10 +55,9 @@ void tcp_server_tx::send_message() {
     mvmt->set_allocated_quat(quat);
 
     message = mvmt->SerializeAsString();
-    message += delimiter_;
     spdlog::get("illixr")->info("Server Sending Message {} {} {} {} {} {} {}", frame_id_, mvmt->rotation().theta(),
                                 mvmt->rotation().rho(), mvmt->quat().w(), mvmt->quat().x(), mvmt->quat().y(), mvmt->quat().z());
-    writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(message));
+    writer_.put(std::make_shared<switchboard::event_wrapper<std::string>>(std::move(message)));
     delete mvmt;
     frame_id_++;
 }
@@ -29,6 +29,5 @@ private:
     switchboard::network_writer<switchboard::event_wrapper<std::string>> writer_;
     std::random_device                                                   rd_;
     std::mt19937                                                         generator_;
-    const std::string                                                    delimiter_ = "EEND!";
 };
 } // namespace ILLIXR
\ No newline at end of file
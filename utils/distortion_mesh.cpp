@@ -0,0 +1,410 @@
+#include "illixr/distortion_mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+using namespace ILLIXR;
+
+namespace {
+
+// Bump whenever the layout of the cache file or the math in build() changes
+constexpr std::uint32_t cache_version = 1;
+constexpr char          cache_magic[] = "ILXDMESH";
+
+// Meshes with fewer vertices than this are built on the calling thread; spawning workers costs more than it saves
+constexpr std::size_t parallel_threshold = 1 << 16;
+
+static_assert(sizeof(HMD::mesh_coord3d_t) == 3 * sizeof(float) && sizeof(HMD::uv_coord_t) == 2 * sizeof(float),
+              "the cache stores the vertex structs as raw floats");
+
+std::uint32_t bits(float value) {
+    std::uint32_t out;
+    std::memcpy(&out, &value, sizeof(out));
+    return out;
+}
+
+/**
+ * Every input that changes the mesh, as 32-bit words. The cache file name is a hash of it, and the file stores it in
+ * full so that a hash collision can never return the wrong mesh.
+ */
+std::vector<std::uint32_t> signature(const HMD::hmd_info_t& hmd_info, bool compare_images) {
+    std::vector<std::uint32_t> sig{cache_version,
+                                   compare_images ? 1u : 0u,
+                                   static_cast<std::uint32_t>(hmd_info.display_pixels_high),
+                                   static_cast<std::uint32_t>(hmd_info.tile_pixels_high),
+                                   static_cast<std::uint32_t>(hmd_info.eye_tiles_wide),
+                                   static_cast<std::uint32_t>(hmd_info.eye_tiles_high),
+                                   static_cast<std::uint32_t>(hmd_info.visible_pixels_wide),
+                                   static_cast<std::uint32_t>(hmd_info.visible_pixels_high),
+                                   bits(hmd_info.visible_meters_wide),
+                                   bits(hmd_info.visible_meters_high),
+                                   bits(hmd_info.lens_separation_in_meters),
+                                   bits(hmd_info.meters_per_tan_angle_at_center),
+                                   static_cast<std::uint32_t>(hmd_info.num_knots)};
+    for (int k = 0; k < std::clamp(hmd_info.num_knots, 0, 11); ++k) {
+        sig.push_back(bits(hmd_info.K[k]));
+    }
+    for (float aberration : hmd_info.chromatic_aberration) {
+        sig.push_back(bits(aberration));
+    }
+    return sig;
+}
+
+std::uint64_t fnv1a(const std::vector<std::uint32_t>& words) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::uint32_t word : words) {
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (word >> (8 * byte)) & 0xFF;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
+/**
+ * The Hermite form of HMD::evaluate_catmull_rom_spline for the segment starting at each knot, so that evaluating the
+ * spline is a table lookup rather than a chain of branches. The values are computed exactly as the scalar version
+ * computes them, so the results match it bit for bit.
+ */
+struct spline_table {
+    std::vector<float> p0, m0, p1, m1;
+
+    spline_table(const float* K, int num_knots)
+        : p0(num_knots)
+        , m0(num_knots)
+        , p1(num_knots)
+        , m1(num_knots) {
+        for (int k = 0; k < num_knots; ++k) {
+            if (k == 0) {
+                p0[k] = K[0];
+                m0[k] = K[1] - K[0];
+                p1[k] = K[1];
+                m1[k] = 0.5f * (K[2] - K[0]);
+            } else if (k < num_knots - 2) {
+                p0[k] = K[k];
+                m0[k] = 0.5f * (K[k + 1] - K[k - 1]);
+                p1[k] = K[k + 1];
+                m1[k] = 0.5f * (K[k + 2] - K[k]);
+            } else if (k == num_knots - 2) {
+                p0[k] = K[k];
+                m0[k] = 0.5f * (K[k + 1] - K[k - 1]);
+                p1[k] = K[k + 1];
+                m1[k] = K[k + 1] - K[k];
+            } else {
+                p0[k] = K[k];
+                m0[k] = K[k] - K[k - 1];
+                p1[k] = p0[k] + m0[k];
+                m1[k] = m0[k];
+            }
+        }
+    }
+};
+
+/**
+ * Fills one row of one eye. The tangent angle along y is constant over a row, so only the x angle, the radius, and the
+ * spline vary; each of those is a straight-line loop over the row.
+ */
+class row_builder {
+public:
+    row_builder(const HMD::hmd_info_t& hmd_info, bool compare_images, distortion_mesh& mesh)
+        : hmd_info_{hmd_info}
+        , compare_images_{compare_images}
+        , mesh_{mesh}
+        , spline_{hmd_info.K, hmd_info.num_knots}
+        , width_{hmd_info.eye_tiles_wide + 1} {
+        const float horizontal_shift_meters = (hmd_info.lens_separation_in_meters / 2) - (hmd_info.visible_meters_wide / 4);
+        horizontal_shift_view_              = horizontal_shift_meters / (hmd_info.visible_meters_wide / 2);
+
+        ndc_to_pixels_[0]    = static_cast<float>(hmd_info.visible_pixels_wide) * 0.25f;
+        ndc_to_pixels_[1]    = static_cast<float>(hmd_info.visible_pixels_high) * 0.5f;
+        pixels_to_meters_[0] = hmd_info.visible_meters_wide / static_cast<float>(hmd_info.visible_pixels_wide);
+        pixels_to_meters_[1] = hmd_info.visible_meters_high / static_cast<float>(hmd_info.visible_pixels_high);
+        position_y_scale_    = static_cast<float>(hmd_info.eye_tiles_high * hmd_info.tile_pixels_high) /
+            static_cast<float>(hmd_info.display_pixels_high);
+    }
+
+    void operator()(int eye, int y, std::vector<float>& theta_x, std::vector<float>& rsq, std::vector<float>& scale) const {
+        const int   n          = width_;
+        const float shift      = eye ? -horizontal_shift_view_ : horizontal_shift_view_;
+        const float tiles_wide = static_cast<float>(hmd_info_.eye_tiles_wide);
+        const float tiles_high = static_cast<float>(hmd_info_.eye_tiles_high);
+        const float theta_y    = tan_angle(1.0f - static_cast<float>(y) / tiles_high, 1);
+        const float theta_y_sq = theta_y * theta_y;
+        const float position_y =
+            -1.0f + 2.0f * (static_cast<float>(hmd_info_.eye_tiles_high - y) / tiles_high) * position_y_scale_;
+
+        theta_x.resize(n);
+        rsq.resize(n);
+        scale.resize(n);
+
+        for (int x = 0; x < n; ++x) {
+            theta_x[x] = tan_angle(shift + static_cast<float>(x) / tiles_wide, 0);
+            rsq[x]     = theta_x[x] * theta_x[x] + theta_y_sq;
+        }
+
+        // Catmull-Rom spline, with the segment looked up instead of branched on
+        const float  max_knot = static_cast<float>(hmd_info_.num_knots - 1);
+        const float* p0       = spline_.p0.data();
+        const float* m0       = spline_.m0.data();
+        const float* p1       = spline_.p1.data();
+        const float* m1       = spline_.m1.data();
+        for (int x = 0; x < n; ++x) {
+            const float scaled_value       = max_knot * rsq[x];
+            const float scaled_value_floor = std::max(0.0f, std::min(max_knot, std::floor(scaled_value)));
+            const float t                  = scaled_value - scaled_value_floor;
+            const int   k                  = static_cast<int>(scaled_value_floor);
+            const float omt                = 1.0f - t;
+            scale[x] =
+                (p0[k] * (1.0f + 2.0f * t) + m0[k] * t) * omt * omt + (p1[k] * (1.0f + 2.0f * omt) - m1[k] * omt) * t * t;
+        }
+
+        const float*         ca   = hmd_info_.chromatic_aberration;
+        const std::size_t    base = static_cast<std::size_t>(eye) * mesh_.vertices_per_eye + static_cast<std::size_t>(y) * n;
+        HMD::mesh_coord3d_t* pos  = mesh_.positions.data() + base;
+        HMD::uv_coord_t*     uv0  = mesh_.uv[0].data() + base;
+        HMD::uv_coord_t*     uv1  = mesh_.uv[1].data() + base;
+        HMD::uv_coord_t*     uv2  = mesh_.uv[2].data() + base;
+        for (int x = 0; x < n; ++x) {
+            pos[x].x = -1.0f + 2.0f * (static_cast<float>(x) / tiles_wide);
+            pos[x].y = position_y;
+            pos[x].z = 0.0f;
+
+            const float s0 = compare_images_ ? 1.0f : scale[x] * (1.0f + ca[0] + rsq[x] * ca[1]);
+            const float s1 = compare_images_ ? 1.0f : scale[x];
+            const float s2 = compare_images_ ? 1.0f : scale[x] * (1.0f + ca[2] + rsq[x] * ca[3]);
+            uv0[x].u       = s0 * theta_x[x];
+            uv0[x].v       = s0 * theta_y;
+            uv1[x].u       = s1 * theta_x[x];
+            uv1[x].v       = s1 * theta_y;
+            uv2[x].u       = s2 * theta_x[x];
+            uv2[x].v       = s2 * theta_y;
+        }
+    }
+
+private:
+    // Same sequence of operations as HMD::build_distortion_meshes, so the results are identical
+    [[nodiscard]] float tan_angle(float unit, int axis) const {
+        const float ndc    = 2.0f * unit - 1.0f;
+        const float pixels = ndc * ndc_to_pixels_[axis];
+        const float meters = pixels * pixels_to_meters_[axis];
+        return meters / hmd_info_.meters_per_tan_angle_at_center;
+    }
+
+    const HMD::hmd_info_t& hmd_info_;
+    const bool             compare_images_;
+    distortion_mesh&       mesh_;
+    const spline_table     spline_;
+    const int              width_;
+
+    float horizontal_shift_view_;
+    float ndc_to_pixels_[2];
+    float pixels_to_meters_[2];
+    float position_y_scale_;
+};
+
+template<typename T>
+void write_array(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+bool read_array(std::ifstream& in, std::vector<T>& values, std::size_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+} // namespace
+
+distortion_mesh distortion_mesh::build(const HMD::hmd_info_t& hmd_info, bool compare_images, unsigned thread_count) {
+    const int width  = hmd_info.eye_tiles_wide + 1;
+    const int height = hmd_info.eye_tiles_high + 1;
+
+    distortion_mesh mesh;
+    mesh.vertices_per_eye = width * height;
+    mesh.positions.resize(static_cast<std::size_t>(HMD::NUM_EYES) * mesh.vertices_per_eye);
+    for (auto& channel : mesh.uv) {
+        channel.resize(mesh.positions.size());
+    }
+
+    // This is just a simple grid/plane index array, nothing fancy. Same for both eyes, too!
+    mesh.indices.resize(static_cast<std::size_t>(hmd_info.eye_tiles_high) * hmd_info.eye_tiles_wide * 6);
+    for (int y = 0; y < hmd_info.eye_tiles_high; y++) {
+        for (int x = 0; x < hmd_info.eye_tiles_wide; x++) {
+            const std::size_t offset = (static_cast<std::size_t>(y) * hmd_info.eye_tiles_wide + x) * 6;
+
+            mesh.indices[offset + 0] = static_cast<std::uint32_t>((y + 0) * width + (x + 0));
+            mesh.indices[offset + 1] = static_cast<std::uint32_t>((y + 1) * width + (x + 0));
+            mesh.indices[offset + 2] = static_cast<std::uint32_t>((y + 0) * width + (x + 1));
+
+            mesh.indices[offset + 3] = static_cast<std::uint32_t>((y + 0) * width + (x + 1));
+            mesh.indices[offset + 4] = static_cast<std::uint32_t>((y + 1) * width + (x + 0));
+            mesh.indices[offset + 5] = static_cast<std::uint32_t>((y + 1) * width + (x + 1));
+        }
+    }
+
+    const int total_rows = HMD::NUM_EYES * height;
+    if (thread_count == 0) {
+        thread_count = mesh.positions.size() < parallel_threshold ? 1 : std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    thread_count = std::min<unsigned>(thread_count, static_cast<unsigned>(total_rows));
+
+    const row_builder build_row{hmd_info, compare_images, mesh};
+    auto              build_rows = [&](int first, int last) {
+        std::vector<float> theta_x, rsq, scale;
+        for (int row = first; row < last; ++row) {
+            build_row(row / height, row % height, theta_x, rsq, scale);
+        }
+    };
+
+    if (thread_count <= 1) {
+        build_rows(0, total_rows);
+        return mesh;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; ++i) {
+        const int first = static_cast<int>(static_cast<long>(total_rows) * i / thread_count);
+        const int last  = static_cast<int>(static_cast<long>(total_rows) * (i + 1) / thread_count);
+        workers.emplace_back(build_rows, first, last);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return mesh;
+}
+
+distortion_mesh distortion_mesh::load(const HMD::hmd_info_t& hmd_info, const std::string& cache_dir) {
+    const bool compare_images = getenv("ILLIXR_COMPARE_IMAGES") != nullptr && std::stoi(getenv("ILLIXR_COMPARE_IMAGES"));
+    if (cache_dir.empty()) {
+        return build(hmd_info, compare_images);
+    }
+
+    const std::string path = (std::filesystem::path{cache_dir} / cache_file_name(hmd_info, compare_images)).string();
+    distortion_mesh   mesh;
+    if (mesh.read(path, hmd_info, compare_images)) {
+        if (auto logger = spdlog::get("illixr")) {
+            logger->debug("[distortion_mesh] Loaded {}", path);
+        }
+        return mesh;
+    }
+
+    mesh = build(hmd_info, compare_images);
+    std::error_code error;
+    std::filesystem::create_directories(cache_dir, error);
+    const bool saved  = !error && mesh.save(path, hmd_info, compare_images);
+    auto       logger = spdlog::get("illixr");
+    if (!saved && logger) {
+        logger->warn("[distortion_mesh] Could not write {}; the mesh will be rebuilt on the next start", path);
+    }
+    return mesh;
+}
+
+std::string distortion_mesh::default_cache_dir() {
+    if (const char* xdg = getenv("XDG_CACHE_HOME"); xdg != nullptr && xdg[0] != '\0') {
+        return (std::filesystem::path{xdg} / "illixr").string();
+    }
+#if defined(_WIN32) || defined(_WIN64)
+    const char* home = getenv("LOCALAPPDATA");
+    if (home != nullptr && home[0] != '\0') {
+        return (std::filesystem::path{home} / "illixr" / "cache").string();
+    }
+#else
+    const char* home = getenv("HOME");
+    if (home != nullptr && home[0] != '\0') {
+        return (std::filesystem::path{home} / ".cache" / "illixr").string();
+    }
+#endif
+    return "";
+}
+
+std::string distortion_mesh::cache_file_name(const HMD::hmd_info_t& hmd_info, bool compare_images) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "distortion_mesh_%016llx.bin",
+                  static_cast<unsigned long long>(fnv1a(signature(hmd_info, compare_images))));
+    return name;
+}
+
+bool distortion_mesh::save(const std::string& path, const HMD::hmd_info_t& hmd_info, bool compare_images) const {
+    const std::vector<std::uint32_t> sig      = signature(hmd_info, compare_images);
+    const std::uint32_t              header[] = {static_cast<std::uint32_t>(sig.size()),
+                                                 static_cast<std::uint32_t>(vertices_per_eye),
+                                                 static_cast<std::uint32_t>(indices.size())};
+
+    // Another process may be reading the same file: write a private copy, then rename it into place
+    const std::string temp_path = path + ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream out{temp_path, std::ios::binary | std::ios::trunc};
+        out.write(cache_magic, sizeof(cache_magic));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        write_array(out, sig);
+        write_array(out, indices);
+        write_array(out, positions);
+        for (const auto& channel : uv) {
+            write_array(out, channel);
+        }
+        if (!out) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool distortion_mesh::read(const std::string& path, const HMD::hmd_info_t& hmd_info, bool compare_images) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        return false;
+    }
+
+    char          magic[sizeof(cache_magic)];
+    std::uint32_t header[3];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || std::memcmp(magic, cache_magic, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    const std::vector<std::uint32_t> expected = signature(hmd_info, compare_images);
+    std::vector<std::uint32_t>       sig;
+    const std::size_t                expected_vertices = static_cast<std::size_t>(hmd_info.eye_tiles_wide + 1) *
+        static_cast<std::size_t>(hmd_info.eye_tiles_high + 1);
+    // Two triangles per tile
+    const std::size_t expected_indices =
+        static_cast<std::size_t>(hmd_info.eye_tiles_wide) * static_cast<std::size_t>(hmd_info.eye_tiles_high) * 6;
+    if (header[0] != expected.size() || !read_array(in, sig, header[0]) || sig != expected ||
+        header[1] != expected_vertices || header[2] != expected_indices) {
+        return false;
+    }
+
+    distortion_mesh mesh;
+    mesh.vertices_per_eye        = static_cast<int>(header[1]);
+    const std::size_t num_values = static_cast<std::size_t>(HMD::NUM_EYES) * mesh.vertices_per_eye;
+    bool              ok         = read_array(in, mesh.indices, header[2]) && read_array(in, mesh.positions, num_values);
+    for (auto& channel : mesh.uv) {
+        ok = ok && read_array(in, channel, num_values);
+    }
+    // A longer file was not written by write() for these parameters
+    if (!ok || in.peek() != std::ifstream::traits_type::eof()) {
+        return false;
+    }
+
+    *this = std::move(mesh);
+    return true;
+}